@@ -0,0 +1,41 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+/**
+ * @file Bench.h
+ * @brief Minimal timing helper shared by the microbenchmarks.
+ *
+ * Each benchmark is a plain program: it prepares its inputs, then calls
+ * measure() once per variant. Results are printed as nanoseconds per call.
+ * Build with optimizations (see the Makefile); numbers from a debug build
+ * say nothing.
+ */
+
+namespace bench {
+
+    /// Written by every benchmark body so the optimizer cannot drop the work.
+    inline volatile std::size_t sink = 0;
+
+    /**
+     * @brief Run a body for every index in [0, iterations) and print the time per call.
+     * @param name Label printed in front of the result.
+     * @param iterations Number of calls.
+     * @param body Callable taking the index and returning a value folded into sink.
+     * @return double Nanoseconds per call.
+     */
+    template <typename Body>
+    double measure(const char* name, std::size_t iterations, Body&& body) {
+        std::size_t folded = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            folded += static_cast<std::size_t>(body(i));
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        sink = sink + folded;
+        double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / static_cast<double>(iterations);
+        std::printf("%-44s %10.1f ns/call\n", name, ns);
+        return ns;
+    }
+}
@@ -0,0 +1,92 @@
+#include "Bench.h"
+#include "DateTime.h"
+#include "DateTimeCodec.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Compares DateTime's codec-based parsing and formatting with the stream-based
+// code it replaced (std::get_time / std::put_time plus the localtime round trip).
+
+namespace {
+    constexpr std::size_t VALUES = 200000;
+
+    /// Parse as DateTime(const std::string&) did before DateTimeCodec.
+    std::chrono::system_clock::time_point streamParse(const std::string& text) {
+        std::istringstream iss(text);
+        std::tm fields = {};
+        iss >> std::get_time(&fields, "%Y-%m-%d %H:%M:%S");
+        if (iss.fail()) {
+            throw std::invalid_argument("Invalid date-time format. Expected: YYYY-MM-DD HH:MM:SS");
+        }
+        return std::chrono::system_clock::from_time_t(std::mktime(&fields));
+    }
+
+    /// Format as DateTime::getDateTimeString() did before DateTimeCodec.
+    std::string streamFormat(std::chrono::system_clock::time_point time) {
+        std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+        std::tm fields;
+#ifdef _WIN32
+        localtime_s(&fields, &seconds);
+#else
+        localtime_r(&seconds, &fields);
+#endif
+        std::ostringstream oss;
+        oss << std::put_time(&fields, "%Y-%m-%d %H:%M:%S");
+        return oss.str();
+    }
+}
+
+int main() {
+    std::vector<std::string> texts;
+    texts.reserve(VALUES);
+    for (std::size_t i = 0; i < VALUES; ++i) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "20%02zu-%02zu-%02zu %02zu:%02zu:%02zu",
+            20 + i % 10, 1 + i % 12, 1 + i % 28, i % 24, i % 60, (i * 7) % 60);
+        texts.emplace_back(text);
+    }
+    std::vector<DateTime> values;
+    values.reserve(VALUES);
+    for (const auto& text : texts) {
+        values.emplace_back(text);
+    }
+
+    // Computed here so the stream baseline times localtime + put_time only, not mktime.
+    std::vector<std::chrono::system_clock::time_point> time_points;
+    time_points.reserve(VALUES);
+    for (const auto& value : values) {
+        time_points.push_back(value.getTimePoint());
+    }
+
+    std::printf("%zu values, TZ=%s\n", VALUES, std::getenv("TZ") ? std::getenv("TZ") : "(unset)");
+    bench::measure("parse: get_time + mktime", VALUES, [&](std::size_t i) {
+        return streamParse(texts[i]).time_since_epoch().count();
+    });
+    bench::measure("parse: DateTime(const std::string&)", VALUES, [&](std::size_t i) {
+        DateTime value(texts[i]);
+        return static_cast<long long>(value.getEpochDay()) * 86400 + value.getSecondOfDay();
+    });
+    bench::measure("parse fields only: parseDateTimeFields", VALUES, [&](std::size_t i) {
+        std::tm fields;
+        return parseDateTimeFields(texts[i].data(), texts[i].size(), fields) ? fields.tm_mday : 0;
+    });
+
+    bench::measure("format: localtime + put_time", VALUES, [&](std::size_t i) {
+        return streamFormat(time_points[i]).size();
+    });
+    bench::measure("format: getDateTimeString()", VALUES, [&](std::size_t i) {
+        return values[i].getDateTimeString().size();
+    });
+    bench::measure("format: writeDateTimeString(char*)", VALUES, [&](std::size_t i) {
+        char buffer[DATE_TIME_BUFFER_SIZE];
+        return values[i].writeDateTimeString(buffer);
+    });
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "Bench.h"
+#include "Booking.h"
+#include "Customer.h"
+#include "DateTime.h"
+#include "TrustedRow.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Builds entities the way a large result set does, once through the validating
+// constructors and once through the TrustedRow ones the row mappings use.
+// Column values are copied out of a prepared row first, as getString() returns
+// a fresh std::string per cell.
+
+namespace {
+    constexpr std::size_t ROWS = 1000000;
+
+    struct CustomerRow {
+        std::string name;
+        std::string phone;
+        std::string email;
+    };
+}
+
+int main() {
+    std::vector<CustomerRow> customers;
+    customers.reserve(1000);
+    for (std::size_t i = 0; i < 1000; ++i) {
+        char phone[16];
+        std::snprintf(phone, sizeof(phone), "0100%07zu", i);
+        customers.push_back({ "Customer " + std::to_string(i), phone, "guest" + std::to_string(i) + "@example.com" });
+    }
+    const DateTime check_in("2027-01-02 12:00:00");
+    const DateTime check_out("2027-01-05 11:00:00");
+    const std::string status = "pending";
+
+    std::printf("%zu rows\n", ROWS);
+    bench::measure("customer: validating constructor", ROWS, [&](std::size_t i) {
+        const CustomerRow& row = customers[i % customers.size()];
+        std::string name = row.name, phone = row.phone, email = row.email;
+        return Customer(static_cast<int>(i), name, 30, phone, email).getEmail().size();
+    });
+    bench::measure("customer: TrustedRow constructor", ROWS, [&](std::size_t i) {
+        const CustomerRow& row = customers[i % customers.size()];
+        std::string name = row.name, phone = row.phone, email = row.email;
+        return Customer(TrustedRow{}, static_cast<int>(i), std::move(name), 30, std::move(phone), std::move(email)).getEmail().size();
+    });
+    bench::measure("booking: validating constructor", ROWS, [&](std::size_t i) {
+        std::string row_status = status;
+        return Booking(static_cast<int>(i), 101, 1, 300.0, check_in, check_out, row_status).getStatus().size();
+    });
+    bench::measure("booking: TrustedRow constructor", ROWS, [&](std::size_t i) {
+        std::string row_status = status;
+        return Booking(TrustedRow{}, static_cast<int>(i), 101, 1, 300.0, check_in, check_out, std::move(row_status)).getStatus().size();
+    });
+    return 0;
+}
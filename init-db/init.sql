@@ -1,4 +1,5 @@
 -- Initialize Hotel Management Database Schema
+-- Later schema changes are applied by the application at startup (see src/SchemaMigrator.cpp).
 
 USE hotelmanagement;
 
@@ -40,6 +41,9 @@ CREATE TABLE IF NOT EXISTS `bookings` (
   `cost` decimal(10,2) NOT NULL,
   `status` varchar(20) NOT NULL,
   PRIMARY KEY (`booking_id`),
+  KEY `idx_bookings_room_dates` (`room_number`,`check_in`,`check_out`),
+  KEY `idx_bookings_customer` (`customer_id`),
+  KEY `idx_bookings_dates` (`check_out`,`check_in`),
   CONSTRAINT `chk_cost` CHECK ((`cost` >= 0)),
   CONSTRAINT `chk_dates` CHECK ((`check_in` < `check_out`)),
   CONSTRAINT `chk_status` CHECK ((`status` in (_utf8mb4'pending',_utf8mb4'done',_utf8mb4'cancelled')))
@@ -16,6 +16,11 @@ Booking::Booking(int booking_id, int room_id, int customer_id, double cost_,
 	setCheckIn(check_in);
 	setCheckOut(check_out);
 }
+
+Booking::Booking(TrustedRow, int booking_id, int room_id, int customer_id, double cost_,
+	const DateTime& check_in, const DateTime& check_out, std::string status)
+	: booking_id(booking_id), status(std::move(status)), check_in(check_in), check_out(check_out),
+	cost(cost_), room_number(room_id), customer_id(customer_id) {}
 //Private Functions Definition
 
 bool Booking::isValidStatus(std::string status)const {
@@ -1,5 +1,6 @@
 #pragma once
 #include "DateTime.h"
+#include "TrustedRow.h"
 #include<string>
 
 /**
@@ -61,6 +62,13 @@ public:
 	Booking(int booking_id, int room_id, int customer_id, double room_price,
 		const DateTime& check_in, const DateTime& check_out, const std::string& status);
 
+	/**
+	 * @brief Constructor for rows loaded from the database; skips validation.
+	 * @see TrustedRow
+	 */
+	Booking(TrustedRow, int booking_id, int room_id, int customer_id, double cost,
+		const DateTime& check_in, const DateTime& check_out, std::string status);
+
 	/**
 	 * @brief Equality comparison operator.
 	 * @param rhs The other Booking to compare with.
@@ -0,0 +1,132 @@
+#include "BookingIntervalIndex.h"
+#include <algorithm>
+
+// Private Functions Definition
+void BookingIntervalIndex::RoomIntervals::updateMaxFrom(std::size_t first) {
+	max_check_out.erase(max_check_out.begin() + std::min(first, max_check_out.size()), max_check_out.end());
+	for (std::size_t i = first; i < intervals.size(); ++i) {
+		const DateTime& check_out = intervals[i].check_out;
+		max_check_out.push_back(i == 0 || check_out > max_check_out[i - 1] ? check_out : max_check_out[i - 1]);
+	}
+}
+
+std::size_t BookingIntervalIndex::RoomIntervals::firstStartingAtOrAfter(const DateTime& time) const {
+	auto it = std::lower_bound(intervals.begin(), intervals.end(), time,
+		[](const Interval& interval, const DateTime& value) { return interval.check_in < value; });
+	return static_cast<std::size_t>(it - intervals.begin());
+}
+
+void BookingIntervalIndex::refreshCalendarRow(int room_number) {
+	calendar.clearRoom(room_number);
+	auto room = rooms.find(room_number);
+	if (room == rooms.end()) {
+		return;
+	}
+	const RoomIntervals& entries = room->second;
+	// Bookings whose running maximum check-out precedes the horizon cannot reach into it.
+	for (std::size_t i = entries.intervals.size(); i > 0 && entries.max_check_out[i - 1].getEpochDay() >= calendar.getFirstNight(); --i) {
+		calendar.markStay(room_number, entries.intervals[i - 1].check_in, entries.intervals[i - 1].check_out);
+	}
+}
+
+// Public Functions Definition
+void BookingIntervalIndex::insert(int booking_id, int room_number, const DateTime& check_in, const DateTime& check_out) {
+	erase(booking_id);
+	RoomIntervals& entries = rooms[room_number];
+	std::size_t position = entries.firstStartingAtOrAfter(check_in);
+	entries.intervals.insert(entries.intervals.begin() + position, Interval{ check_in, check_out, booking_id });
+	entries.updateMaxFrom(position);
+	booking_rooms[booking_id] = room_number;
+	calendar.markStay(room_number, check_in, check_out);
+}
+
+bool BookingIntervalIndex::updateDates(int booking_id, const DateTime& check_in, const DateTime& check_out) {
+	auto booking = booking_rooms.find(booking_id);
+	if (booking == booking_rooms.end()) {
+		return false;
+	}
+	insert(booking_id, booking->second, check_in, check_out);
+	return true;
+}
+
+bool BookingIntervalIndex::erase(int booking_id) {
+	auto booking = booking_rooms.find(booking_id);
+	if (booking == booking_rooms.end()) {
+		return false;
+	}
+	int room_number = booking->second;
+	auto room = rooms.find(room_number);
+	booking_rooms.erase(booking);
+	if (room == rooms.end()) {
+		return true;
+	}
+	RoomIntervals& entries = room->second;
+	auto it = std::find_if(entries.intervals.begin(), entries.intervals.end(),
+		[booking_id](const Interval& interval) { return interval.booking_id == booking_id; });
+	if (it != entries.intervals.end()) {
+		std::size_t position = static_cast<std::size_t>(it - entries.intervals.begin());
+		entries.intervals.erase(it);
+		if (entries.intervals.empty()) {
+			rooms.erase(room);
+		}
+		else {
+			entries.updateMaxFrom(position);
+		}
+		refreshCalendarRow(room_number);
+	}
+	return true;
+}
+
+void BookingIntervalIndex::clear() {
+	rooms.clear();
+	booking_rooms.clear();
+	calendar.reset(calendar.getFirstNight());
+}
+
+void BookingIntervalIndex::setCalendarStart(int first_night) {
+	calendar.reset(first_night);
+	for (const auto& room : rooms) {
+		refreshCalendarRow(room.first);
+	}
+}
+
+bool BookingIntervalIndex::hasOverlap(int room_number, const DateTime& check_in, const DateTime& check_out, int exclude_booking_id) const {
+	bool found = false;
+	visitOverlaps(room_number, check_in, check_out, [&found, exclude_booking_id](const Interval& interval) {
+		found = interval.booking_id != exclude_booking_id;
+		return !found;
+	});
+	return found;
+}
+
+std::vector<BookingIntervalIndex::Interval> BookingIntervalIndex::findOverlaps(int room_number, const DateTime& check_in, const DateTime& check_out) const {
+	std::vector<Interval> overlaps;
+	visitOverlaps(room_number, check_in, check_out, [&overlaps](const Interval& interval) {
+		overlaps.push_back(interval);
+		return true;
+	});
+	std::reverse(overlaps.begin(), overlaps.end());
+	return overlaps;
+}
+
+std::vector<int> BookingIntervalIndex::findOccupiedRooms(const DateTime& check_in, const DateTime& check_out) const {
+	std::vector<int> occupied;
+	if (calendar.covers(check_in, check_out)) {
+		std::vector<int> undecided;
+		calendar.scan(check_in, check_out, occupied, undecided);
+		for (int room_number : undecided) {
+			if (hasOverlap(room_number, check_in, check_out)) {
+				occupied.push_back(room_number);
+			}
+		}
+	}
+	else {
+		for (const auto& room : rooms) {
+			if (hasOverlap(room.first, check_in, check_out)) {
+				occupied.push_back(room.first);
+			}
+		}
+	}
+	std::sort(occupied.begin(), occupied.end());
+	return occupied;
+}
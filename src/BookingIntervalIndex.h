@@ -0,0 +1,178 @@
+#pragma once
+#include "DateTime.h"
+#include "OccupancyCalendar.h"
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file BookingIntervalIndex.h
+ * @brief In-memory index of booked stays, grouped by room.
+ *
+ * Every room keeps its bookings as [check_in, check_out) intervals sorted by
+ * check-in, together with a running maximum of the check-out times. To find
+ * the bookings overlapping a stay [a, b), a binary search skips every booking
+ * that starts at or after b; walking back from there stops as soon as the
+ * running maximum is not after a, because no earlier booking can reach into
+ * the stay. While a room's bookings do not overlap each other, which the
+ * booking rules ensure, both questions cost a binary search plus the overlaps
+ * actually reported, however long the booking history is. The bound does not
+ * hold for arbitrary intervals: one old booking with a far-future check-out
+ * keeps the running maximum high, and the walk back visits every booking
+ * after it, O(n) for the room. Inserting or removing a booking shifts the room's
+ * entries after it, which is cheap because new bookings land near the end.
+ *
+ * The index also keeps an OccupancyCalendar of the same bookings, so a
+ * hotel-wide search ("which rooms are booked during this stay") scans packed
+ * night bitmaps instead of asking every room in turn.
+ */
+
+/**
+ * @class BookingIntervalIndex
+ * @brief Per-room sorted interval lists answering overlap queries.
+ */
+class BookingIntervalIndex {
+public:
+	/**
+	 * @struct Interval
+	 * @brief One booked stay.
+	 */
+	struct Interval {
+		DateTime check_in;  ///< Start of the stay (inclusive).
+		DateTime check_out; ///< End of the stay (exclusive).
+		int booking_id;     ///< Booking occupying the room.
+	};
+
+private:
+	/**
+	 * @struct RoomIntervals
+	 * @brief Bookings of one room sorted by check-in.
+	 */
+	struct RoomIntervals {
+		std::vector<Interval> intervals;
+		std::vector<DateTime> max_check_out; ///< max_check_out[i] is the latest check-out among intervals[0..i].
+
+		/**
+		 * @brief Recompute the running maximum from a position to the end.
+		 * @param first First position whose maximum may have changed.
+		 */
+		void updateMaxFrom(std::size_t first);
+
+		/**
+		 * @brief Position of the first interval starting at or after a time.
+		 * @param time Time to search for.
+		 * @return std::size_t Index into intervals.
+		 */
+		std::size_t firstStartingAtOrAfter(const DateTime& time) const;
+	};
+
+	std::unordered_map<int, RoomIntervals> rooms; ///< Intervals keyed by room number.
+	std::unordered_map<int, int> booking_rooms;   ///< Room number of every indexed booking.
+	OccupancyCalendar calendar;                   ///< Night bitmaps of the same bookings.
+
+	/**
+	 * @brief Rebuild a room's calendar row from its intervals.
+	 *
+	 * Only needed when a booking is removed; adding one just sets more bits.
+	 *
+	 * @param room_number Room number.
+	 */
+	void refreshCalendarRow(int room_number);
+
+	/**
+	 * @brief Visit the bookings of a room overlapping [check_in, check_out), latest check-in first.
+	 * @param room_number Room to search.
+	 * @param check_in Start of the stay (inclusive).
+	 * @param check_out End of the stay (exclusive).
+	 * @param visit Called with each overlapping interval; returning false stops the search.
+	 */
+	template <typename Visitor>
+	void visitOverlaps(int room_number, const DateTime& check_in, const DateTime& check_out, Visitor&& visit) const {
+		auto room = rooms.find(room_number);
+		if (room == rooms.end()) {
+			return;
+		}
+		const RoomIntervals& entries = room->second;
+		for (std::size_t i = entries.firstStartingAtOrAfter(check_out); i > 0 && entries.max_check_out[i - 1] > check_in; --i) {
+			const Interval& interval = entries.intervals[i - 1];
+			if (interval.check_out > check_in && !visit(interval)) {
+				return;
+			}
+		}
+	}
+
+public:
+	/**
+	 * @brief Add a booking, or move it if it is already indexed.
+	 * @param booking_id Booking id.
+	 * @param room_number Room the booking occupies.
+	 * @param check_in Start of the stay (inclusive).
+	 * @param check_out End of the stay (exclusive).
+	 */
+	void insert(int booking_id, int room_number, const DateTime& check_in, const DateTime& check_out);
+
+	/**
+	 * @brief Change the dates of an indexed booking, keeping its room.
+	 * @param booking_id Booking id.
+	 * @param check_in New start of the stay (inclusive).
+	 * @param check_out New end of the stay (exclusive).
+	 * @return true if the booking was indexed.
+	 */
+	bool updateDates(int booking_id, const DateTime& check_in, const DateTime& check_out);
+
+	/**
+	 * @brief Remove a booking.
+	 * @param booking_id Booking id.
+	 * @return true if the booking was indexed.
+	 */
+	bool erase(int booking_id);
+
+	/**
+	 * @brief Remove every booking.
+	 */
+	void clear();
+
+	/**
+	 * @brief Move the calendar horizon and rebuild it from the indexed bookings.
+	 * @param first_night First night of the horizon (see OccupancyCalendar::nightOf()).
+	 */
+	void setCalendarStart(int first_night);
+
+	/**
+	 * @brief Number of indexed bookings.
+	 * @return std::size_t Booking count.
+	 */
+	std::size_t size() const { return booking_rooms.size(); }
+
+	/**
+	 * @brief Check whether any booking of a room overlaps a stay.
+	 * @param room_number Room to check.
+	 * @param check_in Start of the stay (inclusive).
+	 * @param check_out End of the stay (exclusive).
+	 * @param exclude_booking_id Booking to ignore (the one being moved), or -1.
+	 * @return true if another booking overlaps [check_in, check_out).
+	 */
+	bool hasOverlap(int room_number, const DateTime& check_in, const DateTime& check_out, int exclude_booking_id = -1) const;
+
+	/**
+	 * @brief List the bookings of a room overlapping a stay.
+	 * @param room_number Room to check.
+	 * @param check_in Start of the stay (inclusive).
+	 * @param check_out End of the stay (exclusive).
+	 * @return std::vector<Interval> Overlapping bookings ordered by check-in.
+	 */
+	std::vector<Interval> findOverlaps(int room_number, const DateTime& check_in, const DateTime& check_out) const;
+
+	/**
+	 * @brief List every room with a booking overlapping a stay.
+	 *
+	 * Stays inside the calendar horizon are answered by a bitmap scan, with
+	 * the interval lists settling rooms whose bookings only partly cover a
+	 * night; other stays check every room's interval list.
+	 *
+	 * @param check_in Start of the stay (inclusive).
+	 * @param check_out End of the stay (exclusive).
+	 * @return std::vector<int> Booked room numbers in ascending order.
+	 */
+	std::vector<int> findOccupiedRooms(const DateTime& check_in, const DateTime& check_out) const;
+};
@@ -1,17 +1,32 @@
 #include "BookingRepository.h"
 #include "ScopedTransaction.h"
+#include "RowMapper.h"
+
+namespace {
+    struct BookingMapping {
+        using Entity = Booking;
+        using Columns = std::tuple<int, int, int, std::string, std::string, double, std::string>;
+        static constexpr const char* table = "bookings";
+        static constexpr std::array<const char*, 7> names = {
+            "booking_id", "room_number", "customer_id", "check_in", "check_out", "cost", "status" };
+
+        static Booking create(int booking_id, int room_number, int customer_id,
+            const std::string& check_in, const std::string& check_out, double cost, std::string status) {
+            return Booking(TrustedRow(), booking_id, room_number, customer_id, cost,
+                DateTime(check_in), DateTime(check_out), std::move(status));
+        }
+        static auto insertValues(const Booking& booking) {
+            return std::make_tuple(booking.getRoomNumber(), booking.getCustomerId(),
+                booking.getCheckIn().getDateTimeString(), booking.getCheckOut().getDateTimeString(),
+                booking.getCost(), booking.getStatus());
+        }
+    };
+    using BookingRows = RowMapper<BookingMapping>;
+}
 
 // Private helper methods
 Booking BookingRepository::createBookingFromRow(const IGenericResultSet& result) const {
-    return Booking(
-        result.getInt("booking_id"),
-        result.getInt("room_number"),
-        result.getInt("customer_id"),
-        result.getDouble("cost"),
-        DateTime(result.getString("check_in")),
-        DateTime(result.getString("check_out")),
-        result.getString("status")
-    );
+    return BookingRows::read(result);
 }
 
 std::vector<Booking> BookingRepository::fetchBookings(std::unique_ptr<IGenericResultSet> result) const {
@@ -31,40 +46,121 @@ void BookingRepository::validateBookingExists(int booking_id) const {
     }
 }
 
+void BookingRepository::refreshIndex() const {
+    auto now = std::chrono::steady_clock::now();
+    if (index_loaded && now - index_loaded_at <= index_staleness) {
+        return;
+    }
+    index_loaded = false;
+    interval_index.clear();
+    DateTime today;
+    interval_index.setCalendarStart(OccupancyCalendar::nightOf(today));
+    // Stays that ended before today cannot overlap a query isIndexUsable() accepts.
+    auto stmt = database.prepareStatement("SELECT booking_id, room_number, check_in, check_out FROM bookings WHERE check_out >= ?");
+    stmt->setString(1, today.getDateString() + " 00:00:00");
+    auto result = stmt->executeQuery();
+    while (result->next()) {
+        interval_index.insert(result->getInt(1), result->getInt(2),
+            DateTime(result->getString(3)), DateTime(result->getString(4)));
+    }
+    index_loaded_at = now;
+    index_loaded = true;
+}
+
+void BookingRepository::writeThrough(std::function<bool(BookingIntervalIndex&)> change) {
+    if (index_staleness.count() <= 0) {
+        return;
+    }
+    auto apply = [this, change = std::move(change)] {
+        std::lock_guard<std::mutex> lock(index_mutex);
+        if (index_loaded && !change(interval_index)) {
+            interval_index.clear();
+            index_loaded = false;
+        }
+    };
+    if (!ScopedTransaction::afterCommit(database, apply)) {
+        invalidateIndex(); // The transaction is not ours: nothing says when it ends.
+    }
+}
+
 // Constructor
-BookingRepository::BookingRepository(IDatabase& db) : database(db) {}
+BookingRepository::BookingRepository(IDatabase& db, std::chrono::milliseconds index_staleness)
+    : database(db), index_staleness(index_staleness), index_loaded(false) {}
 
 // Public methods
+bool BookingRepository::isIndexUsable(const DateTime& check_in) const {
+    return index_staleness.count() > 0 && !database.isTransactionActive()
+        && check_in.getEpochDay() >= DateTime().getEpochDay();
+}
+
+std::chrono::milliseconds BookingRepository::getIndexStaleness() const {
+    return index_staleness;
+}
+
+void BookingRepository::invalidateIndex() {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    interval_index.clear();
+    index_loaded = false;
+}
 
 
 // CREATE
-int BookingRepository::addBookingAndGetId(const Booking& booking) {
+Booking BookingRepository::addBooking(const Booking& booking) {
+    auto stmt = database.prepareStatement(BookingRows::insert());
+    BookingRows::bindInsert(*stmt, booking);
+    auto stored = BookingRows::hydrate(stmt->executeInsert(), booking);
+    writeThrough([stored](BookingIntervalIndex& index) {
+        index.insert(stored.getId(), stored.getRoomNumber(), stored.getCheckIn(), stored.getCheckOut());
+        return true;
+    });
+    return stored;
+}
+
+std::vector<int> BookingRepository::addBookingsAndGetIds(const std::vector<Booking>& bookings) {
+    if (bookings.empty()) {
+        return {};
+    }
     ScopedTransaction transaction(database);
 
-    auto stmt = database.prepareStatement(
-        "INSERT INTO bookings(room_number, customer_id, check_in, check_out, cost, status) VALUES (?,?,?,?,?,?)"
-    );
-    stmt->setInt(1, booking.getRoomNumber());
-    stmt->setInt(2, booking.getCustomerId());
-    stmt->setString(3, booking.getCheckIn().getDateTimeString());
-    stmt->setString(4, booking.getCheckOut().getDateTimeString());
-    stmt->setDouble(5, booking.getCost());
-    stmt->setString(6, booking.getStatus());
-    stmt->executeUpdate();
-    int booking_id =database.getLastInsertID();
+    auto stmt = database.prepareStatement(BookingRows::insert());
+    for (const auto& booking : bookings) {
+        BookingRows::bindInsert(*stmt, booking);
+        stmt->addBatch();
+    }
+    stmt->executeBatch();
+    auto booking_ids = stmt->getGeneratedKeys();
+    if (booking_ids.size() != bookings.size()) {
+        throw std::runtime_error("Database Error: Batch insert returned " + std::to_string(booking_ids.size())
+            + " ids for " + std::to_string(bookings.size()) + " bookings");
+    }
     transaction.commit();
-    return booking_id;
+    writeThrough([bookings, booking_ids](BookingIntervalIndex& index) {
+        for (size_t i = 0; i < bookings.size(); ++i) {
+            index.insert(booking_ids[i], bookings[i].getRoomNumber(), bookings[i].getCheckIn(), bookings[i].getCheckOut());
+        }
+        return true;
+    });
+    return booking_ids;
 }
 
 // READ
-Booking BookingRepository::getBookingById(int booking_id) const {
-    auto stmt = database.prepareStatement("SELECT * FROM bookings WHERE booking_id = ?");
+std::optional<Booking> BookingRepository::findBookingById(int booking_id) const {
+    static const std::string query = BookingRows::select() + " WHERE booking_id = ?";
+    auto stmt = database.prepareStatement(query);
     stmt->setInt(1, booking_id);
     auto result = stmt->executeQuery();
     if (result->next()) {
         return createBookingFromRow(*result);
     }
-    throw std::runtime_error("Booking " + std::to_string(booking_id) + " not found!");
+    return std::nullopt;
+}
+
+Booking BookingRepository::getBookingById(int booking_id) const {
+    auto booking = findBookingById(booking_id);
+    if (!booking) {
+        throw std::runtime_error("Booking " + std::to_string(booking_id) + " not found!");
+    }
+    return std::move(*booking);
 }
 
 int BookingRepository::getNumberOfBookings() const {
@@ -74,18 +170,131 @@ int BookingRepository::getNumberOfBookings() const {
 }
 
 std::vector<Booking> BookingRepository::getAllBookings() const {
-    auto stmt = database.prepareStatement("SELECT * FROM bookings");
+    auto stmt = database.prepareStatement(BookingRows::select());
     auto result = stmt->executeQuery();
     return fetchBookings(std::move(result));
 }
 
+RowCursor<Booking> BookingRepository::streamAllBookings() const {
+    auto stmt = database.prepareStatement(BookingRows::select());
+    auto result = stmt->executeQuery();
+    return RowCursor<Booking>(std::move(stmt), std::move(result), &BookingRows::read);
+}
+
 std::vector<Booking> BookingRepository::getBookingsByRoom(int room_num) const {
-    auto stmt = database.prepareStatement("SELECT * FROM bookings WHERE room_number = ?");
+    static const std::string query = BookingRows::select() + " WHERE room_number = ?";
+    auto stmt = database.prepareStatement(query);
+    stmt->setInt(1, room_num);
+    auto result = stmt->executeQuery();
+    return fetchBookings(std::move(result));
+}
+
+std::vector<Booking> BookingRepository::getBookingsByCustomer(int customer_id) const {
+    static const std::string query = BookingRows::select() + " WHERE customer_id = ?";
+    auto stmt = database.prepareStatement(query);
+    stmt->setInt(1, customer_id);
+    auto result = stmt->executeQuery();
+    return fetchBookings(std::move(result));
+}
+
+std::vector<Booking> BookingRepository::getOverlappingBookings(int room_num, const DateTime& check_in, const DateTime& check_out) const {
+    static const std::string query = BookingRows::select()
+        + " WHERE room_number = ? AND check_in < ? AND check_out > ? ORDER BY check_in";
+    auto stmt = database.prepareStatement(query);
     stmt->setInt(1, room_num);
+    stmt->setString(2, check_out.getDateTimeString());
+    stmt->setString(3, check_in.getDateTimeString());
     auto result = stmt->executeQuery();
     return fetchBookings(std::move(result));
 }
 
+std::vector<Booking> BookingRepository::getOverlappingBookings(const std::vector<int>& room_numbers, const DateTime& check_in, const DateTime& check_out) const {
+    if (room_numbers.empty()) {
+        return {};
+    }
+    std::string placeholders = "?";
+    for (size_t i = 1; i < room_numbers.size(); ++i) {
+        placeholders += ",?";
+    }
+    auto stmt = database.prepareStatement(BookingRows::select()
+        + " WHERE room_number IN (" + placeholders + ") AND check_in < ? AND check_out > ? ORDER BY room_number, check_in"
+    );
+    int param = 1;
+    for (int room_num : room_numbers) {
+        stmt->setInt(param++, room_num);
+    }
+    stmt->setString(param++, check_out.getDateTimeString());
+    stmt->setString(param, check_in.getDateTimeString());
+    auto result = stmt->executeQuery();
+    return fetchBookings(std::move(result));
+}
+
+std::vector<Booking> BookingRepository::getOverlappingBookings(const DateTime& check_in, const DateTime& check_out) const {
+    static const std::string query = BookingRows::select()
+        + " WHERE check_out > ? AND check_in < ? ORDER BY room_number, check_in";
+    auto stmt = database.prepareStatement(query);
+    stmt->setString(1, check_in.getDateTimeString());
+    stmt->setString(2, check_out.getDateTimeString());
+    auto result = stmt->executeQuery();
+    return fetchBookings(std::move(result));
+}
+
+bool BookingRepository::hasOverlappingBooking(int room_num, const DateTime& check_in, const DateTime& check_out, int exclude_booking_id) const {
+    if (isIndexUsable(check_in)) {
+        std::lock_guard<std::mutex> lock(index_mutex);
+        refreshIndex();
+        return interval_index.hasOverlap(room_num, check_in, check_out, exclude_booking_id);
+    }
+    auto stmt = database.prepareStatement(
+        "SELECT 1 FROM bookings WHERE room_number = ? AND check_in < ? AND check_out > ? AND booking_id <> ? LIMIT 1");
+    stmt->setInt(1, room_num);
+    stmt->setString(2, check_out.getDateTimeString());
+    stmt->setString(3, check_in.getDateTimeString());
+    stmt->setInt(4, exclude_booking_id);
+    auto result = stmt->executeQuery();
+    return result->next();
+}
+
+std::vector<int> BookingRepository::getOverlappingBookingIds(int room_num, const DateTime& check_in, const DateTime& check_out) const {
+    std::vector<int> booking_ids;
+    if (isIndexUsable(check_in)) {
+        std::lock_guard<std::mutex> lock(index_mutex);
+        refreshIndex();
+        for (const auto& interval : interval_index.findOverlaps(room_num, check_in, check_out)) {
+            booking_ids.push_back(interval.booking_id);
+        }
+        return booking_ids;
+    }
+    auto stmt = database.prepareStatement(
+        "SELECT booking_id FROM bookings WHERE room_number = ? AND check_in < ? AND check_out > ? ORDER BY check_in");
+    stmt->setInt(1, room_num);
+    stmt->setString(2, check_out.getDateTimeString());
+    stmt->setString(3, check_in.getDateTimeString());
+    auto result = stmt->executeQuery();
+    while (result->next()) {
+        booking_ids.push_back(result->getInt(1));
+    }
+    return booking_ids;
+}
+
+std::vector<int> BookingRepository::getOccupiedRoomNumbers(const DateTime& check_in, const DateTime& check_out) const {
+    if (isIndexUsable(check_in)) {
+        std::lock_guard<std::mutex> lock(index_mutex);
+        refreshIndex();
+        return interval_index.findOccupiedRooms(check_in, check_out);
+    }
+    auto stmt = database.prepareStatement(
+        "SELECT DISTINCT room_number FROM bookings WHERE check_in < ? AND check_out > ? ORDER BY room_number");
+    stmt->setString(1, check_out.getDateTimeString());
+    stmt->setString(2, check_in.getDateTimeString());
+    auto result = stmt->executeQuery();
+    std::vector<int> room_numbers;
+    while (result->next()) {
+        room_numbers.push_back(result->getInt(1));
+    }
+    return room_numbers;
+}
+
 // UPDATE
 void BookingRepository::updateBookingStatus(int booking_id, const std::string& status) {
     ScopedTransaction transaction(database);
@@ -110,6 +319,10 @@ void BookingRepository::updateBookingDates(int booking_id, const DateTime& check
     stmt->executeUpdate();
 
     transaction.commit();
+    // A booking missing from the index ended before it was loaded; its room is unknown here.
+    writeThrough([booking_id, check_in, check_out](BookingIntervalIndex& index) {
+        return index.updateDates(booking_id, check_in, check_out);
+    });
 }
 
 // DELETE
@@ -122,4 +335,8 @@ void BookingRepository::deleteBooking(int booking_id) {
     stmt->executeUpdate();
 
     transaction.commit();
+    writeThrough([booking_id](BookingIntervalIndex& index) {
+        index.erase(booking_id);
+        return true;
+    });
 }
@@ -2,9 +2,15 @@
 
 #include "IDatabase.h"
 #include "Booking.h"
+#include "RowCursor.h"
+#include "BookingIntervalIndex.h"
 #include <vector>
 #include <memory>
+#include <optional>
 #include <stdexcept>
+#include <chrono>
+#include <functional>
+#include <mutex>
 
 /**
  * @file BookingRepository.h
@@ -13,10 +19,23 @@
  * The BookingRepository implements CRUD operations for Booking objects using the
  * provided IDatabase adapter. All methods operate on the underlying
  * database and translate rows into concrete Booking object.
+ *
+ * Conflict checks are answered from an in-memory BookingIntervalIndex of
+ * the room and dates of every booking that has not ended yet. The index is
+ * loaded on first use, reloaded once it is older than the configured
+ * staleness bound, and updated by every booking written through this
+ * repository once its transaction commits. Inside a transaction, and for
+ * stays starting before today, overlap checks go to the database instead.
  */
 class BookingRepository {
 	IDatabase& database; ///< Database adapter reference used to run queries.
 
+	std::chrono::milliseconds index_staleness;                     ///< Maximum index age; zero disables the index.
+	mutable std::mutex index_mutex;                                ///< Guards every index member below.
+	mutable BookingIntervalIndex interval_index;                   ///< Booked stays grouped by room.
+	mutable std::chrono::steady_clock::time_point index_loaded_at; ///< When interval_index was read from the database.
+	mutable bool index_loaded;                                     ///< Whether interval_index holds every current booking.
+
 	/**
 	 * @brief Construct a Booking object from a result row.
 	 * @param result Result row to read booking fields from.
@@ -32,17 +51,56 @@ class BookingRepository {
 	std::vector<Booking> fetchBookings(std::unique_ptr<IGenericResultSet> result) const;
 
 	/**
-	 * @brief Read the last auto-increment id produced by an insert.
-	 * @return int Last inserted id.
+	 * @brief Reload the interval index if it is missing or stale.
+	 * @note Caller must hold index_mutex.
+	 */
+	void refreshIndex() const;
+
+	/**
+	 * @brief Apply a written change to the interval index once it is committed.
+	 *
+	 * Inside a ScopedTransaction the change is queued and applied after the
+	 * outermost commit, or discarded on rollback. Inside a transaction opened
+	 * by other means the index is dropped instead.
+	 *
+	 * @param change Update to apply to the index; it must capture by value and
+	 *        return false when the index cannot follow the change, which drops it.
 	 */
-	int getLastInsertedId() const;
+	void writeThrough(std::function<bool(BookingIntervalIndex&)> change);
 
 public:
+	/// Default staleness bound for the interval index.
+	static constexpr std::chrono::milliseconds DEFAULT_INDEX_STALENESS{ 60000 };
+
 	/**
 	 * @brief Construct a BookingRepository using the given database adapter.
 	 * @param db Database adapter to use for queries.
+	 * @param index_staleness How old the in-memory interval index may get before
+	 *        it is reloaded; bookings made by another process are seen after at
+	 *        most this long. Zero disables the index.
+	 */
+	BookingRepository(IDatabase& db, std::chrono::milliseconds index_staleness = DEFAULT_INDEX_STALENESS);
+
+	/**
+	 * @brief Whether overlap checks for a stay are currently answered from memory.
+	 * @param check_in Start of the stay; the index holds no booking that ended before today.
+	 * @return true if the index is enabled, no transaction is active and the stay starts today or later.
+	 */
+	bool isIndexUsable(const DateTime& check_in) const;
+
+	/**
+	 * @brief Get the staleness bound of the interval index.
+	 * @return std::chrono::milliseconds Maximum index age; zero when the index is disabled.
 	 */
-	BookingRepository(IDatabase& db);
+	std::chrono::milliseconds getIndexStaleness() const;
+
+	/**
+	 * @brief Drop the interval index so the next check reloads it.
+	 *
+	 * Only needed when bookings are changed outside this repository and must
+	 * be visible before the staleness bound expires.
+	 */
+	void invalidateIndex();
 
 	/**
 	 * @brief Check whether a booking exists by id.
@@ -60,17 +118,36 @@ public:
 
 	// CREATE
 	/**
-	 * @brief Insert a booking record and return the new id.
-	 * @param booking Booking value to persist.
-	 * @return int New booking id.
+	 * @brief Insert a booking record and return it with its generated id.
+	 * @param booking Booking value to persist; its id is ignored.
+	 * @return Booking Stored booking.
+	 */
+	Booking addBooking(const Booking& booking);
+
+	/**
+	 * @brief Insert many bookings in one transaction using a batched statement.
+	 *
+	 * Intended for bulk loads such as tour-operator block bookings. No
+	 * availability checks are made here.
+	 *
+	 * @param bookings Bookings to persist.
+	 * @return std::vector<int> New booking ids, in the order of @p bookings.
 	 */
-	int addBookingAndGetId(const Booking& booking);
+	std::vector<int> addBookingsAndGetIds(const std::vector<Booking>& bookings);
 
 	// READ
+	/**
+	 * @brief Look up a booking by id.
+	 * @param booking_id Booking id to look up.
+	 * @return std::optional<Booking> Loaded booking, or std::nullopt if there is no such booking.
+	 */
+	std::optional<Booking> findBookingById(int booking_id) const;
+
 	/**
 	 * @brief Load a booking by id.
 	 * @param booking_id Booking id to load.
 	 * @return Booking Loaded booking value.
+	 * @throws std::runtime_error if the booking does not exist.
 	 */
 	Booking getBookingById(int booking_id) const;
 
@@ -86,6 +163,12 @@ public:
 	 */
 	std::vector<Booking> getAllBookings() const;
 
+	/**
+	 * @brief Stream all bookings one row at a time.
+	 * @return RowCursor<Booking> Single-pass range over every booking.
+	 */
+	RowCursor<Booking> streamAllBookings() const;
+
 	/**
 	 * @brief Get bookings associated with a particular room.
 	 * @param room_num Room number to filter bookings.
@@ -93,6 +176,84 @@ public:
 	 */
 	std::vector<Booking> getBookingsByRoom(int room_num) const;
 
+	/**
+	 * @brief Get bookings made by a particular customer.
+	 * @param customer_id Customer id to filter bookings.
+	 * @return std::vector<Booking> Bookings of the customer.
+	 */
+	std::vector<Booking> getBookingsByCustomer(int customer_id) const;
+
+	/**
+	 * @brief Get the bookings of one room that overlap a stay.
+	 *
+	 * Served by the (room_number, check_in, check_out) index, so only the
+	 * bookings that can conflict are read.
+	 *
+	 * @param room_num Room number to check.
+	 * @param check_in Start of the stay (inclusive).
+	 * @param check_out End of the stay (exclusive).
+	 * @return std::vector<Booking> Overlapping bookings ordered by check-in.
+	 */
+	std::vector<Booking> getOverlappingBookings(int room_num, const DateTime& check_in, const DateTime& check_out) const;
+
+	/**
+	 * @brief Get the bookings of a set of rooms that overlap a stay.
+	 * @param room_numbers Room numbers to check; an empty set yields no bookings.
+	 * @param check_in Start of the stay (inclusive).
+	 * @param check_out End of the stay (exclusive).
+	 * @return std::vector<Booking> Overlapping bookings ordered by room and check-in.
+	 */
+	std::vector<Booking> getOverlappingBookings(const std::vector<int>& room_numbers, const DateTime& check_in, const DateTime& check_out) const;
+
+	/**
+	 * @brief Get every booking in the hotel that overlaps a stay.
+	 *
+	 * Served by the (check_out, check_in) index, so bookings that ended before
+	 * the stay (the bulk of the history) are never read.
+	 *
+	 * @param check_in Start of the stay (inclusive).
+	 * @param check_out End of the stay (exclusive).
+	 * @return std::vector<Booking> Overlapping bookings ordered by room and check-in.
+	 */
+	std::vector<Booking> getOverlappingBookings(const DateTime& check_in, const DateTime& check_out) const;
+
+	/**
+	 * @brief Check whether a room has a booking overlapping a stay.
+	 *
+	 * Answered from the interval index when it is usable, otherwise (always
+	 * inside a transaction) with a single indexed query. The index may lag the
+	 * table by up to the index staleness, so checks that guard a write must run
+	 * inside the writing transaction. See BookingIntervalIndex for the cost.
+	 *
+	 * @param room_num Room number to check.
+	 * @param check_in Start of the stay (inclusive).
+	 * @param check_out End of the stay (exclusive).
+	 * @param exclude_booking_id Booking to ignore (the one being moved), or -1.
+	 * @return true if another booking overlaps [check_in, check_out).
+	 */
+	bool hasOverlappingBooking(int room_num, const DateTime& check_in, const DateTime& check_out, int exclude_booking_id = -1) const;
+
+	/**
+	 * @brief Get the ids of a room's bookings that overlap a stay.
+	 * @param room_num Room number to check.
+	 * @param check_in Start of the stay (inclusive).
+	 * @param check_out End of the stay (exclusive).
+	 * @return std::vector<int> Overlapping booking ids ordered by check-in.
+	 */
+	std::vector<int> getOverlappingBookingIds(int room_num, const DateTime& check_in, const DateTime& check_out) const;
+
+	/**
+	 * @brief Get the numbers of all rooms with a booking overlapping a stay.
+	 *
+	 * With the interval index usable, stays within its two-year calendar are
+	 * answered by a bitmap scan over every booked room at once.
+	 *
+	 * @param check_in Start of the stay (inclusive).
+	 * @param check_out End of the stay (exclusive).
+	 * @return std::vector<int> Booked room numbers in ascending order.
+	 */
+	std::vector<int> getOccupiedRoomNumbers(const DateTime& check_in, const DateTime& check_out) const;
+
 	// UPDATE
 	/**
 	 * @brief Change the status of a booking.
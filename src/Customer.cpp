@@ -1,10 +1,9 @@
 #include<string>
 #include<iostream>
-#include<regex>
 #include <sstream>    
 #include <stdexcept> 
-#include <cctype>     
 #include "Customer.h"
+#include "CustomerValidation.h"
 // Constructors Definition
 Customer::Customer() : id(0), age(0), name(""), phone_number(""), email("") {}
 
@@ -13,17 +12,15 @@ Customer::Customer(int id, const std::string& name, int age, const std::string&
 	setEmail(email);
 	setPhoneNumber(phone);
 }
+
+Customer::Customer(TrustedRow, int id, std::string name, int age, std::string phone, std::string email)
+	: id(id), age(age), name(std::move(name)), phone_number(std::move(phone)), email(std::move(email)) {}
 //Private Function Definitions 
 bool Customer::validateEmail(const std::string& email_)const {
-	const std::regex pattern(R"(\w+@\w+\.\w+)");
-	return std::regex_match(email_, pattern);
+	return isValidEmail(email_);
 }
 bool Customer::validatePhoneNumber(const std::string& phone)const {
-	for (const auto& i : phone) {
-		if (!std::isdigit(static_cast<unsigned char>(i)))
-			return false;
-	}
-	return phone.size() == 11;
+	return isValidPhoneNumber(phone);
 }
 
 // Public FUNCTION DEFINITIONS
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include "TrustedRow.h"
 
 /**
   * @class Customer
@@ -19,14 +20,14 @@ class Customer {
 	std::string email;           ///< Customer Email (contact).
 	/**
 	 * @brief Validates an email address format.
-	 * @details Checks if the email matches the basic pattern: local-part@domain.tld
+	 * @details Applies the customers.chk_email constraint (see CustomerValidation.h).
 	 * @param email_ The email address string to validate.
 	 * @return bool True if the email format is valid, false otherwise.
 	 */
 	bool validateEmail(const std::string& email_)const;
 	/**
 	 * @brief Validates a phone number format.
-	 * @details Checks if the phone number contains only digits and has exactly 11 characters.
+	 * @details Applies the customers.chk_phone constraint: an optional '+' and digits, 8 to 15 characters.
 	 * @param phone The phone number string to validate.
 	 * @return bool True if the phone number format is valid, false otherwise.
 	 */
@@ -48,6 +49,12 @@ public:
 	 */
 	Customer(int id, const std::string& name, int age, const std::string& phone, const std::string& email);
 
+	/**
+	 * @brief Constructor for rows loaded from the database; skips validation.
+	 * @see TrustedRow
+	 */
+	Customer(TrustedRow, int id, std::string name, int age, std::string phone, std::string email);
+
 	/**
 	 * @brief Sets the customer's email address with validation.
 	 * @param email_ The new email address to set.
@@ -1,5 +1,24 @@
 #include "CustomerRepository.h"
 #include "ScopedTransaction.h"
+#include "RowMapper.h"
+
+namespace {
+    struct CustomerMapping {
+        using Entity = Customer;
+        using Columns = std::tuple<int, std::string, int, std::string, std::string>;
+        static constexpr const char* table = "customers";
+        static constexpr std::array<const char*, 5> names = { "customer_id", "name", "age", "phone_number", "email" };
+
+        static Customer create(int customer_id, std::string name, int age, std::string phone_number, std::string email) {
+            return Customer(TrustedRow(), customer_id, std::move(name), age, std::move(phone_number), std::move(email));
+        }
+        static auto insertValues(const Customer& customer) {
+            return std::make_tuple(customer.getName(), customer.getAge(), customer.getPhoneNumber(), customer.getEmail());
+        }
+    };
+    using CustomerRows = RowMapper<CustomerMapping>;
+}
+
 // Constructor
 CustomerRepository::CustomerRepository(IDatabase& db) : database(db) {}
 
@@ -15,14 +34,17 @@ void CustomerRepository::validateCustomerExists(int customer_id) const {
     }
 }
 
+void CustomerRepository::lockCustomerForShare(int customer_id) const {
+    auto stmt = database.prepareStatement("SELECT 1 FROM customers WHERE customer_id=? FOR SHARE");
+    stmt->setInt(1, customer_id);
+    auto result = stmt->executeQuery();
+    if (!result->next()) {
+        throw std::runtime_error("Customer " + std::to_string(customer_id) + " doesn't exist!");
+    }
+}
+
 Customer CustomerRepository::createCustomerFromRow(const IGenericResultSet& result) const {
-    return Customer(
-        result.getInt("customer_id"),
-        result.getString("name"),
-        result.getInt("age"),
-        result.getString("phone_number"),
-        result.getString("email")
-    );
+    return CustomerRows::read(result);
 }
 
 std::vector<Customer> CustomerRepository::fetchCustomers(std::unique_ptr<IGenericResultSet> result) const {
@@ -32,43 +54,31 @@ std::vector<Customer> CustomerRepository::fetchCustomers(std::unique_ptr<IGeneri
     }
     return customers;
 }
-//int CustomerRepository::getLastInsertedId()const {
-//    auto stmt = database.prepareStatement("SELECT LAST_INSERT_ID()");
-//    auto result = stmt->executeQuery();
-//    if (result->next()) {
-//        return result->getInt(1);
-//    }
-//    throw std::runtime_error("Database Error: Failed to get last inserted customer id");
-//}
 // CREATE
-int CustomerRepository::addCustomerAndGetId(const Customer& customer) const {
-        ScopedTransaction transaction(database);
-
-        auto stmt = database.prepareStatement(
-            "INSERT INTO customers (age,name,phone_number,email) VALUES (?,?,?,?)"
-        );
-        stmt->setInt(1, customer.getAge());
-        stmt->setString(2, customer.getName());
-        stmt->setString(3, customer.getPhoneNumber());
-        stmt->setString(4, customer.getEmail());
-        stmt->executeUpdate();
-        int customer_id = database.getLastInsertID();
-        transaction.commit();
-        return customer_id;
+Customer CustomerRepository::addCustomer(const Customer& customer) const {
+        auto stmt = database.prepareStatement(CustomerRows::insert());
+        CustomerRows::bindInsert(*stmt, customer);
+        return CustomerRows::hydrate(stmt->executeInsert(), customer);
 }
 
 // READ
-Customer CustomerRepository::getCustomerById(int customer_id) const {
-
-    auto stmt = database.prepareStatement(
-        "SELECT * FROM customers WHERE customer_id = ?"
-    );
+std::optional<Customer> CustomerRepository::findCustomerById(int customer_id) const {
+    static const std::string query = CustomerRows::select() + " WHERE customer_id = ?";
+    auto stmt = database.prepareStatement(query);
     stmt->setInt(1, customer_id);
     auto result = stmt->executeQuery();
     if (result->next()) {
         return createCustomerFromRow(*result);
     }
-    throw std::runtime_error("Customer " + std::to_string(customer_id) + " not found!");
+    return std::nullopt;
+}
+
+Customer CustomerRepository::getCustomerById(int customer_id) const {
+    auto customer = findCustomerById(customer_id);
+    if (!customer) {
+        throw std::runtime_error("Customer " + std::to_string(customer_id) + " not found!");
+    }
+    return std::move(*customer);
 }
 
 int CustomerRepository::getNumberOfCustomers() const {
@@ -78,11 +88,17 @@ int CustomerRepository::getNumberOfCustomers() const {
 }
 
 std::vector<Customer> CustomerRepository::getAllCustomers() const {
-    auto stmt = database.prepareStatement("SELECT * FROM customers");
+    auto stmt = database.prepareStatement(CustomerRows::select());
     auto result = stmt->executeQuery();
     return fetchCustomers(std::move(result));
 }
 
+RowCursor<Customer> CustomerRepository::streamAllCustomers() const {
+    auto stmt = database.prepareStatement(CustomerRows::select());
+    auto result = stmt->executeQuery();
+    return RowCursor<Customer>(std::move(stmt), std::move(result), &CustomerRows::read);
+}
+
 // UPDATE
 void CustomerRepository::updateCustomerEmail(int customer_id, const std::string& newEmail) const {
 
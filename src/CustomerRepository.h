@@ -1,8 +1,10 @@
 #pragma once
 #include "IDatabase.h"
 #include "Customer.h"
+#include "RowCursor.h"
 #include <vector>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 
 /**
@@ -32,11 +34,6 @@ class CustomerRepository {
      */
     std::vector<Customer> fetchCustomers(std::unique_ptr<IGenericResultSet> result) const;
 
-    /**
-     * @brief Read last inserted id produced by the DB for auto-increment keys.
-     * @return int Last inserted id value.
-     */
-    int getLastInsertedId() const;
 
 public:
     /**
@@ -59,19 +56,39 @@ public:
      */
     void validateCustomerExists(int customer_id) const;
 
+    /**
+     * @brief Validate the existence of a customer and share-lock its row.
+     *
+     * Inside a transaction the row stays locked (FOR SHARE) until the
+     * transaction ends, so the customer cannot be deleted while a row that
+     * refers to it is written.
+     *
+     * @param customer_id Customer id to validate.
+     * @throws std::runtime_error if the customer does not exist.
+     */
+    void lockCustomerForShare(int customer_id) const;
+
     // CREATE
     /**
-     * @brief Insert a new customer and return the created id.
-     * @param customer Customer value to persist.
-     * @return int Inserted customer id.
+     * @brief Insert a new customer and return it with its generated id.
+     * @param customer Customer value to persist; its id is ignored.
+     * @return Customer Stored customer.
      */
-    int addCustomerAndGetId(const Customer& customer) const;
+    Customer addCustomer(const Customer& customer) const;
 
     // READ
+    /**
+     * @brief Look up a customer by id.
+     * @param customer_id Customer id to look up.
+     * @return std::optional<Customer> Loaded customer, or std::nullopt if there is no such customer.
+     */
+    std::optional<Customer> findCustomerById(int customer_id) const;
+
     /**
      * @brief Load a customer by id.
      * @param customer_id Customer id to load.
      * @return Customer Loaded customer value.
+     * @throws std::runtime_error if the customer does not exist.
      */
     Customer getCustomerById(int customer_id) const;
 
@@ -87,6 +104,12 @@ public:
      */
     std::vector<Customer> getAllCustomers() const;
 
+    /**
+     * @brief Stream all customers one row at a time.
+     * @return RowCursor<Customer> Single-pass range over every customer.
+     */
+    RowCursor<Customer> streamAllCustomers() const;
+
     // UPDATE
     /**
      * @brief Update a customer's email address.
@@ -0,0 +1,121 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @file CustomerValidation.h
+ * @brief Hand-written validators matching the customers table CHECK constraints.
+ *
+ * init-db/init.sql constrains customer contact fields with
+ * @code
+ * chk_email: regexp_like(email, '^[A-Za-z0-9_]+@[A-Za-z0-9_]+.[A-Za-z0-9_]+$')
+ * chk_phone: length(phone_number) between 8 and 15 and regexp_like(phone_number, '^[+]?[0-9]+$')
+ * @endcode
+ * The functions below accept the same strings without building a regex, so a
+ * value the application accepts is one the database accepts too. They are
+ * constexpr and checked at compile time by the static_asserts at the end of
+ * this file. One deliberate difference: MySQL's '$' also matches before a
+ * trailing line terminator; these validators reject such a trailing newline.
+ */
+
+namespace customer_validation_detail {
+    constexpr bool isWordChar(char c) {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    constexpr bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    // Byte length of the UTF-8 character starting at text[pos] that the
+    // regex '.' may match, or 0 if it is a line terminator or malformed.
+    constexpr std::size_t anyCharLength(std::string_view text, std::size_t pos) {
+        const unsigned char lead = static_cast<unsigned char>(text[pos]);
+        if (lead < 0x80) {
+            return (lead >= 0x0A && lead <= 0x0D) ? 0 : 1;
+        }
+        std::size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 0;
+        if (length == 0 || pos + length > text.size()) {
+            return 0;
+        }
+        for (std::size_t i = 1; i < length; ++i) {
+            if ((static_cast<unsigned char>(text[pos + i]) & 0xC0) != 0x80) {
+                return 0;
+            }
+        }
+        const std::string_view sequence = text.substr(pos, length);
+        if (sequence == "\xC2\x85" || sequence == "\xE2\x80\xA8" || sequence == "\xE2\x80\xA9") {
+            return 0; // NEL, LINE SEPARATOR, PARAGRAPH SEPARATOR
+        }
+        return length;
+    }
+}
+
+/**
+ * @brief Check an email address against the chk_email constraint.
+ *
+ * The pattern's unescaped '.' matches any one character, so after the '@'
+ * the value is word characters with at most one other character, which is
+ * neither the first nor the last one ("a@b.c", "a@b-c" and "a@bcd" all pass).
+ *
+ * @param email Address to check.
+ * @return true if the database would accept the value.
+ */
+constexpr bool isValidEmail(std::string_view email) {
+    using namespace customer_validation_detail;
+    std::size_t pos = 0;
+    while (pos < email.size() && isWordChar(email[pos])) {
+        ++pos;
+    }
+    if (pos == 0 || pos == email.size() || email[pos] != '@') {
+        return false;
+    }
+    const std::size_t domain = ++pos;
+    std::size_t word_chars = 0;
+    bool separator_seen = false;
+    while (pos < email.size()) {
+        if (isWordChar(email[pos])) {
+            ++word_chars;
+            ++pos;
+            continue;
+        }
+        const std::size_t length = anyCharLength(email, pos);
+        if (separator_seen || length == 0 || pos == domain) {
+            return false;
+        }
+        separator_seen = true;
+        pos += length;
+        if (pos == email.size()) {
+            return false;
+        }
+    }
+    // With a separator it splits the two word runs; without one, any inner
+    // word character can play the role of '.', which needs three of them.
+    return separator_seen ? word_chars >= 2 : word_chars >= 3;
+}
+
+/**
+ * @brief Check a phone number against the chk_phone constraint.
+ * @param phone Number to check: an optional leading '+' and digits, 8 to 15 characters in total.
+ * @return true if the database would accept the value.
+ */
+constexpr bool isValidPhoneNumber(std::string_view phone) {
+    using namespace customer_validation_detail;
+    if (phone.size() < 8 || phone.size() > 15) {
+        return false;
+    }
+    for (std::size_t i = (phone[0] == '+' ? 1 : 0); i < phone.size(); ++i) {
+        if (!isDigit(phone[i])) {
+            return false;
+        }
+    }
+    return phone[0] != '+' || phone.size() > 1;
+}
+
+static_assert(isValidEmail("john_smith@example.com"), "plain address");
+static_assert(isValidEmail("a@b.c") && isValidEmail("a@b-c") && isValidEmail("a@bcd"), "'.' matches any character");
+static_assert(!isValidEmail("a@bc") && !isValidEmail("a@.bc") && !isValidEmail("a@bc.") && !isValidEmail("a@b.c.d"), "domain shape");
+static_assert(!isValidEmail("@b.c") && !isValidEmail("a.b@c.d") && !isValidEmail("a@b.c\n"), "local part and line terminators");
+static_assert(isValidEmail("a@b\xC3\xA9" "c") && !isValidEmail("a@b\xE2\x80\xA8" "c"), "multi-byte characters");
+static_assert(isValidPhoneNumber("01234567890") && isValidPhoneNumber("+201234567") && isValidPhoneNumber("12345678"), "accepted numbers");
+static_assert(!isValidPhoneNumber("1234567") && !isValidPhoneNumber("1234567890123456") && !isValidPhoneNumber("+12-345678"), "rejected numbers");
@@ -1,131 +1,115 @@
 #include<chrono>
 #include<string>
-#include<iomanip>
-#include<sstream>
+#include<stdexcept>
 #include<ctime>
 #include "DateTime.h"
-DateTime::DateTime() : m_time(std::chrono::system_clock::now()) {}
 
-DateTime::DateTime(const std::string& dateTimeString) {
-	std::istringstream iss(dateTimeString);
+// Private Functions Definition
+void DateTime::setFields(const std::tm& fields) {
+	int seconds = fields.tm_hour * 3600 + fields.tm_min * 60 + fields.tm_sec;
+	m_days = daysFromCivil(fields.tm_year + 1900, static_cast<unsigned>(fields.tm_mon + 1), static_cast<unsigned>(fields.tm_mday))
+		+ seconds / SECONDS_PER_DAY;
+	m_seconds = seconds % SECONDS_PER_DAY;
+}
+
+std::tm DateTime::toFields() const {
+	CivilDate date = civilFromDays(m_days);
 	std::tm tmStruct = {};
-	iss >> std::get_time(&tmStruct, "%Y-%m-%d %H:%M:%S");
-	if (iss.fail()) {
-		throw std::invalid_argument("Invalid date-time format. Expected: YYYY-MM-DD HH:MM:SS");
-	}
-	m_time = std::chrono::system_clock::from_time_t(std::mktime(&tmStruct));
+	tmStruct.tm_year = date.year - 1900;
+	tmStruct.tm_mon = static_cast<int>(date.month) - 1;
+	tmStruct.tm_mday = static_cast<int>(date.day);
+	tmStruct.tm_hour = m_seconds / 3600;
+	tmStruct.tm_min = m_seconds / 60 % 60;
+	tmStruct.tm_sec = m_seconds % 60;
+	tmStruct.tm_isdst = -1;
+	return tmStruct;
+}
+
+// Constructors Definition
+DateTime::DateTime() : m_days(0), m_seconds(0) {
+	setDateTime(std::chrono::system_clock::now());
 }
 
+DateTime::DateTime(const std::string& dateTimeString) : m_days(0), m_seconds(0) {
+	setDateTime(dateTimeString);
+}
+
+// Public Functions Definition
 DateTime DateTime::operator+(int days) const {
 	DateTime result = *this;
-	result.m_time += std::chrono::hours(24 * days);
+	result.m_days += days;
 	return result;
 }
 
 int DateTime::operator-(const DateTime& other) const {
-	auto duration = m_time - other.getTimePoint();
-	auto hours = std::chrono::duration_cast<std::chrono::hours>(duration).count();
-	return hours / 24;
+	long long seconds = static_cast<long long>(m_days - other.m_days) * SECONDS_PER_DAY + (m_seconds - other.m_seconds);
+	return static_cast<int>(seconds / SECONDS_PER_DAY);
 }
 
 bool DateTime::operator<=(const DateTime& rhs) const {
-	return m_time <= rhs.m_time;
+	return !(rhs < *this);
 }
 
 bool DateTime::operator>=(const DateTime& rhs) const {
-	return m_time >= rhs.m_time;
+	return !(*this < rhs);
 }
 
 bool DateTime::operator>(const DateTime& rhs) const {
-	return m_time > rhs.m_time;
+	return rhs < *this;
 }
 
 bool DateTime::operator<(const DateTime& rhs) const {
-	return m_time < rhs.m_time;
+	return m_days < rhs.m_days || (m_days == rhs.m_days && m_seconds < rhs.m_seconds);
 }
 
 void DateTime::setDateTime(const std::chrono::system_clock::time_point& new_time) {
-	m_time = new_time;
-}
-
-void DateTime::setDateTime(const std::string& date_time_string) {
-	std::istringstream iss(date_time_string);
-	std::tm tmStruct = {};
-	iss >> std::get_time(&tmStruct, "%Y-%m-%d %H:%M:%S");
-	if (iss.fail()) {
-		throw std::invalid_argument("Invalid date-time format. Expected: YYYY-MM-DD HH:MM:SS");
-	}
-	m_time = std::chrono::system_clock::from_time_t(std::mktime(&tmStruct));
-}
-
-void DateTime::setDateAtNoon() {
-	std::time_t current_time = std::chrono::system_clock::to_time_t(m_time);
+	std::time_t timeT = std::chrono::system_clock::to_time_t(new_time);
 	std::tm tmStruct = {};
 
 #ifdef _WIN32
-	errno_t err = localtime_s(&tmStruct, &current_time);
-	if (err != 0) {
+	if (localtime_s(&tmStruct, &timeT) != 0) {
 		throw std::runtime_error("Failed to convert time");
 	}
 #else
-	if (localtime_r(&current_time, &tmStruct) == nullptr) {
+	if (localtime_r(&timeT, &tmStruct) == nullptr) {
 		throw std::runtime_error("Failed to convert time");
 	}
 #endif
-	// Set time to 12:00:00 (noon) while keeping the same date
-	tmStruct.tm_hour = 12;  // 12 PM
-	tmStruct.tm_min = 0;
-	tmStruct.tm_sec = 0;
-
-	// Convert back to time_point and update member variable
-	m_time = std::chrono::system_clock::from_time_t(std::mktime(&tmStruct));
+	setFields(tmStruct);
 }
 
-std::string DateTime::getDateTimeString() const {
-	std::time_t timeT = std::chrono::system_clock::to_time_t(m_time);
+void DateTime::setDateTime(const std::string& date_time_string) {
 	std::tm tmStruct;
+	if (!parseDateTimeFields(date_time_string.data(), date_time_string.size(), tmStruct)) {
+		throw std::invalid_argument("Invalid date-time format. Expected: YYYY-MM-DD HH:MM:SS");
+	}
+	setFields(tmStruct);
+}
 
-#ifdef _WIN32
-	localtime_s(&tmStruct, &timeT);
-#else
-	localtime_r(&timeT, &tmStruct);
-#endif
-
-	std::ostringstream oss;
-	oss << std::put_time(&tmStruct, "%Y-%m-%d %H:%M:%S");
-	return oss.str();
+void DateTime::setDateAtNoon() {
+	m_seconds = 12 * 3600;
 }
 
-std::string DateTime::getTimeString() const {
-	std::time_t timeT = std::chrono::system_clock::to_time_t(m_time);
-	std::tm tmStruct;
+std::string DateTime::getDateTimeString() const {
+	char buffer[DATE_TIME_BUFFER_SIZE];
+	return std::string(buffer, writeDateTimeString(buffer));
+}
 
-#ifdef _WIN32
-	localtime_s(&tmStruct, &timeT);
-#else
-	localtime_r(&timeT, &tmStruct);
-#endif
+std::size_t DateTime::writeDateTimeString(char* buffer) const {
+	return formatDateTimeFields(toFields(), buffer);
+}
 
-	std::ostringstream oss;
-	oss << std::put_time(&tmStruct, "%H:%M:%S");
-	return oss.str();
+std::string DateTime::getTimeString() const {
+	char buffer[TIME_LENGTH + 1];
+	return std::string(buffer, formatTimeFields(toFields(), buffer));
 }
 
 std::string DateTime::getDateString() const {
-	std::time_t timeT = std::chrono::system_clock::to_time_t(m_time);
-	std::tm tmStruct;
-
-#ifdef _WIN32
-	localtime_s(&tmStruct, &timeT);
-#else
-	localtime_r(&timeT, &tmStruct);
-#endif
-
-	std::ostringstream oss;
-	oss << std::put_time(&tmStruct, "%Y-%m-%d");
-	return oss.str();
+	char buffer[DATE_LENGTH + 1];
+	return std::string(buffer, formatDateFields(toFields(), buffer));
 }
 
 std::chrono::system_clock::time_point DateTime::getTimePoint() const {
-	return m_time;
-}
\ No newline at end of file
+	std::tm tmStruct = toFields();
+	return std::chrono::system_clock::from_time_t(std::mktime(&tmStruct));
+}
@@ -2,27 +2,98 @@
 
 #include<string>
 #include<chrono>
+#include<cstddef>
+#include<ctime>
+#include "DateTimeCodec.h"
+
+/**
+ * @struct CivilDate
+ * @brief Proleptic Gregorian calendar date.
+ */
+struct CivilDate {
+	int year;
+	unsigned month; ///< 1..12
+	unsigned day;   ///< 1..31
+};
+
+/**
+ * @brief Number of days from 1970-01-01 to the given civil date.
+ * @details Branch-light algorithm by Howard Hinnant, valid for every date representable in int.
+ * @param year Calendar year.
+ * @param month Month 1..12.
+ * @param day Day of month 1..31.
+ * @return int Days since the epoch; negative before 1970.
+ */
+constexpr int daysFromCivil(int year, unsigned month, unsigned day) {
+	year -= month <= 2;
+	const int era = (year >= 0 ? year : year - 399) / 400;
+	const unsigned year_of_era = static_cast<unsigned>(year - era * 400);
+	const unsigned day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+	return era * 146097 + static_cast<int>(day_of_era) - 719468;
+}
+
+/**
+ * @brief Inverse of daysFromCivil().
+ * @param days Days since 1970-01-01.
+ * @return CivilDate Calendar date.
+ */
+constexpr CivilDate civilFromDays(int days) {
+	days += 719468;
+	const int era = (days >= 0 ? days : days - 146096) / 146097;
+	const unsigned day_of_era = static_cast<unsigned>(days - era * 146097);
+	const unsigned year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+	const unsigned day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+	const unsigned mp = (5 * day_of_year + 2) / 153;
+	const unsigned day = day_of_year - (153 * mp + 2) / 5 + 1;
+	const unsigned month = mp < 10 ? mp + 3 : mp - 9;
+	return CivilDate{ static_cast<int>(year_of_era) + era * 400 + (month <= 2), month, day };
+}
+
+static_assert(daysFromCivil(1970, 1, 1) == 0, "Epoch must be day 0");
+static_assert(daysFromCivil(2000, 3, 1) == 11017, "daysFromCivil must handle leap centuries");
+static_assert(civilFromDays(11016).month == 2 && civilFromDays(11016).day == 29, "civilFromDays must round-trip");
+
 /**
   * @class DateTime
-  * @brief Represents a specific point in time with comprehensive formatting capabilities.
-  * using the chrono library for internal storage and supporting string conversion
-  * in standard ISO-like formats. It features cross-platform thread-safe implementation
+  * @brief Represents a local wall-clock date and time, like a MySQL DATETIME.
+  *
+  * The value is stored as a day number since 1970-01-01 plus the seconds
+  * since midnight, so arithmetic, comparisons and night counts are plain
+  * integer operations that need no libc time zone calls and are safe on any
+  * number of threads. Conversion to or from the system clock (now(),
+  * time_point) is the only place local time zone rules are applied.
 */
 
 class DateTime {
 private:
-	std::chrono::system_clock::time_point m_time;
+	static constexpr int SECONDS_PER_DAY = 24 * 60 * 60;
+
+	int m_days;    ///< Days since 1970-01-01.
+	int m_seconds; ///< Seconds since midnight, 0..SECONDS_PER_DAY - 1.
+
+	/**
+	 * @brief Set the value from calendar fields, carrying overflowing seconds.
+	 * @param fields Calendar fields (tm_isdst is ignored).
+	 */
+	void setFields(const std::tm& fields);
+
+	/**
+	 * @brief Calendar fields of the stored value.
+	 * @return std::tm Fields with tm_isdst set to -1.
+	 */
+	std::tm toFields() const;
 
 public:
 	/**
 	 * @brief Default constructor.
-	 * @details Initializes the DateTime object to current system time.
+	 * @details Initializes the DateTime object to current local time.
 	 */
 	DateTime();
 
 	/**
 	 * @brief Constructor from formatted string.
-	 * @param dateTimeString String in "YYYY-MM-DD HH:MM:SS" format.
+	 * @param dateTimeString String in "YYYY-MM-DD HH:MM:SS" or "YYYY-MM-DD" format.
 	 * @throw std::invalid_argument If the input string format is incorrect.
 	 */
 	DateTime(const std::string& dateTimeString);
@@ -70,21 +141,21 @@ public:
 	bool operator<(const DateTime& rhs) const;
 
 	/**
-	 * @brief Sets time from time_point object.
+	 * @brief Sets time from time_point object, converted to local time.
 	 * @param new_time The new time point to set.
 	 */
 	void setDateTime(const std::chrono::system_clock::time_point& new_time);
 
 	/**
 	 * @brief Sets time by parsing formatted string.
-	 * @param date_time_string String in "YYYY-MM-DD HH:MM:SS" format.
+	 * @param date_time_string String in "YYYY-MM-DD HH:MM:SS" or "YYYY-MM-DD" format.
 	 * @throw std::invalid_argument If the input string format is incorrect.
 	 */
 	void setDateTime(const std::string& date_time_string);
 
 	/**
 	 * @brief Sets the time to 12:00:00 PM (noon) while keeping the same date.
-	 * The date portion remains unchanged from the current m_time value.
+	 * The date portion remains unchanged.
 	 */
 	void setDateAtNoon();
 
@@ -94,6 +165,13 @@ public:
 	 */
 	std::string getDateTimeString() const;
 
+	/**
+	 * @brief Writes the "YYYY-MM-DD HH:MM:SS" representation without allocating.
+	 * @param buffer Destination of at least DATE_TIME_BUFFER_SIZE characters; NUL terminated.
+	 * @return size_t Number of characters written, excluding the NUL.
+	 */
+	std::size_t writeDateTimeString(char* buffer) const;
+
 	/**
 	 * @brief Extracts time portion of the DateTime.
 	 * @return string Formatted as "HH:MM:SS".
@@ -107,8 +185,20 @@ public:
 	std::string getDateString() const;
 
 	/**
-	 * @brief Gets internal time_point representation.
-	 * @return chrono::system_clock::time_point Underlying time point.
+	 * @brief Gets the date as a day number.
+	 * @return int Days since 1970-01-01.
+	 */
+	int getEpochDay() const { return m_days; }
+
+	/**
+	 * @brief Gets the time of day.
+	 * @return int Seconds since midnight.
+	 */
+	int getSecondOfDay() const { return m_seconds; }
+
+	/**
+	 * @brief Converts the local date and time to a system clock time point.
+	 * @return chrono::system_clock::time_point Matching time point.
 	 */
 	std::chrono::system_clock::time_point getTimePoint() const;
 };
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "DateTimeCodec.h"
+
+namespace {
+	bool readDigits(const char* text, int count, int& value) {
+		value = 0;
+		for (int i = 0; i < count; ++i) {
+			unsigned digit = static_cast<unsigned>(static_cast<unsigned char>(text[i])) - '0';
+			if (digit > 9) {
+				return false;
+			}
+			value = value * 10 + static_cast<int>(digit);
+		}
+		return true;
+	}
+
+	void writeDigits(char* out, int value, int count) {
+		for (int i = count - 1; i >= 0; --i) {
+			out[i] = static_cast<char>('0' + value % 10);
+			value /= 10;
+		}
+	}
+
+	int daysInMonth(int year, int month) {
+		static const int days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+		bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+		return month == 2 && leap ? 29 : days[month - 1];
+	}
+}
+
+bool parseDateTimeFields(const char* text, std::size_t length, std::tm& fields) {
+	int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+	if (length < DATE_LENGTH
+		|| !readDigits(text, 4, year) || text[4] != '-'
+		|| !readDigits(text + 5, 2, month) || text[7] != '-'
+		|| !readDigits(text + 8, 2, day)) {
+		return false;
+	}
+	if (length > DATE_LENGTH) {
+		if (length < DATE_TIME_LENGTH || text[10] != ' '
+			|| !readDigits(text + 11, 2, hour) || text[13] != ':'
+			|| !readDigits(text + 14, 2, minute) || text[16] != ':'
+			|| !readDigits(text + 17, 2, second)) {
+			return false;
+		}
+		if (length > DATE_TIME_LENGTH) {
+			if (text[DATE_TIME_LENGTH] != '.' || length == DATE_TIME_LENGTH + 1) {
+				return false;
+			}
+			for (std::size_t i = DATE_TIME_LENGTH + 1; i < length; ++i) {
+				if (text[i] < '0' || text[i] > '9') {
+					return false;
+				}
+			}
+		}
+	}
+	if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)
+		|| hour > 23 || minute > 59 || second > 60) {
+		return false;
+	}
+
+	fields = {};
+	fields.tm_year = year - 1900;
+	fields.tm_mon = month - 1;
+	fields.tm_mday = day;
+	fields.tm_hour = hour;
+	fields.tm_min = minute;
+	fields.tm_sec = second;
+	fields.tm_isdst = -1;
+	return true;
+}
+
+std::size_t formatDateFields(const std::tm& fields, char* buffer) {
+	writeDigits(buffer, fields.tm_year + 1900, 4);
+	buffer[4] = '-';
+	writeDigits(buffer + 5, fields.tm_mon + 1, 2);
+	buffer[7] = '-';
+	writeDigits(buffer + 8, fields.tm_mday, 2);
+	buffer[DATE_LENGTH] = '\0';
+	return DATE_LENGTH;
+}
+
+std::size_t formatTimeFields(const std::tm& fields, char* buffer) {
+	writeDigits(buffer, fields.tm_hour, 2);
+	buffer[2] = ':';
+	writeDigits(buffer + 3, fields.tm_min, 2);
+	buffer[5] = ':';
+	writeDigits(buffer + 6, fields.tm_sec, 2);
+	buffer[TIME_LENGTH] = '\0';
+	return TIME_LENGTH;
+}
+
+std::size_t formatDateTimeFields(const std::tm& fields, char* buffer) {
+	formatDateFields(fields, buffer);
+	buffer[DATE_LENGTH] = ' ';
+	formatTimeFields(fields, buffer + DATE_LENGTH + 1);
+	return DATE_TIME_LENGTH;
+}
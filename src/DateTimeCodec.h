@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <ctime>
+
+/**
+ * @file DateTimeCodec.h
+ * @brief Allocation-free codec for the fixed date formats used by the database.
+ *
+ * MySQL DATETIME and DATE values travel as "YYYY-MM-DD HH:MM:SS" and
+ * "YYYY-MM-DD". These functions convert between that text and std::tm
+ * fields with plain digit arithmetic, without streams, locales or heap
+ * allocations. Formatting writes into a buffer supplied by the caller.
+ */
+
+constexpr std::size_t DATE_TIME_LENGTH = 19;      ///< Characters in "YYYY-MM-DD HH:MM:SS".
+constexpr std::size_t DATE_LENGTH = 10;           ///< Characters in "YYYY-MM-DD".
+constexpr std::size_t TIME_LENGTH = 8;            ///< Characters in "HH:MM:SS".
+constexpr std::size_t DATE_TIME_BUFFER_SIZE = DATE_TIME_LENGTH + 1; ///< Buffer size for formatDateTimeFields(), including the NUL.
+
+/**
+ * @brief Parse "YYYY-MM-DD HH:MM:SS" or "YYYY-MM-DD" into calendar fields.
+ *
+ * A date without a time means midnight. A fractional-seconds suffix
+ * (".ffffff", as sent for DATETIME(n) columns) is accepted and ignored.
+ * Fields are range checked, including the number of days in the month.
+ *
+ * @param text Characters to parse (not necessarily NUL terminated).
+ * @param length Number of characters in @p text.
+ * @param fields Receives the parsed fields; tm_isdst is -1 so mktime() decides DST.
+ * @return true on success, false if the text is not in one of the formats.
+ */
+bool parseDateTimeFields(const char* text, std::size_t length, std::tm& fields);
+
+/**
+ * @brief Write fields as "YYYY-MM-DD HH:MM:SS" followed by a NUL.
+ * @param fields Calendar fields; the year must be in 0..9999.
+ * @param buffer Destination of at least DATE_TIME_BUFFER_SIZE characters.
+ * @return std::size_t DATE_TIME_LENGTH.
+ */
+std::size_t formatDateTimeFields(const std::tm& fields, char* buffer);
+
+/**
+ * @brief Write fields as "YYYY-MM-DD" followed by a NUL.
+ * @param fields Calendar fields; the year must be in 0..9999.
+ * @param buffer Destination of at least DATE_LENGTH + 1 characters.
+ * @return std::size_t DATE_LENGTH.
+ */
+std::size_t formatDateFields(const std::tm& fields, char* buffer);
+
+/**
+ * @brief Write fields as "HH:MM:SS" followed by a NUL.
+ * @param fields Calendar fields.
+ * @param buffer Destination of at least TIME_LENGTH + 1 characters.
+ * @return std::size_t TIME_LENGTH.
+ */
+std::size_t formatTimeFields(const std::tm& fields, char* buffer);
@@ -51,6 +51,7 @@ public:
 	 * @return double The total price per night including extra fees.
 	 */
 	double getTotalPrice() const override { return Room::getBasePrice() + getExtraFees(); }
+	std::unique_ptr<Room> clone() const override { return std::make_unique<DeluxeRoom>(*this); }
 
 	/**
 	 * @brief Serializes the DeluxeRoom object into a formatted string representation.
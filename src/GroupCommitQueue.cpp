@@ -0,0 +1,148 @@
+#include "GroupCommitQueue.h"
+#include "ScopedTransaction.h"
+#include <exception>
+#include <iterator>
+#include <utility>
+
+// Private Functions Definition
+void GroupCommitQueue::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        ready.wait(lock, [this] { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            return;
+        }
+        auto deadline = pending.front().queued_at + config.window;
+        ready.wait_until(lock, deadline, [this] { return stopping || pending.size() >= config.max_batch; });
+
+        std::vector<Pending> batch;
+        while (!pending.empty() && batch.size() < config.max_batch) {
+            batch.push_back(std::move(pending.front()));
+            pending.pop_front();
+        }
+        lock.unlock();
+        commitBatch(batch);
+        lock.lock();
+    }
+}
+
+void GroupCommitQueue::commitBatch(std::vector<Pending>& batch) {
+    if (batch.empty()) {
+        return;
+    }
+    if (batch.size() == 1) {
+        commitAlone(batch.front());
+        return;
+    }
+    std::size_t applied = 0;
+    try {
+        ScopedTransaction transaction(database);
+        for (auto& mutation : batch) {
+            mutation.apply();
+            ++applied;
+        }
+        transaction.commit();
+    }
+    catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++stats.retried;
+        }
+        if (applied == batch.size()) {
+            // The commit itself failed: nothing tells the mutations apart.
+            for (auto& mutation : batch) {
+                commitAlone(mutation);
+            }
+            return;
+        }
+        // Keep queue order: the mutations before the one that threw, that one alone, then the rest.
+        std::vector<Pending> before(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.begin() + applied));
+        std::vector<Pending> after(std::make_move_iterator(batch.begin() + applied + 1), std::make_move_iterator(batch.end()));
+        commitBatch(before);
+        commitAlone(batch[applied]);
+        commitBatch(after);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++stats.transactions;
+        stats.committed += batch.size();
+    }
+    for (auto& mutation : batch) {
+        complete(mutation);
+    }
+}
+
+void GroupCommitQueue::commitAlone(Pending& mutation) {
+    try {
+        ScopedTransaction transaction(database);
+        mutation.apply();
+        transaction.commit();
+    }
+    catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++stats.failed;
+        }
+        mutation.done.set_exception(std::current_exception());
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++stats.transactions;
+        ++stats.committed;
+    }
+    complete(mutation);
+}
+
+void GroupCommitQueue::complete(Pending& mutation) {
+    if (mutation.committed) {
+        try {
+            mutation.committed();
+        }
+        catch (...) {
+            // The write is durable; a failing refresh must not report it as lost.
+        }
+    }
+    mutation.done.set_value();
+}
+
+// Constructors Definition
+GroupCommitQueue::GroupCommitQueue(IDatabase& database, GroupCommitConfig config)
+    : database(database), config(config), stopping(false) {
+    if (this->config.max_batch == 0) {
+        this->config.max_batch = 1;
+    }
+    worker = std::thread(&GroupCommitQueue::run, this);
+}
+
+GroupCommitQueue::~GroupCommitQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_all();
+    worker.join();
+}
+
+// Public Functions Definition
+std::future<void> GroupCommitQueue::submit(Mutation apply, Mutation committed) {
+    Pending mutation{ std::move(apply), std::move(committed), std::promise<void>(), std::chrono::steady_clock::now() };
+    std::future<void> done = mutation.done.get_future();
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(std::move(mutation));
+        ++stats.submitted;
+        wake = pending.size() == 1 || pending.size() >= config.max_batch;
+    }
+    if (wake) {
+        ready.notify_one();
+    }
+    return done;
+}
+
+GroupCommitStats GroupCommitQueue::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
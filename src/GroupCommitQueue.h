@@ -0,0 +1,154 @@
+#pragma once
+#include "IDatabase.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file GroupCommitQueue.h
+ * @brief Write-behind queue committing independent mutations in shared transactions.
+ *
+ * Every repository mutation opens its own ScopedTransaction, which costs a
+ * begin and a commit round trip (and a log flush) per row changed. A burst of
+ * small, independent updates such as the night-audit status flip or a wave of
+ * check-outs spends most of its time in those round trips. GroupCommitQueue
+ * lets callers hand such mutations to a worker thread instead:
+ * @code
+ * GroupCommitQueue queue(database);
+ * std::future<void> done = queue.submit([&] { room_repo.updateRoomStatus(101, "available"); });
+ * done.get(); // Returns once the update is committed, rethrows its error otherwise.
+ * @endcode
+ * The worker waits up to `window` after the oldest queued mutation for others
+ * to arrive (or until `max_batch` are queued), then runs the whole batch in
+ * one transaction; the mutations' own ScopedTransaction join it, as they run
+ * on the thread that opened it. Futures are
+ * fulfilled only after the commit returns. If a mutation of a batch throws,
+ * the batch is rolled back and replayed in queue order: the mutations before
+ * it as a batch, the failing one in a transaction of its own, then the rest,
+ * so one bad mutation only fails its own future. If the commit itself fails,
+ * every mutation of the batch is retried alone.
+ *
+ * Mutations run on the worker thread. Other threads never join its batch:
+ * their ScopedTransaction begins a transaction of their own, which on a
+ * backend with one transaction per connection (MySQLDatabase,
+ * InMemoryDatabase) fails with "Transaction already active" while a batch is
+ * open. Use a database with per-thread transactions (MySQLConnectionPool)
+ * when other threads write meanwhile. Mutations must not depend on each
+ * other's order beyond queue order.
+ * The destructor commits what is still queued.
+ */
+
+/**
+ * @struct GroupCommitConfig
+ * @brief Batching bounds of a GroupCommitQueue.
+ */
+struct GroupCommitConfig {
+    std::chrono::milliseconds window{ 5 };  ///< Longest wait after the oldest queued mutation.
+    std::size_t max_batch = 64;             ///< Queued mutations that start a commit without waiting.
+};
+
+/**
+ * @struct GroupCommitStats
+ * @brief Counters of a GroupCommitQueue.
+ */
+struct GroupCommitStats {
+    std::size_t submitted = 0;      ///< Mutations queued.
+    std::size_t committed = 0;      ///< Mutations whose transaction committed.
+    std::size_t failed = 0;         ///< Mutations that threw when run alone.
+    std::size_t transactions = 0;   ///< Transactions committed, shared or not.
+    std::size_t retried = 0;        ///< Batches rolled back and replayed.
+
+    /**
+     * @brief Average mutations per committed transaction.
+     * @return double 0 when nothing was committed yet.
+     */
+    double averageBatchSize() const {
+        return transactions == 0 ? 0.0 : static_cast<double>(committed) / static_cast<double>(transactions);
+    }
+};
+
+/**
+ * @class GroupCommitQueue
+ * @brief Worker thread grouping queued mutations into shared transactions.
+ */
+class GroupCommitQueue {
+public:
+    using Mutation = std::function<void()>;
+
+private:
+    /// Queued mutation and the promise its caller waits on.
+    struct Pending {
+        Mutation apply;
+        Mutation committed;
+        std::promise<void> done;
+        std::chrono::steady_clock::time_point queued_at;
+    };
+
+    IDatabase& database;
+    GroupCommitConfig config;
+    mutable std::mutex mutex;               ///< Guards pending, stopping and stats.
+    std::condition_variable ready;          ///< Signalled on submit and on stop.
+    std::deque<Pending> pending;
+    GroupCommitStats stats;
+    bool stopping;
+    std::thread worker;
+
+    /**
+     * @brief Worker loop: wait for a batch, commit it, repeat until stopped and drained.
+     */
+    void run();
+
+    /**
+     * @brief Run a batch in one transaction, splitting it around a mutation that throws.
+     * @param batch Mutations taken from the queue.
+     */
+    void commitBatch(std::vector<Pending>& batch);
+
+    /**
+     * @brief Run one mutation in its own transaction and fulfil its promise.
+     * @param mutation Mutation to run.
+     */
+    void commitAlone(Pending& mutation);
+
+    /**
+     * @brief Run the post-commit callback and fulfil the promise of a committed mutation.
+     * @param mutation Committed mutation.
+     */
+    void complete(Pending& mutation);
+
+public:
+    /**
+     * @brief Start the worker thread.
+     * @param database Database the mutations write to.
+     * @param config Batching bounds; a max_batch of 0 is treated as 1.
+     */
+    explicit GroupCommitQueue(IDatabase& database, GroupCommitConfig config = GroupCommitConfig());
+
+    /**
+     * @brief Commit the mutations still queued and stop the worker.
+     */
+    ~GroupCommitQueue();
+
+    /**
+     * @brief Queue a mutation.
+     * @param apply Writes through the repositories; runs on the worker inside the batch transaction.
+     * @param committed Optional callback run on the worker after the commit, e.g. to refresh caches; must not throw.
+     * @return std::future<void> Ready once the mutation is committed; holds its exception if it failed.
+     */
+    std::future<void> submit(Mutation apply, Mutation committed = nullptr);
+
+    /**
+     * @brief Copy the counters.
+     * @return GroupCommitStats Counters since construction.
+     */
+    GroupCommitStats getStats() const;
+
+    GroupCommitQueue(const GroupCommitQueue&) = delete;
+    GroupCommitQueue& operator=(const GroupCommitQueue&) = delete;
+};
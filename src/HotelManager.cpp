@@ -1,4 +1,5 @@
 #include <vector>
+#include <algorithm>
 #include <optional>
 #include <stdexcept>
 #include "HotelManager.h"
@@ -7,71 +8,126 @@
 #include "DeluxeRoom.h"
 #include "Suite.h"
 #include "HelperFunctions.h"
+#include "ScopedTransaction.h"
 // Constructors Definition
-HotelManager::HotelManager(IDatabase& db):
-	room_repo(db),booking_repo(db),customer_repo(db) {}
+HotelManager::HotelManager(IDatabase& db, std::chrono::milliseconds room_cache_staleness,
+	std::chrono::milliseconds booking_index_staleness):
+	database(db), room_repo(db, room_cache_staleness),booking_repo(db, booking_index_staleness),customer_repo(db) {}
+
+// Private Functions Definition
+UnitOfWork::RoomEntry HotelManager::lookupRoom(int room_number) const {
+	return unit_of_work.findRoom(room_number, [&] { return room_repo.findRoomByNumber(room_number); });
+}
+
+UnitOfWork::CustomerEntry HotelManager::lookupCustomer(int customer_id) const {
+	return unit_of_work.findCustomer(customer_id, [&] { return customer_repo.findCustomerById(customer_id); });
+}
+
+UnitOfWork::BookingEntry HotelManager::lookupBooking(int booking_id) const {
+	return unit_of_work.findBooking(booking_id, [&] { return booking_repo.findBookingById(booking_id); });
+}
+
+std::future<void> HotelManager::enqueue(GroupCommitQueue::Mutation apply, GroupCommitQueue::Mutation committed) {
+	if (group_commit) {
+		return group_commit->submit(std::move(apply), std::move(committed));
+	}
+	std::promise<void> done;
+	try {
+		apply();
+		done.set_value();
+	}
+	catch (...) {
+		done.set_exception(std::current_exception());
+	}
+	return done.get_future();
+}
 
 // Public Functions Definitions
+RoomCacheStats HotelManager::getRoomCacheStats() const {
+	return room_repo.getCacheStats();
+}
+
 void HotelManager::validateRoomExists(int room_number) const {
 	room_repo.validateRoomExists(room_number);
 }
 
 void HotelManager::validateCustomerExists(int customer_id) const {
-	customer_repo.validateCustomerExists(customer_id);
+	if (!unit_of_work.isActive()) {
+		customer_repo.validateCustomerExists(customer_id);
+	}
+	else if (!lookupCustomer(customer_id)) {
+		throw std::runtime_error("Customer " + std::to_string(customer_id) + " doesn't exist!");
+	}
 }
 
 void HotelManager::validateBookingExists(int booking_id) const {
-	booking_repo.validateBookingExists(booking_id);
+	if (!unit_of_work.isActive()) {
+		booking_repo.validateBookingExists(booking_id);
+	}
+	else if (!lookupBooking(booking_id)) {
+		throw std::runtime_error("Database Error: Booking " + std::to_string(booking_id) + " doesn't exist!");
+	}
 }
 
 bool HotelManager::isRoomAvailableForDate(int room_number, const DateTime& check_in,
 	const DateTime& check_out, int exclude_booking_id) const {
+	UnitOfWork::Scope scope(unit_of_work);
 	auto room = getRoomByNumber(room_number);
 	if (room->getStatus() != "available")
 		return false;
-	auto room_bookings = booking_repo.getBookingsByRoom(room_number);
-	for (const auto& other_booking : room_bookings) {
-		if (exclude_booking_id == other_booking.getId())
-			continue;
-		if (other_booking.isOverlapping(check_in, check_out)) {
-			return false;
-		}
-	}
-	return true;
+	return !booking_repo.hasOverlappingBooking(room_number, check_in, check_out, exclude_booking_id);
 }
 
 std::vector<std::unique_ptr<Room>> HotelManager::getAvailableRooms(const DateTime& check_in, const DateTime& check_out) const {
-std::vector<bool> is_room_booked(room_repo.getNumberOfRooms() + 1, 0);
-	auto all_bookings = booking_repo.getAllBookings();
-
-	for (const auto& booking : all_bookings) {
-		int room_num = booking.getRoomNumber();
-		if (booking.isOverlapping(check_in, check_out)) {
-			is_room_booked[room_num] = 1;
-		}
-	}
-	std::vector<std::unique_ptr<Room>> available_rooms;
-
-    auto all_rooms = room_repo.getAllRooms();
-	for (auto& room : all_rooms) {
-        int room_num = room->getNumber();
-        if (is_room_booked[room_num] == 0 && room->isRoomAvailable())
-			available_rooms.emplace_back(std::move(room));
-    }
+	if (!booking_repo.isIndexUsable(check_in)) {
+		return room_repo.getAvailableRooms(check_in, check_out);
+	}
+	auto occupied = booking_repo.getOccupiedRoomNumbers(check_in, check_out);
+	auto rooms = room_repo.getRoomsByStatus("available");
+	rooms.erase(std::remove_if(rooms.begin(), rooms.end(), [&occupied](const std::unique_ptr<Room>& room) {
+		return std::binary_search(occupied.begin(), occupied.end(), room->getNumber());
+	}), rooms.end());
+	return rooms;
+}
 
-	return available_rooms;
+std::chrono::milliseconds HotelManager::getAvailabilityStaleness() const {
+	if (booking_repo.getIndexStaleness().count() <= 0) {
+		return std::chrono::milliseconds(0);
+	}
+	return std::max(booking_repo.getIndexStaleness(), room_repo.getCacheStaleness());
 }
 
 std::unique_ptr<Room> HotelManager::getRoomByNumber(int room_num) const {
-	return room_repo.getRoomByNumber(room_num);
+	if (!unit_of_work.isActive()) {
+		return room_repo.getRoomByNumber(room_num);
+	}
+	auto room = lookupRoom(room_num);
+	if (!room) {
+		throw std::runtime_error("Room " + std::to_string(room_num) + " not found!");
+	}
+	return room->clone();
 }
 
 Customer HotelManager::getCustomerById(int customer_id) const {
-	return customer_repo.getCustomerById(customer_id);
+	if (!unit_of_work.isActive()) {
+		return customer_repo.getCustomerById(customer_id);
+	}
+	auto customer = lookupCustomer(customer_id);
+	if (!customer) {
+		throw std::runtime_error("Customer " + std::to_string(customer_id) + " not found!");
+	}
+	return *customer;
 }
 
 Booking HotelManager::getBookingById(int booking_id) const {
-	return booking_repo.getBookingById(booking_id);
+	if (!unit_of_work.isActive()) {
+		return booking_repo.getBookingById(booking_id);
+	}
+	auto booking = lookupBooking(booking_id);
+	if (!booking) {
+		throw std::runtime_error("Booking " + std::to_string(booking_id) + " not found!");
+	}
+	return *booking;
 }
  std::vector<std::unique_ptr<Room>> HotelManager::getRoomsByStatus(const std::string& status)const {
 	return room_repo.getRoomsByStatus(status);
@@ -92,88 +148,136 @@ std::vector<Booking> HotelManager::getAllBookings() const {
 	return booking_repo.getAllBookings();
 }
 
+RowCursor<std::unique_ptr<Room>> HotelManager::streamAllRooms() const {
+	return room_repo.streamAllRooms();
+}
+
+RowCursor<Customer> HotelManager::streamAllCustomers() const {
+	return customer_repo.streamAllCustomers();
+}
+
+RowCursor<Booking> HotelManager::streamAllBookings() const {
+	return booking_repo.streamAllBookings();
+}
+
 void HotelManager::updateRoomPrice(int room_number, double price) {
-	return room_repo.updateRoomPrice(room_number, price);
+	room_repo.updateRoomPrice(room_number, price);
+	unit_of_work.forgetRoom(room_number);
 }
 
 
 void HotelManager::updateRoomStatus(int room_number, const std::string& status) {
-	return room_repo.updateRoomStatus(room_number, toLowerCase(status));
+	room_repo.updateRoomStatus(room_number, toLowerCase(status));
+	unit_of_work.forgetRoom(room_number);
 }
 
 void HotelManager::updateCustomerPhone(int customer_id, const std::string& phone) {
-	return customer_repo.updateCustomerPhoneNumber(customer_id, phone);
+	customer_repo.updateCustomerPhoneNumber(customer_id, phone);
+	unit_of_work.forgetCustomer(customer_id);
 }
 
 void HotelManager::updateCustomerEmail(int customer_id, const std::string& email) {
-	validateCustomerExists(customer_id);
-	return customer_repo.updateCustomerEmail(customer_id, email);
+	customer_repo.updateCustomerEmail(customer_id, email);
+	unit_of_work.forgetCustomer(customer_id);
 }
 
 
 void HotelManager::updateBookingStatus(int booking_id, const std::string& status) {
-	validateBookingExists(booking_id);
-	return booking_repo.updateBookingStatus(booking_id, toLowerCase(status));
+	booking_repo.updateBookingStatus(booking_id, toLowerCase(status));
+	unit_of_work.forgetBooking(booking_id);
+}
+
+void HotelManager::enableGroupCommit(GroupCommitConfig config) {
+	group_commit.reset();
+	group_commit = std::make_unique<GroupCommitQueue>(database, config);
+}
+
+GroupCommitStats HotelManager::getGroupCommitStats() const {
+	return group_commit ? group_commit->getStats() : GroupCommitStats();
+}
+
+std::future<void> HotelManager::queueRoomStatus(int room_number, const std::string& status) {
+	std::string lowered = toLowerCase(status);
+	// Inside the shared transaction the repository drops its room snapshot; drop
+	// it again after the commit in case another thread reloaded it meanwhile.
+	return enqueue([this, room_number, lowered] { room_repo.updateRoomStatus(room_number, lowered); },
+		[this] { room_repo.invalidateCache(); });
+}
+
+std::future<void> HotelManager::queueCustomerEmail(int customer_id, const std::string& email) {
+	return enqueue([this, customer_id, email] { customer_repo.updateCustomerEmail(customer_id, email); }, nullptr);
+}
+
+std::future<void> HotelManager::queueBookingStatus(int booking_id, const std::string& status) {
+	std::string lowered = toLowerCase(status);
+	return enqueue([this, booking_id, lowered] { booking_repo.updateBookingStatus(booking_id, lowered); }, nullptr);
 }
 
 void HotelManager::updateBookingDates(int booking_id, const DateTime& check_in, const DateTime& check_out) {
-	validateBookingExists(booking_id);
-	return booking_repo.updateBookingDates(booking_id, check_in, check_out);
+	booking_repo.updateBookingDates(booking_id, check_in, check_out);
+	unit_of_work.forgetBooking(booking_id);
 }
 
 std::unique_ptr<Room> HotelManager::addStandardRoom(const std::string& status, double price) {
 
-	int room_number= room_repo.addStandardRoom(StandardRoom(-1,price, status));
-	return room_repo.getRoomByNumber(room_number);
+	return room_repo.addRoom(StandardRoom(-1,price, status));
 }
 
 std::unique_ptr<Room> HotelManager::addDeluxeRoom(const std::string& status, double price, double extra_fees) {
-	int room_number= room_repo.addDeluxeRoom(DeluxeRoom(-1, price,status, extra_fees));
-	return getRoomByNumber(room_number);
+	return room_repo.addRoom(DeluxeRoom(-1, price,status, extra_fees));
 }
 
 std::unique_ptr<Room>HotelManager::addSuite(const std::string& status, double price, bool has_jacuzzi, double jacuzzi_cost) {
-	int room_number=room_repo.addSuite(Suite(-1, price, status, has_jacuzzi, jacuzzi_cost));
-	return getRoomByNumber(room_number);
+	return room_repo.addRoom(Suite(-1, price, status, has_jacuzzi, jacuzzi_cost));
 }
 
 Customer HotelManager::addNewCustomer(const std::string& name, int age, const std::string& phone, const std::string& email) {
-	int customer_id= customer_repo.addCustomerAndGetId(Customer(-1,name, age, phone, email));
-	return getCustomerById(customer_id);
+	return customer_repo.addCustomer(Customer(-1,name, age, phone, email));
 }
 
 Booking HotelManager::addNewBooking(const DateTime& check_in, const DateTime& check_out, int customer_id, int room_number,const std::string&status) {
-	validateRoomExists(room_number);
-	validateCustomerExists(customer_id);
-	if (!isRoomAvailableForDate(room_number, check_in, check_out, -1)) {
+	UnitOfWork::Scope scope(unit_of_work);
+
+	// The conflict check and the insert share one transaction. Locking the room
+	// row first makes concurrent bookings of the room, from any client, wait for
+	// each other; inside the transaction the room and the overlapping bookings are
+	// read from the tables, not from the room cache or the interval index, so a
+	// booking committed by another client a moment ago is seen. The customer row
+	// is share-locked so it cannot be deleted before the booking is committed.
+	ScopedTransaction transaction(database);
+	customer_repo.lockCustomerForShare(customer_id);
+	// Forgotten first so an unlocked copy read earlier in the operation is not reused.
+	unit_of_work.forgetRoom(room_number);
+	auto room = unit_of_work.findRoom(room_number, [&] { return room_repo.lockRoomByNumber(room_number); });
+	if (!room) {
+		throw std::runtime_error("Database Error: Room " + std::to_string(room_number) + " doesn't exist!");
+	}
+	if (room->getStatus() != "available" || booking_repo.hasOverlappingBooking(room_number, check_in, check_out, -1)) {
 		throw std::runtime_error("Error: Room is not available for those dates!");
 	}
 
-	auto room = getRoomByNumber(room_number);
 	int days = check_out - check_in;
 	double cost = room->getTotalPrice() * days;
-	int booking_id= booking_repo.addBookingAndGetId(Booking(-1, room_number, customer_id,cost , check_in, check_out,status));
-
-	return getBookingById(booking_id);
+	Booking stored = booking_repo.addBooking(Booking(-1, room_number, customer_id,cost , check_in, check_out,status));
+	transaction.commit();
+	return stored;
 }
 
 void HotelManager::deleteRoom(int room_number) {
 	 room_repo.deleteRoom(room_number);
+	 unit_of_work.forgetRoom(room_number);
 }
 
 void HotelManager::deleteCustomer(int customer_id) {
-	validateCustomerExists(customer_id);
     // Check active bookings in DB instead of in-memory manager
-    auto bookings = booking_repo.getAllBookings();
-    for (const auto& b : bookings) {
-		if (b.getCustomerId() == customer_id) {
-			throw std::runtime_error("Error: Can't delete customer with active bookings!");
-		}
+    if (!booking_repo.getBookingsByCustomer(customer_id).empty()) {
+		throw std::runtime_error("Error: Can't delete customer with active bookings!");
     }
     customer_repo.deleteCustomer(customer_id);
+	unit_of_work.forgetCustomer(customer_id);
 }
 
 void HotelManager::deleteBooking(int booking_id) {
-	validateBookingExists(booking_id);
 	 booking_repo.deleteBooking(booking_id);
+	 unit_of_work.forgetBooking(booking_id);
 }
@@ -7,9 +7,12 @@
 #include "CustomerRepository.h"
 #include "BookingRepository.h"
 #include "IDatabase.h"
+#include "UnitOfWork.h"
+#include "GroupCommitQueue.h"
 #include <vector>
 #include <optional>
 #include <memory>
+#include <future>
 /**
 	* @class HotelManager
 	* @brief Central management class that coordinates all hotel operations and subsystems.
@@ -21,18 +24,63 @@
 	* and customer-room relationships.
 	*/
 class HotelManager {
+	IDatabase& database; ///< Database the repositories share; group commits run on it.
 	RoomRepository room_repo;
 	BookingRepository booking_repo;
 	CustomerRepository  customer_repo;
-    
+	mutable UnitOfWork unit_of_work; ///< Entities already read by the operation in progress.
+	std::unique_ptr<GroupCommitQueue> group_commit; ///< Write-behind queue; nullptr until enableGroupCommit(). Declared last so it drains before the repositories go away.
+
+	/**
+	 * @brief Looks up a room through the identity map of the current operation.
+	 * @param room_number Room number.
+	 * @return UnitOfWork::RoomEntry The room, or nullptr if it does not exist.
+	 */
+	UnitOfWork::RoomEntry lookupRoom(int room_number) const;
+
+	/**
+	 * @brief Looks up a customer through the identity map of the current operation.
+	 * @param customer_id Customer id.
+	 * @return UnitOfWork::CustomerEntry The customer, or std::nullopt if it does not exist.
+	 */
+	UnitOfWork::CustomerEntry lookupCustomer(int customer_id) const;
+
+	/**
+	 * @brief Looks up a booking through the identity map of the current operation.
+	 * @param booking_id Booking id.
+	 * @return UnitOfWork::BookingEntry The booking, or std::nullopt if it does not exist.
+	 */
+	UnitOfWork::BookingEntry lookupBooking(int booking_id) const;
+
+	/**
+	 * @brief Hands a mutation to the group-commit queue, or commits it right away when there is none.
+	 * @param apply Mutation writing through the repositories.
+	 * @param committed Callback run after a queued commit; may be nullptr. Not needed without a
+	 * queue, where the repositories update their caches in place outside a transaction.
+	 * @return std::future<void> Ready once the mutation is committed.
+	 */
+	std::future<void> enqueue(GroupCommitQueue::Mutation apply, GroupCommitQueue::Mutation committed);
+
 public:
 	/**
 	 * @brief Default constructor.
+	 * @param db Database adapter shared by the repositories.
+	 * @param room_cache_staleness Maximum age of the cached room inventory; zero disables the cache.
+	 * @param booking_index_staleness Maximum age of the booking interval index; zero disables the index.
+	 */
+	HotelManager(IDatabase&db, std::chrono::milliseconds room_cache_staleness = RoomRepository::DEFAULT_CACHE_STALENESS,
+		std::chrono::milliseconds booking_index_staleness = BookingRepository::DEFAULT_INDEX_STALENESS);
+
+	/**
+	 * @brief Gets the room cache counters.
+	 * @return RoomCacheStats Hits, misses, loads and invalidations of the room cache.
 	 */
-	HotelManager(IDatabase&db);
+	RoomCacheStats getRoomCacheStats() const;
 
 	/**
 	 * @brief Validates that a room exists.
+	 * @details Always checked against the rooms table, not the room cache or the
+	 * identity map, since it guards writes; inside a transaction it locks the row.
 	 * @param room_number The room number to validate.
 	 * @return bool True if room exists.
 	 * @throws invalid_argument If room doesn't exist.
@@ -57,6 +105,9 @@ public:
 
 	/**
 	 * @brief Checks if a room is available for given dates.
+	 * @details For screens only: outside a transaction the answer may come from the
+	 * booking interval index, which can miss other clients' bookings for up to the
+	 * index staleness. addNewBooking() repeats the check against the tables.
 	 * @param room_number The room number to check.
 	 * @param check_in Check-in date.
 	 * @param check_out Check-out date.
@@ -68,12 +119,22 @@ public:
 
 	/**
 	 * @brief Gets all available rooms for given dates.
+	 * @details Built from the room cache and the booking interval index when they
+	 * are enabled, so bookings and room changes made by other clients can be
+	 * missing for up to getAvailabilityStaleness(). Booking a listed room is safe:
+	 * addNewBooking() checks it again against the tables.
 	 * @param check_in Check-in date.
 	 * @param check_out Check-out date.
 	 * @return vector<Room> List of available rooms.
 	 */
 	std::vector<std::unique_ptr<Room>> getAvailableRooms(const DateTime& check_in, const DateTime& check_out) const;
 
+	/**
+	 * @brief How far getAvailableRooms() may lag behind other clients' changes.
+	 * @return std::chrono::milliseconds Larger of the room cache and booking index bounds; zero when it always queries.
+	 */
+	std::chrono::milliseconds getAvailabilityStaleness() const;
+
 	/**
 	 * @brief Gets a room by its number.
 	 * @param room_num The room number.
@@ -127,6 +188,24 @@ public:
 	 */
 	std::vector<Booking> getAllBookings() const;
 
+	/**
+	 * @brief Streams all rooms without loading them all in memory.
+	 * @return RowCursor<std::unique_ptr<Room>> Single-pass range over every room.
+	 */
+	RowCursor<std::unique_ptr<Room>> streamAllRooms() const;
+
+	/**
+	 * @brief Streams all customers without loading them all in memory.
+	 * @return RowCursor<Customer> Single-pass range over every customer.
+	 */
+	RowCursor<Customer> streamAllCustomers() const;
+
+	/**
+	 * @brief Streams all bookings without loading them all in memory.
+	 * @return RowCursor<Booking> Single-pass range over every booking.
+	 */
+	RowCursor<Booking> streamAllBookings() const;
+
 	/**
 	 * @brief Updates room price.
 	 * @param room_number Room number.
@@ -177,6 +256,47 @@ public:
 	 */
 	void updateBookingDates(int booking_id, const DateTime& check_in, const DateTime& check_out);
 
+	/**
+	 * @brief Starts grouping queued status and e-mail updates into shared transactions.
+	 * @details Only the queue*() methods use the group-commit queue; the update*()
+	 * methods keep committing on their own. Calling it again drains the current
+	 * queue and starts one with the new bounds.
+	 * @param config Batching window and size.
+	 */
+	void enableGroupCommit(GroupCommitConfig config = GroupCommitConfig());
+
+	/**
+	 * @brief Gets the group-commit counters.
+	 * @return GroupCommitStats Counters of the queue; all zero if group commit is not enabled.
+	 */
+	GroupCommitStats getGroupCommitStats() const;
+
+	/**
+	 * @brief Queues a room status update.
+	 * @details Commits in a shared transaction when group commit is enabled,
+	 * right away otherwise.
+	 * @param room_number Room number.
+	 * @param status New room status.
+	 * @return std::future<void> Ready once the update is committed; rethrows its error from get().
+	 */
+	std::future<void> queueRoomStatus(int room_number, const std::string& status);
+
+	/**
+	 * @brief Queues a customer e-mail update.
+	 * @param customer_id Customer ID.
+	 * @param email New email address.
+	 * @return std::future<void> Ready once the update is committed; rethrows its error from get().
+	 */
+	std::future<void> queueCustomerEmail(int customer_id, const std::string& email);
+
+	/**
+	 * @brief Queues a booking status update, e.g. for a check-out.
+	 * @param booking_id Booking ID.
+	 * @param status New booking status.
+	 * @return std::future<void> Ready once the update is committed; rethrows its error from get().
+	 */
+	std::future<void> queueBookingStatus(int booking_id, const std::string& status);
+
 	/**
 	 * @brief Adds a standard room to hotel inventory.
 	 * @details Delegates room creation to RoomsManager.
@@ -218,6 +338,9 @@ public:
 
 	/**
 	 * @brief Adds a new booking.
+	 * @details Locks the room row, checks the room and its overlapping bookings in
+	 * the tables and inserts, all in one transaction, so two clients cannot book
+	 * the same room for overlapping nights.
 	 * @param date Booking date string.
 	 * @param days Number of days to stay.
 	 * @param customer_id Customer ID.
@@ -3,7 +3,8 @@
 #include <iostream>
 #include "HotelSystem.h"
 #include "HelperFunctions.h"
-#include "MySQLDatabase.h"
+#include "MySQLConnectionPool.h"
+#include "SchemaMigrator.h"
 // Private Functions Definition
 HotelUI& HotelSystem::getHotelUI() {
 	return hotel_ui;
@@ -125,15 +126,22 @@ void HotelSystem::showBookingManagementMenu() {
 	}
 }
 
+void HotelSystem::showQueryStatistics() {
+	std::cout << "\n";
+	instrumented_database.getProfiler().report(std::cout);
+}
+
 void HotelSystem::showAdminMenu() {
 	std::vector<std::string> menu_items = {
 		"Rooms Management",
+		"Query Statistics",
 		"Back to Main Menu" };
 	while (true) {
 		int choice = showOuterReadMenu("ADMIN MENU", menu_items);
 		switch (choice) {
 		case 1:showAdminRoomManagement(); break;
-		case 2:return;
+		case 2:showQueryStatistics(); break;
+		case 3:return;
 		}
 	}
 }
@@ -196,8 +204,24 @@ void HotelSystem::showMainMenu() {
 }
 
 //Constructors Definition
-HotelSystem::HotelSystem(const DatabaseConfig&config) :database(),hotel_manager(database), hotel_ui(hotel_manager) {
-	database.connect(config);
+HotelSystem::HotelSystem(const DatabaseConfig&config, const std::string& profile_path, const std::string& trace_path) :database(),
+	recording(trace_path.empty() ? nullptr : std::make_unique<RecordingDatabase>(database, trace_path)),
+	instrumented_database(recording ? static_cast<IDatabase&>(*recording) : database),
+	profile_path(profile_path), hotel_manager(instrumented_database), hotel_ui(hotel_manager) {
+	database.setSlowQueryLog(std::make_shared<SlowQueryLog>());
+	if (recording) {
+		// Replay matches executions by their parameters, so they cannot be redacted like the slow query log's.
+		std::cout << "Recording this session to " << trace_path
+			<< ". The trace contains customer data (names, phone numbers, e-mail addresses) unredacted; handle it like a database dump.\n";
+	}
+	instrumented_database.connect(config);
+	SchemaMigrator(instrumented_database).migrate(std::cout);
+}
+
+HotelSystem::~HotelSystem() {
+	if (!profile_path.empty() && !instrumented_database.getProfiler().writeReport(profile_path)) {
+		std::cerr << "Could not write the query profile to " << profile_path << "\n";
+	}
 }
 // Public Functions Definition
 void HotelSystem::run() {
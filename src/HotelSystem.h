@@ -3,7 +3,10 @@
 #include<string>
 #include "HotelManager.h"
 #include "HotelUI.h"
-#include "MySQLDatabase.h"
+#include "MySQLConnectionPool.h"
+#include "InstrumentedDatabase.h"
+#include "RecordingDatabase.h"
+#include <memory>
 /**
   * @class HotelSystem
   * @brief Main system class that coordinates the entire hotel management application.
@@ -14,7 +17,10 @@
   * for administrators and receptionists.
   */
 class HotelSystem {
-	MySQLDatabase database;
+	MySQLConnectionPool database;  ///< Pooled database adapter shared by all repositories.
+	std::unique_ptr<RecordingDatabase> recording; ///< Writes the session, customer data included, to a trace file; null unless requested.
+	InstrumentedDatabase instrumented_database; ///< Times every statement sent to database.
+	std::string profile_path;      ///< File the query profile is written to on exit; empty to skip.
 	HotelManager hotel_manager;    ///< Manages all hotel business logic and data.
 	HotelUI hotel_ui;              ///< Handles user interface and presentation layer.
 
@@ -50,6 +56,11 @@ class HotelSystem {
 	 */
 	void showBookingManagementMenu();
 
+	/**
+	 * @brief Prints the query latency profile collected so far.
+	 */
+	void showQueryStatistics();
+
 	/**
 	 * @brief Displays admin main menu.
 	 */
@@ -76,8 +87,20 @@ class HotelSystem {
 public:
 	/**
 	 * @brief Constructor.
+	 * @param config Database connection parameters.
+	 * @param profile_path File the query profile is written to on exit; empty to skip.
+	 * @param trace_path File the session is recorded to for ReplayDatabase; empty to skip.
+	 *        The trace holds bound parameters and result rows unredacted, so
+	 *        customers' names, phone numbers and e-mail addresses end up in it:
+	 *        treat it like a database dump. A warning naming the file is
+	 *        printed when recording starts.
+	 */
+	HotelSystem(const DatabaseConfig& config, const std::string& profile_path = "QueryProfile.txt", const std::string& trace_path = "");
+
+	/**
+	 * @brief Destructor. Writes the query profile to profile_path.
 	 */
-	HotelSystem(const DatabaseConfig& config);
+	~HotelSystem();
 
 	/** 
 	 * @brief Runs the hotel management system.
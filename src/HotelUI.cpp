@@ -2,6 +2,7 @@
 #include <string>
 #include <iostream>
 #include <optional>
+#include <chrono>
 #include "HotelUI.h"
 #include "HelperFunctions.h"
 // Private Functions Definition
@@ -28,6 +29,11 @@ void HotelUI::printAvailableRoomsUI(const DateTime& chin, const DateTime& chout)
 	for (const auto& room : available_rooms) {
 		room->printRoomInfo();
 	}
+	auto staleness = std::chrono::duration_cast<std::chrono::seconds>(getHotelManager().getAvailabilityStaleness());
+	if (staleness.count() > 0) {
+		std::cout << "\n(Changes made on other terminals in the last " << staleness.count()
+			<< " seconds may not be shown; the room is checked again when you book it.)\n";
+	}
 	std::cout << '\n';
 }
 void HotelUI::printRoomsByStatusUI()const {
@@ -53,15 +59,15 @@ void HotelUI::printRoomsByTypeUI()const {
 void HotelUI::printAllRoomsUI() const {
 	std::cout << "\n\t\t=== All Rooms ===\n\n";
 
-	auto rooms = getHotelManager().getAllRooms();
-	printRooms(rooms);
+	for (const auto& room : getHotelManager().streamAllRooms()) {
+		room->printRoomInfo();
+	}
 }
 
 void HotelUI::printAllCustomersUI() const {
 	std::cout << "\n\t\t=== All Customers ===\n\n";
 
-	auto customers = getHotelManager().getAllCustomers();
-	for (const auto& customer : customers) {
+	for (const auto& customer : getHotelManager().streamAllCustomers()) {
 		customer.printCustomerInfo();
 	}
 }
@@ -69,8 +75,7 @@ void HotelUI::printAllCustomersUI() const {
 void HotelUI::printAllBookingsUI() const {
 	std::cout << "\n\t\t=== All Bookings ===\n\n";
 
-	auto bookings = getHotelManager().getAllBookings();
-	for (const auto& booking : bookings) {
+	for (const auto& booking : getHotelManager().streamAllBookings()) {
 		booking.printBookingInfo();
 	}
 }
@@ -33,6 +33,8 @@ public:
 
 	/**
 	 * @brief Displays available rooms for given dates.
+	 * @details Notes how long other terminals' changes may take to show when the
+	 * list comes from the room cache and the booking index.
 	 * @param chin Check-in date.
 	 * @param chout Check-out date.
 	 */
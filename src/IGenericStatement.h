@@ -2,6 +2,7 @@
 #include "IGenericResultSet.h"
 #include <memory>
 #include <string>
+#include <vector>
 
 /**
  * @file IGenericStatement.h
@@ -54,6 +55,17 @@ public:
      */
     virtual int executeUpdate() = 0;
 
+    /**
+     * @brief Execute a single-row INSERT and return the key it generated.
+     *
+     * The key is read on the statement's own session, so no transaction or
+     * separate IDatabase::getLastInsertID() call is needed.
+     *
+     * @return int Auto-increment key of the inserted row.
+     * @throws std::runtime_error if the insert generated no key.
+     */
+    virtual int executeInsert() = 0;
+
     /**
      * @brief Execute a query and obtain a result set.
      * @return std::unique_ptr<IGenericResultSet> Owned result set object.
@@ -64,4 +76,29 @@ public:
      * @brief Clear all previously bound parameters so the statement can be reused.
      */
     virtual void clearParameters() = 0;
+
+    /**
+     * @brief Queue the currently bound parameters as one row of a batch.
+     *
+     * The parameters stay bound, so only the values that change between rows
+     * need to be set again before the next addBatch().
+     */
+    virtual void addBatch() = 0;
+
+    /**
+     * @brief Execute every queued row, then empty the batch and clear the parameters.
+     *
+     * Implementations may send several rows per round trip. The batch is not
+     * atomic on its own; run it inside a transaction when partial writes must
+     * not be visible.
+     *
+     * @return int Total number of rows affected.
+     */
+    virtual int executeBatch() = 0;
+
+    /**
+     * @brief Auto-increment keys generated by the last executeInsert() or executeBatch().
+     * @return std::vector<int> One key per inserted row, in batch order; empty for non-inserts.
+     */
+    virtual std::vector<int> getGeneratedKeys() const = 0;
 };
@@ -0,0 +1,143 @@
+#include "InMemoryDatabase.h"
+#include <stdexcept>
+
+const std::string& InMemoryDatabase::defaultSchema() {
+    // Keep in sync with init-db/init.sql; later changes arrive through SchemaMigrator.
+    static const std::string schema = R"SQL(
+CREATE TABLE IF NOT EXISTS `rooms` (
+  `room_number` int NOT NULL AUTO_INCREMENT,
+  `room_type` enum('standard','deluxe','suite') NOT NULL,
+  `status` varchar(50) DEFAULT 'available',
+  `base_price` decimal(10,2) NOT NULL,
+  `extra_fees` decimal(10,2) DEFAULT '0.00',
+  `has_jacuzzi` tinyint(1) DEFAULT '0',
+  `jacuzzi_cost` decimal(10,2) DEFAULT '0.00',
+  `created_at` timestamp NULL DEFAULT CURRENT_TIMESTAMP,
+  PRIMARY KEY (`room_number`)
+) ENGINE=InnoDB AUTO_INCREMENT=7 DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_0900_ai_ci;
+
+CREATE TABLE IF NOT EXISTS `customers` (
+  `customer_id` int NOT NULL AUTO_INCREMENT,
+  `age` int NOT NULL,
+  `name` varchar(100) NOT NULL,
+  `phone_number` varchar(20) NOT NULL,
+  `email` varchar(100) NOT NULL,
+  PRIMARY KEY (`customer_id`),
+  UNIQUE KEY `phone_number` (`phone_number`),
+  UNIQUE KEY `email` (`email`),
+  CONSTRAINT `chk_age` CHECK (((`age` >= 0) and (`age` <= 120))),
+  CONSTRAINT `chk_email` CHECK (regexp_like(`email`,_utf8mb4'^[A-Za-z0-9_]+@[A-Za-z0-9_]+.[A-Za-z0-9_]+$')),
+  CONSTRAINT `chk_phone` CHECK (((length(`phone_number`) between 8 and 15) and regexp_like(`phone_number`,_utf8mb4'^[+]?[0-9]+$')))
+) ENGINE=InnoDB AUTO_INCREMENT=4 DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_0900_ai_ci;
+
+CREATE TABLE IF NOT EXISTS `bookings` (
+  `booking_id` int NOT NULL AUTO_INCREMENT,
+  `room_number` int NOT NULL,
+  `customer_id` int NOT NULL,
+  `check_in` datetime NOT NULL,
+  `check_out` datetime NOT NULL,
+  `cost` decimal(10,2) NOT NULL,
+  `status` varchar(20) NOT NULL,
+  PRIMARY KEY (`booking_id`),
+  KEY `idx_bookings_room_dates` (`room_number`,`check_in`,`check_out`),
+  KEY `idx_bookings_customer` (`customer_id`),
+  KEY `idx_bookings_dates` (`check_out`,`check_in`),
+  CONSTRAINT `chk_cost` CHECK ((`cost` >= 0)),
+  CONSTRAINT `chk_dates` CHECK ((`check_in` < `check_out`)),
+  CONSTRAINT `chk_status` CHECK ((`status` in (_utf8mb4'pending',_utf8mb4'done',_utf8mb4'cancelled')))
+) ENGINE=InnoDB AUTO_INCREMENT=7 DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_0900_ai_ci;
+)SQL";
+    return schema;
+}
+
+InMemoryDatabase::InMemoryDatabase(std::string schema_script)
+    : schema_script(std::move(schema_script)), connected(false) {}
+
+sql::Connection* InMemoryDatabase::getConnection() { return nullptr; }
+
+InMemoryEngine& InMemoryDatabase::requireEngine() const {
+    if (!connected) {
+        throw std::runtime_error("Database Error: in-memory database not connected! Call connect() first.");
+    }
+    return *engine;
+}
+
+void InMemoryDatabase::disconnect() {
+    if (engine && engine->isTransactionActive()) {
+        engine->rollbackTransaction();
+    }
+    connected = false;
+}
+
+void InMemoryDatabase::connect(const DatabaseConfig& config) {
+    try {
+        if (!engine) {
+            auto created = std::make_unique<InMemoryEngine>(config.getSchema());
+            created->executeScript(schema_script);
+            engine = std::move(created);
+        }
+        connected = true;
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Database Error: Connection failed: " + std::string(e.what()));
+    }
+}
+
+std::unique_ptr<IGenericStatement> InMemoryDatabase::prepareStatement(const std::string& query) {
+    InMemoryEngine& database = requireEngine();
+    return std::make_unique<InMemoryStatement>(database, database.prepare(query));
+}
+
+bool InMemoryDatabase::isConnected() const { return connected; }
+
+std::string InMemoryDatabase::getType() const { return "InMemory"; }
+
+void InMemoryDatabase::beginTransaction() {
+    if (!connected) {
+        throw std::runtime_error("Cannot begin transaction: not connected to database");
+    }
+    engine->beginTransaction();
+}
+
+void InMemoryDatabase::commitTransaction() {
+    if (!engine) {
+        throw std::runtime_error("No active transaction to commit");
+    }
+    engine->commitTransaction();
+}
+
+void InMemoryDatabase::rollbackTransaction() {
+    if (!engine) {
+        throw std::runtime_error("No active transaction to rollback");
+    }
+    engine->rollbackTransaction();
+}
+
+bool InMemoryDatabase::isTransactionActive() { return engine && engine->isTransactionActive(); }
+
+std::string InMemoryDatabase::getTransactionIsolationLevel() const {
+    if (!connected) {
+        throw std::runtime_error("Not connected to database");
+    }
+    return engine->getIsolationLevel();
+}
+
+void InMemoryDatabase::setTransactionIsolationLevel(const std::string& level) {
+    if (!connected) {
+        throw std::runtime_error("Not connected to database");
+    }
+    try {
+        engine->setIsolationLevel(level);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Failed to set isolation level '" + level + "': " + std::string(e.what()));
+    }
+}
+
+int InMemoryDatabase::getLastInsertID() {
+    return static_cast<int>(requireEngine().getLastInsertId());
+}
+
+InMemoryDatabase::~InMemoryDatabase() {
+    disconnect();
+}
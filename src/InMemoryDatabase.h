@@ -0,0 +1,99 @@
+#pragma once
+#include "IDatabase.h"
+#include "InMemoryEngine.h"
+#include "InMemoryStatement.h"
+#include <memory>
+#include <string>
+#include "DatabaseConfig.h"
+
+/**
+ * @file InMemoryDatabase.h
+ * @brief In-process implementation of the IDatabase adapter.
+ *
+ * InMemoryDatabase runs the repositories' SQL on an InMemoryEngine instead
+ * of a MySQL server, so HotelManager and the repositories can be exercised
+ * and benchmarked without docker-compose and without network latency in the
+ * measurements:
+ * @code
+ * InMemoryDatabase database;
+ * database.connect(DatabaseConfig("hotelmanagement", "", "", ""));
+ * HotelManager manager(database);
+ * @endcode
+ * The first connect() creates the schema from a DDL script, by default the
+ * tables of init-db/init.sql; SchemaMigrator then runs against it like
+ * against MySQL. Data lives as long as the InMemoryDatabase object, across
+ * disconnects. Only the server, username and password of the configuration
+ * are ignored.
+ */
+class InMemoryDatabase : public IDatabase {
+private:
+    std::string schema_script;               ///< DDL run on the first connect().
+    std::unique_ptr<InMemoryEngine> engine;  ///< Created by the first connect().
+    bool connected;
+
+    /**
+     * @brief No driver connection exists.
+     * @return sql::Connection* Always nullptr.
+     */
+    sql::Connection* getConnection() override;
+
+    /**
+     * @brief Get the engine, requiring a connection.
+     * @return InMemoryEngine& Engine.
+     * @throws std::runtime_error when not connected.
+     */
+    InMemoryEngine& requireEngine() const;
+
+protected:
+    /**
+     * @brief Mark the database disconnected, rolling back an open transaction.
+     */
+    void disconnect() override;
+
+public:
+    /**
+     * @brief Tables of init-db/init.sql (rooms, customers, bookings).
+     * @return const std::string& DDL script.
+     */
+    static const std::string& defaultSchema();
+
+    /**
+     * @brief Create a database that is not connected yet.
+     * @param schema_script `;` separated CREATE statements run on the first connect().
+     */
+    explicit InMemoryDatabase(std::string schema_script = defaultSchema());
+
+    /**
+     * @brief Create the schema on first use and mark the database connected.
+     * @param config Configuration; only the schema name is used.
+     */
+    void connect(const DatabaseConfig& config) override;
+
+    /**
+     * @brief Parse a SQL statement, reusing the parse of identical SQL text.
+     * @param query SQL query string to prepare.
+     * @return std::unique_ptr<IGenericStatement> Statement with no bound parameters.
+     * @throws std::runtime_error on syntax errors or unknown tables and columns.
+     */
+    std::unique_ptr<IGenericStatement> prepareStatement(const std::string& query) override;
+
+    bool isConnected() const override;
+
+    /**
+     * @brief Return a human-friendly name for this implementation.
+     * @return std::string "InMemory".
+     */
+    std::string getType() const override;
+    void beginTransaction() override;
+    void commitTransaction() override;
+    void rollbackTransaction() override;
+    bool isTransactionActive() override;
+    std::string getTransactionIsolationLevel() const override;
+    void setTransactionIsolationLevel(const std::string& level) override;
+    int getLastInsertID() override;
+
+    /**
+     * @brief Destructor.
+     */
+    ~InMemoryDatabase();
+};
@@ -0,0 +1,2499 @@
+#include "InMemoryEngine.h"
+#include "DateTime.h"
+#include "DateTimeCodec.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <optional>
+#include <regex>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+    using Row = std::vector<SqlValue>;
+
+    // Text helpers
+    char lowerChar(char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    std::string toLower(std::string text) {
+        for (char& c : text) {
+            c = lowerChar(c);
+        }
+        return text;
+    }
+
+    std::string toUpper(std::string text) {
+        for (char& c : text) {
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+        return text;
+    }
+
+    bool equalsIgnoreCase(const std::string& a, const std::string& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (lowerChar(a[i]) != lowerChar(b[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int compareIgnoreCase(const std::string& a, const std::string& b) {
+        std::size_t length = std::min(a.size(), b.size());
+        for (std::size_t i = 0; i < length; ++i) {
+            unsigned char x = static_cast<unsigned char>(lowerChar(a[i]));
+            unsigned char y = static_cast<unsigned char>(lowerChar(b[i]));
+            if (x != y) {
+                return x < y ? -1 : 1;
+            }
+        }
+        return a.size() == b.size() ? 0 : (a.size() < b.size() ? -1 : 1);
+    }
+
+    std::size_t characterCount(const std::string& text) {
+        std::size_t count = 0;
+        for (char c : text) {
+            count += (static_cast<unsigned char>(c) & 0xC0) != 0x80 ? 1 : 0; // UTF-8 continuation bytes do not start a character
+        }
+        return count;
+    }
+
+    // Value helpers
+    bool isNull(const SqlValue& value) {
+        return std::holds_alternative<std::monostate>(value);
+    }
+
+    double toDouble(const SqlValue& value) {
+        if (const auto* integer = std::get_if<long long>(&value)) {
+            return static_cast<double>(*integer);
+        }
+        if (const auto* real = std::get_if<double>(&value)) {
+            return *real;
+        }
+        if (const auto* text = std::get_if<std::string>(&value)) {
+            return std::strtod(text->c_str(), nullptr);
+        }
+        return 0;
+    }
+
+    long long toInteger(const SqlValue& value) {
+        if (const auto* integer = std::get_if<long long>(&value)) {
+            return *integer;
+        }
+        return std::llround(toDouble(value));
+    }
+
+    std::string formatDouble(double value, int scale) {
+        char buffer[64];
+        if (scale >= 0) {
+            std::snprintf(buffer, sizeof(buffer), "%.*f", scale, value);
+        }
+        else {
+            std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+        }
+        return buffer;
+    }
+
+    std::string toText(const SqlValue& value, int scale = -1) {
+        if (const auto* text = std::get_if<std::string>(&value)) {
+            return *text;
+        }
+        if (const auto* integer = std::get_if<long long>(&value)) {
+            return std::to_string(*integer);
+        }
+        if (const auto* real = std::get_if<double>(&value)) {
+            return formatDouble(*real, scale);
+        }
+        return "NULL";
+    }
+
+    // Orders two non-NULL values: numbers numerically, text ignoring case, mixed pairs as numbers.
+    int compareValues(const SqlValue& a, const SqlValue& b) {
+        const auto* text_a = std::get_if<std::string>(&a);
+        const auto* text_b = std::get_if<std::string>(&b);
+        if (text_a && text_b) {
+            return compareIgnoreCase(*text_a, *text_b);
+        }
+        const auto* integer_a = std::get_if<long long>(&a);
+        const auto* integer_b = std::get_if<long long>(&b);
+        if (integer_a && integer_b) {
+            return (*integer_a > *integer_b) - (*integer_a < *integer_b);
+        }
+        double x = toDouble(a);
+        double y = toDouble(b);
+        return (x > y) - (x < y);
+    }
+
+    // Orders two values with NULL first.
+    int compareNullable(const SqlValue& a, const SqlValue& b) {
+        bool null_a = isNull(a);
+        bool null_b = isNull(b);
+        if (null_a || null_b) {
+            return null_b - null_a;
+        }
+        return compareValues(a, b);
+    }
+
+    // Total order of index keys: shorter prefixes sort before their extensions.
+    struct KeyLess {
+        bool operator()(const Row& a, const Row& b) const {
+            std::size_t length = std::min(a.size(), b.size());
+            for (std::size_t i = 0; i < length; ++i) {
+                int order = compareNullable(a[i], b[i]);
+                if (order != 0) {
+                    return order < 0;
+                }
+            }
+            return a.size() < b.size();
+        }
+    };
+
+    bool hasPrefix(const Row& key, const Row& prefix) {
+        if (key.size() < prefix.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < prefix.size(); ++i) {
+            if (compareNullable(key[i], prefix[i]) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool normalizeDateTime(const std::string& text, bool date_only, std::string& normalized) {
+        std::tm fields = {};
+        if (!parseDateTimeFields(text.data(), text.size(), fields)) {
+            return false;
+        }
+        char buffer[DATE_TIME_BUFFER_SIZE];
+        std::size_t length = date_only ? formatDateFields(fields, buffer) : formatDateTimeFields(fields, buffer);
+        normalized.assign(buffer, length);
+        return true;
+    }
+
+    // Tokens
+    enum class TokenKind { Word, Quoted, Number, String, Param, Variable, Symbol, End };
+
+    struct Token {
+        TokenKind kind;
+        std::string text;
+        std::size_t begin;  ///< Offset of the first character in the SQL text.
+        std::size_t end;    ///< Offset past the last character.
+    };
+
+    [[noreturn]] void syntaxError(const std::string& sql, std::size_t offset) {
+        throw std::runtime_error("You have an error in your SQL syntax near '"
+            + sql.substr(std::min(offset, sql.size()), 40) + "'");
+    }
+
+    bool isWordChar(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+    }
+
+    std::vector<Token> tokenize(const std::string& sql) {
+        std::vector<Token> tokens;
+        const std::size_t n = sql.size();
+        std::size_t i = 0;
+        while (i < n) {
+            char c = sql[i];
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                ++i;
+                continue;
+            }
+            if ((c == '-' && i + 1 < n && sql[i + 1] == '-') || c == '#') {
+                while (i < n && sql[i] != '\n') {
+                    ++i;
+                }
+                continue;
+            }
+            if (c == '/' && i + 1 < n && sql[i + 1] == '*') {
+                std::size_t close = sql.find("*/", i + 2);
+                if (close == std::string::npos) {
+                    syntaxError(sql, i);
+                }
+                i = close + 2;
+                continue;
+            }
+            Token token{ TokenKind::Symbol, "", i, i };
+            if (c == '`') {
+                std::size_t close = sql.find('`', i + 1);
+                if (close == std::string::npos) {
+                    syntaxError(sql, i);
+                }
+                token.kind = TokenKind::Quoted;
+                token.text = sql.substr(i + 1, close - i - 1);
+                i = close + 1;
+            }
+            else if (c == '\'' || c == '"') {
+                token.kind = TokenKind::String;
+                ++i;
+                for (;;) {
+                    if (i >= n) {
+                        syntaxError(sql, token.begin);
+                    }
+                    char ch = sql[i++];
+                    if (ch == c) {
+                        if (i < n && sql[i] == c) {
+                            token.text += c;
+                            ++i;
+                            continue;
+                        }
+                        break;
+                    }
+                    if (ch == '\\' && i < n) {
+                        char escaped = sql[i++];
+                        switch (escaped) {
+                        case 'n': token.text += '\n'; break;
+                        case 't': token.text += '\t'; break;
+                        case 'r': token.text += '\r'; break;
+                        case '0': token.text += '\0'; break;
+                        default: token.text += escaped; break;
+                        }
+                        continue;
+                    }
+                    token.text += ch;
+                }
+            }
+            else if (std::isdigit(static_cast<unsigned char>(c)) || (c == '.' && i + 1 < n && std::isdigit(static_cast<unsigned char>(sql[i + 1])))) {
+                token.kind = TokenKind::Number;
+                while (i < n && (std::isdigit(static_cast<unsigned char>(sql[i])) || sql[i] == '.')) {
+                    token.text += sql[i++];
+                }
+            }
+            else if (c == '?') {
+                token.kind = TokenKind::Param;
+                token.text = "?";
+                ++i;
+            }
+            else if (c == '@' && i + 1 < n && sql[i + 1] == '@') {
+                token.kind = TokenKind::Variable;
+                i += 2;
+                while (i < n && (isWordChar(sql[i]) || sql[i] == '.')) {
+                    token.text += sql[i++];
+                }
+                token.text = toLower(token.text);
+                for (const char* scope : { "session.", "global.", "local." }) {
+                    if (token.text.compare(0, std::char_traits<char>::length(scope), scope) == 0) {
+                        token.text.erase(0, std::char_traits<char>::length(scope));
+                    }
+                }
+            }
+            else if (isWordChar(c)) {
+                token.kind = TokenKind::Word;
+                while (i < n && isWordChar(sql[i])) {
+                    token.text += sql[i++];
+                }
+                if (token.text[0] == '_' && i < n && sql[i] == '\'') {
+                    continue; // Character set introducer such as _utf8mb4'...'
+                }
+            }
+            else {
+                static const char* const pairs[] = { "<=", ">=", "<>", "!=" };
+                token.text = std::string(1, c);
+                for (const char* pair : pairs) {
+                    if (sql.compare(i, 2, pair) == 0) {
+                        token.text = pair;
+                        break;
+                    }
+                }
+                if (std::string("(),.=<>*+-;!").find(c) == std::string::npos) {
+                    syntaxError(sql, i);
+                }
+                i += token.text.size();
+            }
+            token.end = i;
+            tokens.push_back(std::move(token));
+        }
+        tokens.push_back(Token{ TokenKind::End, "", n, n });
+        return tokens;
+    }
+
+    // Schema
+    enum class ColumnType { Integer, Decimal, Double, Text, DateTime, Date };
+
+    struct ColumnDef {
+        std::string name;
+        ColumnType type = ColumnType::Text;
+        std::size_t length = 0;                 ///< Maximum characters of CHAR/VARCHAR, 0 when unbounded.
+        int scale = -1;                         ///< Decimal places of DECIMAL.
+        std::vector<std::string> enum_values;   ///< Allowed values of ENUM.
+        bool not_null = false;
+        bool auto_increment = false;
+        bool has_default = false;
+        bool default_now = false;               ///< DEFAULT CURRENT_TIMESTAMP.
+        SqlValue default_value;
+    };
+
+    struct KeyDef {
+        std::string name;
+        std::vector<std::string> columns;
+        bool primary = false;
+        bool unique = false;
+    };
+
+    struct TableDef {
+        std::string name;
+        bool if_not_exists = false;
+        std::vector<ColumnDef> columns;
+        std::vector<KeyDef> keys;
+        std::vector<std::pair<std::string, std::string>> checks;  ///< Enforced CHECK constraints: name and expression text.
+        long long auto_increment = 1;
+    };
+
+    struct Index {
+        std::string name;
+        std::vector<int> columns;
+        bool unique = false;
+        std::set<Row, KeyLess> entries;  ///< Key columns followed by the row id.
+
+        Row keyOf(const Row& row, long long row_id) const {
+            Row key;
+            key.reserve(columns.size() + 1);
+            for (int column : columns) {
+                key.push_back(row[column]);
+            }
+            key.emplace_back(row_id);
+            return key;
+        }
+    };
+
+    struct Expr;
+
+    /**
+     * Rows of one table with its indexes.
+     */
+    struct Table {
+        std::string name;
+        std::vector<ColumnDef> columns;
+        int key_column = -1;              ///< Single integer primary key used as row id, or -1.
+        int auto_column = -1;             ///< AUTO_INCREMENT column, or -1.
+        std::vector<Index> indexes;       ///< Secondary indexes (and a composite primary key).
+        std::vector<std::pair<std::string, std::shared_ptr<const Expr>>> checks;  ///< CHECK constraints resolved against columns.
+        std::map<long long, Row> rows;    ///< Rows by row id.
+        long long next_auto_increment = 1;
+        long long next_row_id = 1;        ///< Hidden row ids of tables without key_column.
+
+        int findColumn(const std::string& column) const {
+            for (std::size_t i = 0; i < columns.size(); ++i) {
+                if (equalsIgnoreCase(columns[i].name, column)) {
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        }
+
+        const Index* findIndex(const std::string& index) const {
+            for (const auto& entry : indexes) {
+                if (equalsIgnoreCase(entry.name, index)) {
+                    return &entry;
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    // Expressions
+    enum class CompareOp { Eq, Ne, Lt, Le, Gt, Ge };
+
+    struct Select;
+
+    struct Expr {
+        enum class Kind { Literal, Param, Column, Variable, Compare, And, Or, Not, In, IsNull, Exists, Function, Aggregate };
+
+        Kind kind = Kind::Literal;
+        SqlValue value;                     ///< Literal value.
+        int param = 0;                      ///< 1-based placeholder index.
+        std::string qualifier;              ///< Table or alias written before a column.
+        std::string name;                   ///< Column name, or lowercase function/variable name.
+        int depth = 0;                      ///< Column: 0 for the innermost table, 1 for the enclosing query...
+        int column = -1;                    ///< Column: index in its table.
+        ColumnType column_type = ColumnType::Text;
+        CompareOp op = CompareOp::Eq;
+        bool negated = false;               ///< NOT IN, IS NOT NULL.
+        bool star = false;                  ///< COUNT(*).
+        bool temporal = false;              ///< Compare against a DATETIME column: normalize text operands.
+        std::vector<std::unique_ptr<Expr>> args;
+        std::unique_ptr<Select> subquery;   ///< EXISTS.
+    };
+
+    using ExprPtr = std::unique_ptr<Expr>;
+
+    ExprPtr makeExpr(Expr::Kind kind) {
+        auto expr = std::make_unique<Expr>();
+        expr->kind = kind;
+        return expr;
+    }
+
+    struct SelectItem {
+        ExprPtr expr;
+        std::string label;
+        bool all_columns = false;
+        int scale = -1;
+    };
+
+    struct OrderItem {
+        ExprPtr expr;
+        bool descending = false;
+    };
+
+    struct Select {
+        bool distinct = false;
+        std::vector<SelectItem> items;
+        std::string table_name;             ///< Empty for SELECT without FROM.
+        std::string alias;
+        Table* table = nullptr;
+        ExprPtr where;
+        std::vector<OrderItem> order;
+        ExprPtr limit;
+        bool aggregate = false;
+        std::vector<std::pair<int, const Expr*>> equalities; ///< `column = value` conjuncts usable for lookups.
+    };
+}
+
+/**
+ * @struct InMemoryQuery
+ * @brief Parsed statement.
+ */
+struct InMemoryQuery {
+    enum class Kind { Select, Insert, Update, Delete, CreateTable, CreateIndex, SetIsolation, Use };
+
+    Kind kind = Kind::Select;
+    std::size_t parameter_count = 0;
+    Select select;                                  ///< SELECT, and the table and WHERE of UPDATE and DELETE.
+    std::vector<int> insert_columns;
+    std::vector<std::vector<ExprPtr>> insert_rows;
+    std::vector<std::pair<int, ExprPtr>> assignments;
+    TableDef table_def;                             ///< CREATE TABLE.
+    KeyDef index_def;                               ///< CREATE INDEX.
+    std::string index_table;
+    std::string isolation_level;
+};
+
+namespace {
+    // Parser
+    class Parser {
+        const std::string& sql;
+        std::vector<Token> tokens;
+        std::size_t pos = 0;
+
+        const Token& peek(std::size_t ahead = 0) const {
+            return tokens[std::min(pos + ahead, tokens.size() - 1)];
+        }
+
+        [[noreturn]] void fail() const {
+            syntaxError(sql, peek().begin);
+        }
+
+        static bool isWord(const Token& token, const char* word) {
+            return token.kind == TokenKind::Word && equalsIgnoreCase(token.text, word);
+        }
+
+        static bool isSymbol(const Token& token, const char* symbol) {
+            return token.kind == TokenKind::Symbol && token.text == symbol;
+        }
+
+        bool acceptWord(const char* word) {
+            if (isWord(peek(), word)) {
+                ++pos;
+                return true;
+            }
+            return false;
+        }
+
+        void expectWord(const char* word) {
+            if (!acceptWord(word)) {
+                fail();
+            }
+        }
+
+        bool acceptSymbol(const char* symbol) {
+            if (isSymbol(peek(), symbol)) {
+                ++pos;
+                return true;
+            }
+            return false;
+        }
+
+        void expectSymbol(const char* symbol) {
+            if (!acceptSymbol(symbol)) {
+                fail();
+            }
+        }
+
+        bool atEnd() const {
+            return peek().kind == TokenKind::End || isSymbol(peek(), ";");
+        }
+
+        std::string identifier() {
+            const Token& token = peek();
+            if (token.kind != TokenKind::Word && token.kind != TokenKind::Quoted) {
+                fail();
+            }
+            ++pos;
+            return token.text;
+        }
+
+        static bool isReserved(const Token& token) {
+            static const char* const reserved[] = { "from", "where", "order", "group", "having", "limit", "for", "lock",
+                "set", "values", "value", "on", "join", "inner", "left", "right", "union", "and", "or", "not", "as",
+                "asc", "desc", "in", "is", "between", "like" };
+            if (token.kind != TokenKind::Word) {
+                return false;
+            }
+            for (const char* word : reserved) {
+                if (equalsIgnoreCase(token.text, word)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::string optionalAlias() {
+            if (acceptWord("AS")) {
+                return identifier();
+            }
+            const Token& token = peek();
+            if ((token.kind == TokenKind::Word && !isReserved(token)) || token.kind == TokenKind::Quoted) {
+                return identifier();
+            }
+            return "";
+        }
+
+        // Table names are case-insensitive; a schema qualifier other than information_schema is dropped.
+        std::string tableName() {
+            std::string name = identifier();
+            if (acceptSymbol(".")) {
+                std::string table = identifier();
+                return equalsIgnoreCase(name, "information_schema") ? "information_schema." + toLower(table) : toLower(table);
+            }
+            return toLower(name);
+        }
+
+        void skipBalanced() {
+            int depth = 0;
+            do {
+                if (peek().kind == TokenKind::End) {
+                    fail();
+                }
+                if (isSymbol(peek(), "(")) {
+                    ++depth;
+                }
+                else if (isSymbol(peek(), ")")) {
+                    --depth;
+                }
+                ++pos;
+            } while (depth > 0);
+        }
+
+        // Skips to the ',' or ')' that ends a definition inside CREATE TABLE.
+        void skipDefinition() {
+            while (!isSymbol(peek(), ",") && !isSymbol(peek(), ")")) {
+                if (peek().kind == TokenKind::End) {
+                    fail();
+                }
+                if (isSymbol(peek(), "(")) {
+                    skipBalanced();
+                }
+                else {
+                    ++pos;
+                }
+            }
+        }
+
+        // Expressions, lowest precedence first
+        ExprPtr parseOr() {
+            ExprPtr left = parseAnd();
+            while (acceptWord("OR")) {
+                ExprPtr node = makeExpr(Expr::Kind::Or);
+                node->args.push_back(std::move(left));
+                node->args.push_back(parseAnd());
+                left = std::move(node);
+            }
+            return left;
+        }
+
+        ExprPtr parseAnd() {
+            ExprPtr left = parseNot();
+            while (acceptWord("AND")) {
+                ExprPtr node = makeExpr(Expr::Kind::And);
+                node->args.push_back(std::move(left));
+                node->args.push_back(parseNot());
+                left = std::move(node);
+            }
+            return left;
+        }
+
+        ExprPtr parseNot() {
+            if (acceptWord("NOT") || acceptSymbol("!")) {
+                ExprPtr node = makeExpr(Expr::Kind::Not);
+                node->args.push_back(parseNot());
+                return node;
+            }
+            return parsePredicate();
+        }
+
+        ExprPtr compare(CompareOp op, ExprPtr left, ExprPtr right) {
+            ExprPtr node = makeExpr(Expr::Kind::Compare);
+            node->op = op;
+            node->args.push_back(std::move(left));
+            node->args.push_back(std::move(right));
+            return node;
+        }
+
+        ExprPtr negate(ExprPtr expr) {
+            ExprPtr node = makeExpr(Expr::Kind::Not);
+            node->args.push_back(std::move(expr));
+            return node;
+        }
+
+        ExprPtr parsePredicate() {
+            if (acceptWord("EXISTS")) {
+                ExprPtr node = makeExpr(Expr::Kind::Exists);
+                expectSymbol("(");
+                node->subquery = std::make_unique<Select>(parseSelect());
+                expectSymbol(")");
+                return node;
+            }
+            ExprPtr left = parsePrimary();
+            static const std::pair<const char*, CompareOp> operators[] = {
+                { "=", CompareOp::Eq }, { "<>", CompareOp::Ne }, { "!=", CompareOp::Ne }, { "<", CompareOp::Lt },
+                { "<=", CompareOp::Le }, { ">", CompareOp::Gt }, { ">=", CompareOp::Ge } };
+            for (const auto& entry : operators) {
+                if (acceptSymbol(entry.first)) {
+                    return compare(entry.second, std::move(left), parsePrimary());
+                }
+            }
+            if (acceptWord("IS")) {
+                ExprPtr node = makeExpr(Expr::Kind::IsNull);
+                node->negated = acceptWord("NOT");
+                expectWord("NULL");
+                node->args.push_back(std::move(left));
+                return node;
+            }
+            bool negated = isWord(peek(), "NOT") && (isWord(peek(1), "IN") || isWord(peek(1), "BETWEEN"));
+            if (negated) {
+                ++pos;
+            }
+            if (acceptWord("IN")) {
+                ExprPtr node = makeExpr(Expr::Kind::In);
+                node->negated = negated;
+                node->args.push_back(std::move(left));
+                expectSymbol("(");
+                do {
+                    node->args.push_back(parsePrimary());
+                } while (acceptSymbol(","));
+                expectSymbol(")");
+                return node;
+            }
+            if (acceptWord("BETWEEN")) {
+                ExprPtr low = parsePrimary();
+                expectWord("AND");
+                ExprPtr high = parsePrimary();
+                ExprPtr copy = cloneOperand(*left);
+                ExprPtr node = makeExpr(Expr::Kind::And);
+                node->args.push_back(compare(CompareOp::Ge, std::move(left), std::move(low)));
+                node->args.push_back(compare(CompareOp::Le, std::move(copy), std::move(high)));
+                return negated ? negate(std::move(node)) : std::move(node);
+            }
+            if (negated) {
+                fail();
+            }
+            return left;
+        }
+
+        // BETWEEN repeats its left operand, such as a column or LENGTH(column); a copy
+        // of a placeholder reads the same parameter. Subqueries are not copied.
+        ExprPtr cloneOperand(const Expr& expr) {
+            if (expr.subquery) {
+                fail();
+            }
+            ExprPtr copy = makeExpr(expr.kind);
+            copy->value = expr.value;
+            copy->param = expr.param;
+            copy->qualifier = expr.qualifier;
+            copy->name = expr.name;
+            copy->op = expr.op;
+            copy->negated = expr.negated;
+            copy->star = expr.star;
+            for (const auto& arg : expr.args) {
+                copy->args.push_back(cloneOperand(*arg));
+            }
+            return copy;
+        }
+
+        ExprPtr parsePrimary() {
+            const Token& token = peek();
+            if (token.kind == TokenKind::Number || (isSymbol(token, "-") && peek(1).kind == TokenKind::Number)) {
+                bool minus = acceptSymbol("-");
+                const std::string& text = peek().text;
+                ExprPtr node = makeExpr(Expr::Kind::Literal);
+                if (text.find('.') == std::string::npos) {
+                    long long value = std::strtoll(text.c_str(), nullptr, 10);
+                    node->value = minus ? -value : value;
+                }
+                else {
+                    double value = std::strtod(text.c_str(), nullptr);
+                    node->value = minus ? -value : value;
+                }
+                ++pos;
+                return node;
+            }
+            if (token.kind == TokenKind::String) {
+                ExprPtr node = makeExpr(Expr::Kind::Literal);
+                node->value = token.text;
+                ++pos;
+                return node;
+            }
+            if (token.kind == TokenKind::Param) {
+                ExprPtr node = makeExpr(Expr::Kind::Param);
+                node->param = ++parameter_count;
+                ++pos;
+                return node;
+            }
+            if (token.kind == TokenKind::Variable) {
+                ExprPtr node = makeExpr(Expr::Kind::Variable);
+                node->name = token.text;
+                ++pos;
+                return node;
+            }
+            if (acceptSymbol("(")) {
+                ExprPtr node = parseOr();
+                expectSymbol(")");
+                return node;
+            }
+            if (acceptWord("NULL")) {
+                return makeExpr(Expr::Kind::Literal);
+            }
+            if (acceptWord("TRUE") || acceptWord("FALSE")) {
+                ExprPtr node = makeExpr(Expr::Kind::Literal);
+                node->value = static_cast<long long>(isWord(tokens[pos - 1], "TRUE") ? 1 : 0);
+                return node;
+            }
+            if (isWord(token, "CURRENT_TIMESTAMP") && !isSymbol(peek(1), "(")) {
+                ++pos;
+                ExprPtr node = makeExpr(Expr::Kind::Function);
+                node->name = "now";
+                return node;
+            }
+            if (token.kind == TokenKind::Word && isSymbol(peek(1), "(")) {
+                std::string name = toLower(token.text);
+                pos += 2;
+                bool aggregate = name == "count" || name == "max" || name == "min" || name == "sum";
+                ExprPtr node = makeExpr(aggregate ? Expr::Kind::Aggregate : Expr::Kind::Function);
+                node->name = name == "current_timestamp" ? "now" : name;
+                if (aggregate && name == "count" && acceptSymbol("*")) {
+                    node->star = true;
+                }
+                else if (!isSymbol(peek(), ")")) {
+                    do {
+                        node->args.push_back(parseOr());
+                    } while (acceptSymbol(","));
+                }
+                expectSymbol(")");
+                if (aggregate && !node->star && node->args.size() != 1) {
+                    fail();
+                }
+                return node;
+            }
+            if (token.kind == TokenKind::Word || token.kind == TokenKind::Quoted) {
+                ExprPtr node = makeExpr(Expr::Kind::Column);
+                node->name = identifier();
+                if (acceptSymbol(".")) {
+                    node->qualifier = node->name;
+                    node->name = identifier();
+                }
+                return node;
+            }
+            fail();
+        }
+
+        std::string textBetween(std::size_t first, std::size_t last) const {
+            return sql.substr(tokens[first].begin, tokens[last].end - tokens[first].begin);
+        }
+
+        // Statements
+        Select parseSelect() {
+            Select select;
+            expectWord("SELECT");
+            select.distinct = acceptWord("DISTINCT");
+            do {
+                SelectItem item;
+                if (acceptSymbol("*")) {
+                    item.all_columns = true;
+                }
+                else {
+                    std::size_t first = pos;
+                    item.expr = parseOr();
+                    std::size_t last = pos - 1;
+                    item.label = optionalAlias();
+                    if (item.label.empty()) {
+                        item.label = item.expr->kind == Expr::Kind::Column ? item.expr->name : textBetween(first, last);
+                    }
+                }
+                select.items.push_back(std::move(item));
+            } while (acceptSymbol(","));
+            if (acceptWord("FROM")) {
+                select.table_name = tableName();
+                select.alias = optionalAlias();
+            }
+            if (acceptWord("WHERE")) {
+                select.where = parseOr();
+            }
+            if (acceptWord("ORDER")) {
+                expectWord("BY");
+                do {
+                    OrderItem item;
+                    item.expr = parseOr();
+                    item.descending = acceptWord("DESC");
+                    if (!item.descending) {
+                        acceptWord("ASC");
+                    }
+                    select.order.push_back(std::move(item));
+                } while (acceptSymbol(","));
+            }
+            if (acceptWord("LIMIT")) {
+                select.limit = parsePrimary();
+            }
+            if (acceptWord("FOR")) {
+                if (!acceptWord("UPDATE")) {
+                    expectWord("SHARE");
+                }
+            }
+            else if (acceptWord("LOCK")) {
+                expectWord("IN");
+                expectWord("SHARE");
+                expectWord("MODE");
+            }
+            return select;
+        }
+
+        void parseInsert(InMemoryQuery& query, std::vector<std::string>& column_names) {
+            expectWord("INSERT");
+            acceptWord("INTO");
+            query.select.table_name = tableName();
+            if (acceptSymbol("(")) {
+                do {
+                    column_names.push_back(identifier());
+                } while (acceptSymbol(","));
+                expectSymbol(")");
+            }
+            if (!acceptWord("VALUES")) {
+                expectWord("VALUE");
+            }
+            do {
+                expectSymbol("(");
+                std::vector<ExprPtr> row;
+                do {
+                    row.push_back(parseOr());
+                } while (acceptSymbol(","));
+                expectSymbol(")");
+                query.insert_rows.push_back(std::move(row));
+            } while (acceptSymbol(","));
+        }
+
+        void parseUpdate(InMemoryQuery& query, std::vector<std::string>& column_names) {
+            expectWord("UPDATE");
+            query.select.table_name = tableName();
+            query.select.alias = optionalAlias();
+            expectWord("SET");
+            do {
+                std::string column = identifier();
+                if (acceptSymbol(".")) {
+                    column = identifier();
+                }
+                expectSymbol("=");
+                column_names.push_back(column);
+                query.assignments.emplace_back(-1, parseOr());
+            } while (acceptSymbol(","));
+            if (acceptWord("WHERE")) {
+                query.select.where = parseOr();
+            }
+        }
+
+        void parseDelete(InMemoryQuery& query) {
+            expectWord("DELETE");
+            expectWord("FROM");
+            query.select.table_name = tableName();
+            query.select.alias = optionalAlias();
+            if (acceptWord("WHERE")) {
+                query.select.where = parseOr();
+            }
+        }
+
+        std::vector<std::string> keyColumns() {
+            std::vector<std::string> columns;
+            expectSymbol("(");
+            do {
+                columns.push_back(identifier());
+                if (isSymbol(peek(), "(")) {
+                    skipBalanced(); // Prefix length
+                }
+                if (!acceptWord("ASC")) {
+                    acceptWord("DESC");
+                }
+            } while (acceptSymbol(","));
+            expectSymbol(")");
+            return columns;
+        }
+
+        SqlValue literalValue() {
+            bool minus = acceptSymbol("-");
+            const Token& token = peek();
+            ++pos;
+            if (token.kind == TokenKind::String) {
+                return token.text;
+            }
+            if (token.kind == TokenKind::Number) {
+                if (token.text.find('.') == std::string::npos) {
+                    long long value = std::strtoll(token.text.c_str(), nullptr, 10);
+                    return minus ? -value : value;
+                }
+                double value = std::strtod(token.text.c_str(), nullptr);
+                return minus ? -value : value;
+            }
+            if (isWord(token, "NULL")) {
+                return SqlValue();
+            }
+            if (isWord(token, "TRUE") || isWord(token, "FALSE")) {
+                return static_cast<long long>(isWord(token, "TRUE") ? 1 : 0);
+            }
+            --pos;
+            fail();
+        }
+
+        ColumnDef columnDefinition(TableDef& table) {
+            ColumnDef column;
+            column.name = identifier();
+            std::string type = toLower(identifier());
+            std::vector<long long> sizes;
+            if (acceptSymbol("(")) {
+                do {
+                    const Token& token = peek();
+                    if (token.kind == TokenKind::Number) {
+                        sizes.push_back(std::strtoll(token.text.c_str(), nullptr, 10));
+                    }
+                    else if (token.kind == TokenKind::String) {
+                        column.enum_values.push_back(token.text);
+                    }
+                    else {
+                        fail();
+                    }
+                    ++pos;
+                } while (acceptSymbol(","));
+                expectSymbol(")");
+            }
+            if (type == "int" || type == "integer" || type == "tinyint" || type == "smallint" || type == "mediumint"
+                || type == "bigint" || type == "bool" || type == "boolean" || type == "bit" || type == "year") {
+                column.type = ColumnType::Integer;
+            }
+            else if (type == "decimal" || type == "numeric" || type == "dec" || type == "fixed") {
+                column.type = ColumnType::Decimal;
+                column.scale = sizes.size() > 1 ? static_cast<int>(sizes[1]) : 0;
+            }
+            else if (type == "float" || type == "double" || type == "real") {
+                column.type = ColumnType::Double;
+            }
+            else if (type == "char" || type == "varchar") {
+                column.type = ColumnType::Text;
+                column.length = sizes.empty() ? 1 : static_cast<std::size_t>(sizes[0]);
+            }
+            else if (type == "text" || type == "tinytext" || type == "mediumtext" || type == "longtext" || type == "enum") {
+                column.type = ColumnType::Text;
+            }
+            else if (type == "datetime" || type == "timestamp") {
+                column.type = ColumnType::DateTime;
+            }
+            else if (type == "date") {
+                column.type = ColumnType::Date;
+            }
+            else {
+                throw std::runtime_error("Unsupported column type '" + type + "' for column '" + column.name + "'");
+            }
+            while (!isSymbol(peek(), ",") && !isSymbol(peek(), ")")) {
+                if (acceptWord("NOT")) {
+                    expectWord("NULL");
+                    column.not_null = true;
+                }
+                else if (acceptWord("NULL") || acceptWord("UNSIGNED") || acceptWord("SIGNED") || acceptWord("ZEROFILL")) {
+                }
+                else if (acceptWord("DEFAULT")) {
+                    column.has_default = true;
+                    if (acceptWord("CURRENT_TIMESTAMP") || acceptWord("NOW")) {
+                        column.default_now = true;
+                        if (acceptSymbol("(")) {
+                            expectSymbol(")");
+                        }
+                    }
+                    else {
+                        column.default_value = literalValue();
+                    }
+                }
+                else if (acceptWord("AUTO_INCREMENT")) {
+                    column.auto_increment = true;
+                }
+                else if (acceptWord("PRIMARY")) {
+                    expectWord("KEY");
+                    table.keys.push_back(KeyDef{ "PRIMARY", { column.name }, true, true });
+                }
+                else if (acceptWord("UNIQUE")) {
+                    acceptWord("KEY");
+                    table.keys.push_back(KeyDef{ column.name, { column.name }, false, true });
+                }
+                else if (acceptWord("ON")) {
+                    expectWord("UPDATE");
+                    ++pos;
+                    if (acceptSymbol("(")) {
+                        expectSymbol(")");
+                    }
+                }
+                else if (acceptWord("COMMENT") || acceptWord("COLLATE")) {
+                    ++pos;
+                }
+                else if (acceptWord("CHARACTER")) {
+                    expectWord("SET");
+                    ++pos;
+                }
+                else if (acceptWord("CHECK")) {
+                    checkConstraint(table, "");
+                }
+                else if (isSymbol(peek(), "(")) {
+                    skipBalanced();
+                }
+                else if (peek().kind == TokenKind::End) {
+                    fail();
+                }
+                else {
+                    ++pos; // Attributes without effect here, such as VISIBLE.
+                }
+            }
+            return column;
+        }
+
+        // Records the parenthesized expression of a CHECK clause, unless NOT ENFORCED follows.
+        void checkConstraint(TableDef& table, std::string name) {
+            if (!isSymbol(peek(), "(")) {
+                fail();
+            }
+            std::size_t first = pos;
+            skipBalanced();
+            std::string expression = textBetween(first, pos - 1);
+            if (acceptWord("NOT")) {
+                expectWord("ENFORCED");
+                return;
+            }
+            acceptWord("ENFORCED");
+            if (name.empty()) {
+                name = table.name + "_chk_" + std::to_string(table.checks.size() + 1);
+            }
+            table.checks.emplace_back(std::move(name), std::move(expression));
+        }
+
+        void parseCreateTable(InMemoryQuery& query) {
+            TableDef& table = query.table_def;
+            if (acceptWord("IF")) {
+                expectWord("NOT");
+                expectWord("EXISTS");
+                table.if_not_exists = true;
+            }
+            table.name = tableName();
+            expectSymbol("(");
+            do {
+                if (acceptWord("PRIMARY")) {
+                    expectWord("KEY");
+                    table.keys.push_back(KeyDef{ "PRIMARY", keyColumns(), true, true });
+                    skipDefinition();
+                }
+                else if (acceptWord("UNIQUE")) {
+                    if (!acceptWord("KEY")) {
+                        acceptWord("INDEX");
+                    }
+                    std::string name = isSymbol(peek(), "(") ? "" : identifier();
+                    KeyDef key{ name, keyColumns(), false, true };
+                    if (key.name.empty()) {
+                        key.name = key.columns.front();
+                    }
+                    table.keys.push_back(std::move(key));
+                    skipDefinition();
+                }
+                else if (acceptWord("KEY") || acceptWord("INDEX")) {
+                    std::string name = isSymbol(peek(), "(") ? "" : identifier();
+                    KeyDef key{ name, keyColumns(), false, false };
+                    if (key.name.empty()) {
+                        key.name = key.columns.front();
+                    }
+                    table.keys.push_back(std::move(key));
+                    skipDefinition();
+                }
+                else if (isWord(peek(), "CONSTRAINT") || isWord(peek(), "CHECK") || isWord(peek(), "FOREIGN")) {
+                    std::string name;
+                    if (acceptWord("CONSTRAINT") && !isWord(peek(), "CHECK") && !isWord(peek(), "FOREIGN")) {
+                        name = identifier();
+                    }
+                    if (acceptWord("CHECK")) {
+                        checkConstraint(table, std::move(name));
+                    }
+                    skipDefinition(); // Foreign keys are not enforced.
+                }
+                else {
+                    table.columns.push_back(columnDefinition(table));
+                }
+            } while (acceptSymbol(","));
+            expectSymbol(")");
+            while (!atEnd()) {
+                if (acceptWord("AUTO_INCREMENT")) {
+                    acceptSymbol("=");
+                    if (peek().kind != TokenKind::Number) {
+                        fail();
+                    }
+                    table.auto_increment = std::strtoll(peek().text.c_str(), nullptr, 10);
+                }
+                ++pos; // Other table options (ENGINE, CHARSET, COLLATE...) are ignored.
+            }
+        }
+
+        void parseCreateIndex(InMemoryQuery& query, bool unique) {
+            expectWord("INDEX");
+            query.index_def.name = identifier();
+            query.index_def.unique = unique;
+            expectWord("ON");
+            query.index_table = tableName();
+            query.index_def.columns = keyColumns();
+            while (!atEnd()) {
+                ++pos; // USING BTREE, ALGORITHM, LOCK...
+            }
+        }
+
+        void parseSetIsolation(InMemoryQuery& query) {
+            expectWord("SET");
+            if (!acceptWord("SESSION")) {
+                acceptWord("LOCAL");
+            }
+            expectWord("TRANSACTION");
+            expectWord("ISOLATION");
+            expectWord("LEVEL");
+            while (!atEnd()) {
+                query.isolation_level += (query.isolation_level.empty() ? "" : " ") + toUpper(identifier());
+            }
+        }
+
+    public:
+        std::size_t parameter_count = 0;
+
+        explicit Parser(const std::string& sql) : sql(sql), tokens(tokenize(sql)) {}
+
+        /**
+         * Parses a standalone expression, such as the text of a CHECK constraint.
+         */
+        ExprPtr parseExpression() {
+            ExprPtr expr = parseOr();
+            if (peek().kind != TokenKind::End || parameter_count != 0) {
+                fail();
+            }
+            return expr;
+        }
+
+        /**
+         * Parses one statement. Column and table names are resolved later,
+         * against the tables that exist when the statement is prepared.
+         */
+        std::unique_ptr<InMemoryQuery> parse(std::vector<std::string>& column_names) {
+            auto query = std::make_unique<InMemoryQuery>();
+            if (isWord(peek(), "SELECT")) {
+                query->kind = InMemoryQuery::Kind::Select;
+                query->select = parseSelect();
+            }
+            else if (isWord(peek(), "INSERT")) {
+                query->kind = InMemoryQuery::Kind::Insert;
+                parseInsert(*query, column_names);
+            }
+            else if (isWord(peek(), "UPDATE")) {
+                query->kind = InMemoryQuery::Kind::Update;
+                parseUpdate(*query, column_names);
+            }
+            else if (isWord(peek(), "DELETE")) {
+                query->kind = InMemoryQuery::Kind::Delete;
+                parseDelete(*query);
+            }
+            else if (acceptWord("CREATE")) {
+                bool unique = acceptWord("UNIQUE");
+                if (!unique && acceptWord("TABLE")) {
+                    query->kind = InMemoryQuery::Kind::CreateTable;
+                    parseCreateTable(*query);
+                }
+                else {
+                    query->kind = InMemoryQuery::Kind::CreateIndex;
+                    parseCreateIndex(*query, unique);
+                }
+            }
+            else if (isWord(peek(), "SET")) {
+                query->kind = InMemoryQuery::Kind::SetIsolation;
+                parseSetIsolation(*query);
+            }
+            else if (acceptWord("USE")) {
+                query->kind = InMemoryQuery::Kind::Use;
+                identifier();
+            }
+            else {
+                fail();
+            }
+            acceptSymbol(";");
+            if (peek().kind != TokenKind::End) {
+                fail();
+            }
+            query->parameter_count = parameter_count;
+            return query;
+        }
+
+        /**
+         * Splits a script into statements at top-level semicolons.
+         */
+        static std::vector<std::string> splitScript(const std::string& script) {
+            std::vector<std::string> statements;
+            std::vector<Token> tokens = tokenize(script);
+            std::size_t first = 0;
+            for (std::size_t i = 0; i < tokens.size(); ++i) {
+                bool end = tokens[i].kind == TokenKind::End;
+                if (end || (tokens[i].kind == TokenKind::Symbol && tokens[i].text == ";")) {
+                    if (i > first) {
+                        statements.push_back(script.substr(tokens[first].begin, tokens[i - 1].end - tokens[first].begin));
+                    }
+                    first = i + 1;
+                }
+            }
+            return statements;
+        }
+    };
+
+    // Name resolution
+    struct NameScope {
+        const Table* table;
+        const std::string* alias;
+        const NameScope* outer;
+    };
+
+    bool hasAggregate(const Expr& expr) {
+        if (expr.kind == Expr::Kind::Aggregate) {
+            return true;
+        }
+        for (const auto& arg : expr.args) {
+            if (hasAggregate(*arg)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool referencesInnermost(const Expr& expr, int depth = 0) {
+        if (expr.kind == Expr::Kind::Column) {
+            return expr.depth == depth;
+        }
+        if (expr.kind == Expr::Kind::Exists) {
+            return true; // Conservatively treat subqueries as correlated.
+        }
+        for (const auto& arg : expr.args) {
+            if (referencesInnermost(*arg, depth)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void resolveSelect(Select& select, const NameScope* outer, const std::function<Table*(const std::string&)>& findTable);
+
+    void resolveExpr(Expr& expr, const NameScope* scope, const std::function<Table*(const std::string&)>& findTable) {
+        if (expr.kind == Expr::Kind::Column) {
+            int depth = 0;
+            for (const NameScope* current = scope; current; current = current->outer, ++depth) {
+                if (!current->table) {
+                    continue;
+                }
+                if (!expr.qualifier.empty() && !equalsIgnoreCase(expr.qualifier, current->alias->empty() ? current->table->name : *current->alias)) {
+                    continue;
+                }
+                int column = current->table->findColumn(expr.name);
+                if (column >= 0) {
+                    expr.depth = depth;
+                    expr.column = column;
+                    expr.column_type = current->table->columns[column].type;
+                    return;
+                }
+            }
+            throw std::runtime_error("Unknown column '" + (expr.qualifier.empty() ? "" : expr.qualifier + ".") + expr.name + "' in 'field list'");
+        }
+        if (expr.kind == Expr::Kind::Exists) {
+            resolveSelect(*expr.subquery, scope, findTable);
+            return;
+        }
+        for (auto& arg : expr.args) {
+            resolveExpr(*arg, scope, findTable);
+        }
+        if (expr.kind == Expr::Kind::Compare) {
+            for (const auto& arg : expr.args) {
+                expr.temporal = expr.temporal || (arg->kind == Expr::Kind::Column && arg->column_type == ColumnType::DateTime);
+            }
+        }
+    }
+
+    void collectEqualities(const Expr& expr, Select& select) {
+        if (expr.kind == Expr::Kind::And) {
+            collectEqualities(*expr.args[0], select);
+            collectEqualities(*expr.args[1], select);
+            return;
+        }
+        if (expr.kind != Expr::Kind::Compare || expr.op != CompareOp::Eq || expr.temporal) {
+            return;
+        }
+        for (int side = 0; side < 2; ++side) {
+            const Expr& column = *expr.args[side];
+            const Expr& value = *expr.args[1 - side];
+            if (column.kind == Expr::Kind::Column && column.depth == 0 && !referencesInnermost(value) && !hasAggregate(value)) {
+                select.equalities.emplace_back(column.column, &value);
+                return;
+            }
+        }
+    }
+
+    void resolveSelect(Select& select, const NameScope* outer, const std::function<Table*(const std::string&)>& findTable) {
+        if (!select.table_name.empty()) {
+            select.table = findTable(select.table_name);
+        }
+        NameScope scope{ select.table, &select.alias, outer };
+        std::vector<SelectItem> items;
+        for (auto& item : select.items) {
+            if (!item.all_columns) {
+                resolveExpr(*item.expr, &scope, findTable);
+                if (item.expr->kind == Expr::Kind::Column && item.expr->depth == 0) {
+                    item.scale = select.table->columns[item.expr->column].scale;
+                }
+                select.aggregate = select.aggregate || hasAggregate(*item.expr);
+                items.push_back(std::move(item));
+                continue;
+            }
+            if (!select.table) {
+                throw std::runtime_error("No tables used");
+            }
+            for (std::size_t i = 0; i < select.table->columns.size(); ++i) {
+                SelectItem column;
+                column.expr = makeExpr(Expr::Kind::Column);
+                column.expr->column = static_cast<int>(i);
+                column.expr->column_type = select.table->columns[i].type;
+                column.label = select.table->columns[i].name;
+                column.scale = select.table->columns[i].scale;
+                items.push_back(std::move(column));
+            }
+        }
+        select.items = std::move(items);
+        if (select.where) {
+            resolveExpr(*select.where, &scope, findTable);
+            if (hasAggregate(*select.where)) {
+                throw std::runtime_error("Invalid use of group function");
+            }
+            collectEqualities(*select.where, select);
+        }
+        for (auto& item : select.order) {
+            resolveExpr(*item.expr, &scope, findTable);
+        }
+        if (select.limit) {
+            resolveExpr(*select.limit, &scope, findTable);
+        }
+    }
+}
+
+/**
+ * @struct InMemoryStore
+ * @brief Engine state: tables, parsed statements, session variables and undo log.
+ */
+struct InMemoryStore {
+    /**
+     * @struct UndoEntry
+     * @brief Row image to restore on rollback.
+     */
+    struct UndoEntry {
+        Table* table;
+        long long row_id;
+        std::optional<Row> before;  ///< std::nullopt when the row did not exist.
+    };
+
+    std::string schema;
+    std::map<std::string, std::unique_ptr<Table>> tables;  ///< By lowercase name.
+    std::unordered_map<std::string, std::shared_ptr<const InMemoryQuery>> queries;
+    std::vector<UndoEntry> undo_log;
+    bool transaction_active = false;
+    long long last_insert_id = 0;
+    std::string isolation_level = "REPEATABLE-READ";
+    Table* statistics = nullptr;  ///< information_schema.statistics.
+    std::unordered_map<std::string, std::regex> patterns;  ///< Compiled REGEXP_LIKE patterns by text.
+    std::map<std::string, int> user_locks;  ///< GET_LOCK names held by the session, lowercase, with their count.
+
+    explicit InMemoryStore(std::string schema_name) : schema(std::move(schema_name)) {
+        TableDef def;
+        def.name = "information_schema.statistics";
+        for (const char* name : { "TABLE_SCHEMA", "TABLE_NAME", "NON_UNIQUE", "INDEX_NAME", "SEQ_IN_INDEX", "COLUMN_NAME" }) {
+            ColumnDef column;
+            column.name = name;
+            column.type = std::string(name) == "NON_UNIQUE" || std::string(name) == "SEQ_IN_INDEX" ? ColumnType::Integer : ColumnType::Text;
+            def.columns.push_back(column);
+        }
+        statistics = createTable(def);
+    }
+
+    Table* findTable(const std::string& name) const {
+        auto it = tables.find(toLower(name));
+        if (it == tables.end()) {
+            throw std::runtime_error("Table '" + schema + "." + name + "' doesn't exist");
+        }
+        return it->second.get();
+    }
+
+    // Row storage; every change goes through these so the indexes stay in sync.
+    void attach(Table& table, long long row_id, Row row) {
+        for (auto& index : table.indexes) {
+            index.entries.insert(index.keyOf(row, row_id));
+        }
+        table.rows.emplace(row_id, std::move(row));
+    }
+
+    Row detach(Table& table, long long row_id) {
+        auto it = table.rows.find(row_id);
+        Row row = std::move(it->second);
+        table.rows.erase(it);
+        for (auto& index : table.indexes) {
+            index.entries.erase(index.keyOf(row, row_id));
+        }
+        return row;
+    }
+
+    // Changes are logged for every statement, so a failing statement can be undone even in autocommit mode.
+    void log(Table& table, long long row_id, std::optional<Row> before) {
+        if (&table != statistics) {
+            undo_log.push_back(UndoEntry{ &table, row_id, std::move(before) });
+        }
+    }
+
+    [[noreturn]] static void duplicateEntry(const Table& table, const std::string& index, const Row& row, const std::vector<int>& columns) {
+        std::string value;
+        for (std::size_t i = 0; i < columns.size(); ++i) {
+            value += (i == 0 ? "" : "-") + toText(row[columns[i]], table.columns[columns[i]].scale);
+        }
+        throw std::runtime_error("Duplicate entry '" + value + "' for key '" + table.name + "." + index + "'");
+    }
+
+    void checkUnique(const Table& table, const Row& row, long long row_id) const {
+        for (const auto& index : table.indexes) {
+            if (!index.unique) {
+                continue;
+            }
+            Row key = index.keyOf(row, row_id);
+            key.pop_back();
+            if (std::any_of(key.begin(), key.end(), isNull)) {
+                continue; // NULLs never collide
+            }
+            for (auto it = index.entries.lower_bound(key); it != index.entries.end() && hasPrefix(*it, key); ++it) {
+                if (toInteger(it->back()) != row_id) {
+                    duplicateEntry(table, index.name, row, index.columns);
+                }
+            }
+        }
+    }
+
+    long long rowIdOf(Table& table, const Row& row) {
+        return table.key_column >= 0 ? std::get<long long>(row[table.key_column]) : table.next_row_id++;
+    }
+
+    long long insertRow(Table& table, Row row) {
+        long long row_id = rowIdOf(table, row);
+        if (table.key_column >= 0 && table.rows.count(row_id) != 0) {
+            duplicateEntry(table, "PRIMARY", row, { table.key_column });
+        }
+        checkUnique(table, row, row_id);
+        attach(table, row_id, std::move(row));
+        log(table, row_id, std::nullopt);
+        return row_id;
+    }
+
+    void replaceRow(Table& table, long long row_id, Row row) {
+        long long new_id = table.key_column >= 0 ? std::get<long long>(row[table.key_column]) : row_id;
+        if (new_id != row_id && table.rows.count(new_id) != 0) {
+            duplicateEntry(table, "PRIMARY", row, { table.key_column });
+        }
+        checkUnique(table, row, row_id);
+        Row before = detach(table, row_id);
+        log(table, row_id, std::move(before));
+        if (new_id != row_id) {
+            log(table, new_id, std::nullopt);
+        }
+        attach(table, new_id, std::move(row));
+    }
+
+    void eraseRow(Table& table, long long row_id) {
+        log(table, row_id, detach(table, row_id));
+    }
+
+    // Restores the rows changed after the first @p mark entries of the undo log.
+    void undoTo(std::size_t mark) {
+        while (undo_log.size() > mark) {
+            UndoEntry& entry = undo_log.back();
+            if (entry.table->rows.count(entry.row_id) != 0) {
+                detach(*entry.table, entry.row_id);
+            }
+            if (entry.before) {
+                attach(*entry.table, entry.row_id, std::move(*entry.before));
+            }
+            undo_log.pop_back();
+        }
+    }
+
+    // Converts a value to the storage form of a column; NULL stays NULL.
+    static SqlValue coerce(const ColumnDef& column, const SqlValue& value) {
+        if (isNull(value)) {
+            return value;
+        }
+        const auto* text = std::get_if<std::string>(&value);
+        switch (column.type) {
+        case ColumnType::Integer:
+        case ColumnType::Decimal:
+        case ColumnType::Double: {
+            double number = 0;
+            if (text) {
+                char* end = nullptr;
+                number = std::strtod(text->c_str(), &end);
+                while (end && std::isspace(static_cast<unsigned char>(*end))) {
+                    ++end;
+                }
+                if (text->empty() || !end || *end != '\0') {
+                    throw std::runtime_error("Incorrect " + std::string(column.type == ColumnType::Integer ? "integer" : "decimal")
+                        + " value: '" + *text + "' for column '" + column.name + "' at row 1");
+                }
+            }
+            if (column.type == ColumnType::Integer) {
+                if (const auto* integer = std::get_if<long long>(&value)) {
+                    return *integer;
+                }
+                return std::llround(text ? number : toDouble(value));
+            }
+            if (!text) {
+                number = toDouble(value);
+            }
+            if (column.type == ColumnType::Decimal) {
+                double factor = std::pow(10.0, column.scale);
+                number = std::round(number * factor) / factor;
+            }
+            return number;
+        }
+        case ColumnType::Text: {
+            std::string stored = toText(value);
+            if (!column.enum_values.empty()) {
+                for (const auto& allowed : column.enum_values) {
+                    if (equalsIgnoreCase(allowed, stored)) {
+                        return allowed;
+                    }
+                }
+                throw std::runtime_error("Data truncated for column '" + column.name + "' at row 1");
+            }
+            if (column.length != 0 && characterCount(stored) > column.length) {
+                throw std::runtime_error("Data too long for column '" + column.name + "' at row 1");
+            }
+            return stored;
+        }
+        case ColumnType::DateTime:
+        case ColumnType::Date: {
+            std::string normalized;
+            if (!text || !normalizeDateTime(*text, column.type == ColumnType::Date, normalized)) {
+                throw std::runtime_error("Incorrect " + std::string(column.type == ColumnType::Date ? "date" : "datetime")
+                    + " value: '" + toText(value) + "' for column '" + column.name + "' at row 1");
+            }
+            return normalized;
+        }
+        }
+        return value;
+    }
+
+    static void checkNotNull(const ColumnDef& column, const SqlValue& value) {
+        if (column.not_null && isNull(value)) {
+            throw std::runtime_error("Column '" + column.name + "' cannot be null");
+        }
+    }
+
+    // DDL
+    void addStatistics(const Table& table, const std::string& index, const std::vector<int>& columns, bool unique) {
+        for (std::size_t i = 0; i < columns.size(); ++i) {
+            insertRow(*statistics, Row{ schema, table.name, static_cast<long long>(unique ? 0 : 1), index,
+                static_cast<long long>(i + 1), table.columns[columns[i]].name });
+        }
+    }
+
+    std::vector<int> keyColumnIndexes(const Table& table, const std::vector<std::string>& names) const {
+        std::vector<int> columns;
+        for (const auto& name : names) {
+            int column = table.findColumn(name);
+            if (column < 0) {
+                throw std::runtime_error("Key column '" + name + "' doesn't exist in table");
+            }
+            columns.push_back(column);
+        }
+        return columns;
+    }
+
+    void addIndex(Table& table, const std::string& name, const std::vector<int>& columns, bool unique) {
+        if (table.findIndex(name) || (equalsIgnoreCase(name, "PRIMARY") && table.key_column >= 0)) {
+            throw std::runtime_error("Duplicate key name '" + name + "'");
+        }
+        Index index;
+        index.name = name;
+        index.columns = columns;
+        index.unique = unique;
+        for (const auto& row : table.rows) {
+            Row key = index.keyOf(row.second, row.first);
+            if (unique) {
+                Row prefix(key.begin(), key.end() - 1);
+                auto it = index.entries.lower_bound(prefix);
+                if (std::none_of(prefix.begin(), prefix.end(), isNull) && it != index.entries.end() && hasPrefix(*it, prefix)) {
+                    duplicateEntry(table, name, row.second, columns);
+                }
+            }
+            index.entries.insert(std::move(key));
+        }
+        table.indexes.push_back(std::move(index));
+    }
+
+    Table* createTable(const TableDef& def) {
+        std::string key = toLower(def.name);
+        if (tables.count(key) != 0) {
+            if (def.if_not_exists) {
+                return tables[key].get();
+            }
+            throw std::runtime_error("Table '" + def.name + "' already exists");
+        }
+        auto table = std::make_unique<Table>();
+        table->name = key;
+        table->columns = def.columns;
+        table->next_auto_increment = std::max<long long>(1, def.auto_increment);
+        for (std::size_t i = 0; i < table->columns.size(); ++i) {
+            ColumnDef& column = table->columns[i];
+            if (column.auto_increment) {
+                table->auto_column = static_cast<int>(i);
+            }
+            if (column.has_default && !column.default_now) {
+                column.default_value = coerce(column, column.default_value);
+            }
+        }
+        std::vector<std::pair<const KeyDef*, std::vector<int>>> keys;
+        std::string no_alias;
+        NameScope scope{ table.get(), &no_alias, nullptr };
+        for (const auto& check : def.checks) {
+            ExprPtr expr = Parser(check.second).parseExpression();
+            resolveExpr(*expr, &scope, [this](const std::string& name) { return findTable(name); });
+            table->checks.emplace_back(check.first, std::move(expr));
+        }
+        for (const auto& key_def : def.keys) {
+            keys.emplace_back(&key_def, keyColumnIndexes(*table, key_def.columns));
+            if (key_def.primary) {
+                for (int column : keys.back().second) {
+                    table->columns[column].not_null = true;
+                }
+            }
+        }
+        for (const auto& entry : keys) {
+            const KeyDef& key_def = *entry.first;
+            if (key_def.primary && entry.second.size() == 1 && table->columns[entry.second[0]].type == ColumnType::Integer) {
+                table->key_column = entry.second[0];
+            }
+            else {
+                addIndex(*table, key_def.primary ? "PRIMARY" : key_def.name, entry.second, key_def.unique);
+            }
+        }
+        Table* created = table.get();
+        tables.emplace(key, std::move(table));
+        if (created != statistics && statistics) {
+            for (const auto& entry : keys) {
+                addStatistics(*created, entry.first->primary ? "PRIMARY" : entry.first->name, entry.second, entry.first->unique);
+            }
+        }
+        return created;
+    }
+
+    // Parsing
+    std::shared_ptr<const InMemoryQuery> compile(const std::string& sql) {
+        std::vector<std::string> column_names;
+        Parser parser(sql);
+        std::shared_ptr<InMemoryQuery> query = parser.parse(column_names);
+        auto find = [this](const std::string& name) { return findTable(name); };
+        switch (query->kind) {
+        case InMemoryQuery::Kind::Select:
+            resolveSelect(query->select, nullptr, find);
+            break;
+        case InMemoryQuery::Kind::Insert: {
+            Table* table = findTable(query->select.table_name);
+            query->select.table = table;
+            if (column_names.empty()) {
+                for (const auto& column : table->columns) {
+                    column_names.push_back(column.name);
+                }
+            }
+            for (const auto& name : column_names) {
+                int column = table->findColumn(name);
+                if (column < 0) {
+                    throw std::runtime_error("Unknown column '" + name + "' in 'field list'");
+                }
+                query->insert_columns.push_back(column);
+            }
+            NameScope scope{ nullptr, &query->select.alias, nullptr };
+            for (auto& row : query->insert_rows) {
+                if (row.size() != column_names.size()) {
+                    throw std::runtime_error("Column count doesn't match value count at row 1");
+                }
+                for (auto& value : row) {
+                    resolveExpr(*value, &scope, find);
+                }
+            }
+            break;
+        }
+        case InMemoryQuery::Kind::Update:
+        case InMemoryQuery::Kind::Delete: {
+            resolveSelect(query->select, nullptr, find);
+            NameScope scope{ query->select.table, &query->select.alias, nullptr };
+            for (std::size_t i = 0; i < query->assignments.size(); ++i) {
+                int column = query->select.table->findColumn(column_names[i]);
+                if (column < 0) {
+                    throw std::runtime_error("Unknown column '" + column_names[i] + "' in 'field list'");
+                }
+                query->assignments[i].first = column;
+                resolveExpr(*query->assignments[i].second, &scope, find);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+        return query;
+    }
+};
+
+namespace {
+    /**
+     * Evaluates expressions for one statement execution.
+     */
+    class Evaluator {
+        InMemoryStore& store;
+        const std::vector<SqlValue>& params;
+
+        struct RowScope {
+            const Row* row;
+            const RowScope* outer;
+        };
+
+        static int truth(const SqlValue& value) {
+            if (isNull(value)) {
+                return -1;
+            }
+            return toDouble(value) != 0 ? 1 : 0;
+        }
+
+        static SqlValue fromTruth(int truth) {
+            return truth < 0 ? SqlValue() : SqlValue(static_cast<long long>(truth));
+        }
+
+        static bool compareMatches(CompareOp op, int order) {
+            switch (op) {
+            case CompareOp::Eq: return order == 0;
+            case CompareOp::Ne: return order != 0;
+            case CompareOp::Lt: return order < 0;
+            case CompareOp::Le: return order <= 0;
+            case CompareOp::Gt: return order > 0;
+            case CompareOp::Ge: return order >= 0;
+            }
+            return false;
+        }
+
+        // Text compared with a DATETIME column is read as a date and time, so '2027-01-05' means midnight.
+        static const SqlValue& temporalOperand(const SqlValue& value, SqlValue& normalized) {
+            const auto* text = std::get_if<std::string>(&value);
+            std::string converted;
+            if (text && text->size() != DATE_TIME_LENGTH && normalizeDateTime(*text, false, converted)) {
+                normalized = std::move(converted);
+                return normalized;
+            }
+            return value;
+        }
+
+        SqlValue callFunction(const Expr& expr, const std::vector<SqlValue>& args) const {
+            if (expr.name == "coalesce") {
+                for (const auto& arg : args) {
+                    if (!isNull(arg)) {
+                        return arg;
+                    }
+                }
+                return SqlValue();
+            }
+            if (expr.name == "ifnull" && args.size() == 2) {
+                return isNull(args[0]) ? args[1] : args[0];
+            }
+            if (expr.name == "database" && args.empty()) {
+                return store.schema;
+            }
+            if (expr.name == "last_insert_id" && args.empty()) {
+                return store.last_insert_id;
+            }
+            if (expr.name == "now" && args.empty()) {
+                return DateTime().getDateTimeString();
+            }
+            if ((expr.name == "length" || expr.name == "char_length") && args.size() == 1) {
+                if (isNull(args[0])) {
+                    return SqlValue();
+                }
+                std::string text = toText(args[0]);
+                return static_cast<long long>(expr.name == "length" ? text.size() : characterCount(text));
+            }
+            if (expr.name == "regexp_like" && args.size() == 2) {
+                if (isNull(args[0]) || isNull(args[1])) {
+                    return SqlValue();
+                }
+                std::string pattern = toText(args[1]);
+                auto compiled = store.patterns.find(pattern);
+                if (compiled == store.patterns.end()) {
+                    // Case-insensitive, like the utf8mb4_0900_ai_ci collation of the schema.
+                    compiled = store.patterns.emplace(pattern, std::regex(pattern, std::regex::ECMAScript | std::regex::icase)).first;
+                }
+                return static_cast<long long>(std::regex_search(toText(args[0]), compiled->second) ? 1 : 0);
+            }
+            // The only session cannot wait for itself: GET_LOCK always succeeds and,
+            // as in MySQL, a lock taken several times needs as many releases.
+            if (expr.name == "get_lock" && args.size() == 2) {
+                if (isNull(args[0])) {
+                    return SqlValue();
+                }
+                ++store.user_locks[toLower(toText(args[0]))];
+                return 1LL;
+            }
+            if (expr.name == "release_lock" && args.size() == 1) {
+                auto held = isNull(args[0]) ? store.user_locks.end() : store.user_locks.find(toLower(toText(args[0])));
+                if (held == store.user_locks.end()) {
+                    return SqlValue();
+                }
+                if (--held->second == 0) {
+                    store.user_locks.erase(held);
+                }
+                return 1LL;
+            }
+            if ((expr.name == "lower" || expr.name == "upper") && args.size() == 1) {
+                if (isNull(args[0])) {
+                    return SqlValue();
+                }
+                return expr.name == "lower" ? toLower(toText(args[0])) : toUpper(toText(args[0]));
+            }
+            throw std::runtime_error("FUNCTION " + store.schema + "." + expr.name + " does not exist");
+        }
+
+        void aggregate(const Expr& expr, const std::vector<const Row*>& rows, SqlValue& result) const {
+            if (expr.star) {
+                result = static_cast<long long>(rows.size());
+                return;
+            }
+            long long count = 0;
+            bool integral = true;
+            long long integer_sum = 0;
+            double real_sum = 0;
+            SqlValue temp;
+            for (const Row* row : rows) {
+                RowScope scope{ row, nullptr };
+                const SqlValue& value = eval(*expr.args[0], scope, temp);
+                if (isNull(value)) {
+                    continue;
+                }
+                ++count;
+                if (expr.name == "max" || expr.name == "min") {
+                    if (isNull(result) || compareValues(value, result) * (expr.name == "max" ? 1 : -1) > 0) {
+                        result = value;
+                    }
+                }
+                else if (expr.name == "sum") {
+                    integral = integral && std::holds_alternative<long long>(value);
+                    integer_sum += toInteger(value);
+                    real_sum += toDouble(value);
+                }
+            }
+            if (expr.name == "count") {
+                result = count;
+            }
+            else if (expr.name == "sum" && count > 0) {
+                result = integral ? SqlValue(integer_sum) : SqlValue(real_sum);
+            }
+        }
+
+    public:
+        Evaluator(InMemoryStore& store, const std::vector<SqlValue>& params) : store(store), params(params) {}
+
+        /**
+         * Returns a reference to the value (a row cell, literal or parameter)
+         * when possible; computed values are stored in temp.
+         */
+        const SqlValue& eval(const Expr& expr, const RowScope& scope, SqlValue& temp) const {
+            switch (expr.kind) {
+            case Expr::Kind::Literal:
+                return expr.value;
+            case Expr::Kind::Param:
+                return params[expr.param - 1];
+            case Expr::Kind::Column: {
+                const RowScope* current = &scope;
+                for (int i = 0; i < expr.depth; ++i) {
+                    current = current->outer;
+                }
+                return (*current->row)[expr.column];
+            }
+            case Expr::Kind::Variable:
+                if (expr.name == "transaction_isolation" || expr.name == "tx_isolation") {
+                    temp = store.isolation_level;
+                    return temp;
+                }
+                if (expr.name == "autocommit") {
+                    temp = static_cast<long long>(store.transaction_active ? 0 : 1);
+                    return temp;
+                }
+                throw std::runtime_error("Unknown system variable '" + expr.name + "'");
+            case Expr::Kind::Compare: {
+                SqlValue left_temp;
+                SqlValue right_temp;
+                const SqlValue* left = &eval(*expr.args[0], scope, left_temp);
+                const SqlValue* right = &eval(*expr.args[1], scope, right_temp);
+                if (isNull(*left) || isNull(*right)) {
+                    temp = SqlValue();
+                    return temp;
+                }
+                SqlValue left_normalized;
+                SqlValue right_normalized;
+                if (expr.temporal) {
+                    left = &temporalOperand(*left, left_normalized);
+                    right = &temporalOperand(*right, right_normalized);
+                }
+                temp = static_cast<long long>(compareMatches(expr.op, compareValues(*left, *right)) ? 1 : 0);
+                return temp;
+            }
+            case Expr::Kind::And:
+            case Expr::Kind::Or: {
+                bool is_and = expr.kind == Expr::Kind::And;
+                int left = truth(eval(*expr.args[0], scope, temp));
+                if (left == (is_and ? 0 : 1)) {
+                    temp = static_cast<long long>(left);
+                    return temp;
+                }
+                int right = truth(eval(*expr.args[1], scope, temp));
+                if (right == (is_and ? 0 : 1)) {
+                    temp = static_cast<long long>(right);
+                }
+                else {
+                    temp = fromTruth(left < 0 || right < 0 ? -1 : (is_and ? 1 : 0));
+                }
+                return temp;
+            }
+            case Expr::Kind::Not: {
+                int value = truth(eval(*expr.args[0], scope, temp));
+                temp = fromTruth(value < 0 ? -1 : 1 - value);
+                return temp;
+            }
+            case Expr::Kind::In: {
+                SqlValue left_temp;
+                const SqlValue& left = eval(*expr.args[0], scope, left_temp);
+                int result = 0;
+                if (isNull(left)) {
+                    result = -1;
+                }
+                for (std::size_t i = 1; i < expr.args.size() && result == 0; ++i) {
+                    SqlValue item_temp;
+                    const SqlValue& item = eval(*expr.args[i], scope, item_temp);
+                    if (isNull(item)) {
+                        result = -1;
+                    }
+                    else if (compareValues(left, item) == 0) {
+                        result = 1;
+                    }
+                }
+                temp = fromTruth(expr.negated && result >= 0 ? 1 - result : result);
+                return temp;
+            }
+            case Expr::Kind::IsNull: {
+                bool null = isNull(eval(*expr.args[0], scope, temp));
+                temp = static_cast<long long>(null != expr.negated ? 1 : 0);
+                return temp;
+            }
+            case Expr::Kind::Exists: {
+                bool found = false;
+                forEachMatch(*expr.subquery, &scope, [&found](long long, const Row&) {
+                    found = true;
+                    return false;
+                });
+                temp = static_cast<long long>(found ? 1 : 0);
+                return temp;
+            }
+            case Expr::Kind::Function: {
+                std::vector<SqlValue> args;
+                for (const auto& arg : expr.args) {
+                    SqlValue arg_temp;
+                    args.push_back(eval(*arg, scope, arg_temp));
+                }
+                temp = callFunction(expr, args);
+                return temp;
+            }
+            case Expr::Kind::Aggregate:
+                throw std::runtime_error("Invalid use of group function");
+            }
+            return temp;
+        }
+
+        // A constraint fails only when it is false; NULL passes, as in MySQL.
+        void checkConstraints(const Table& table, const Row& row) const {
+            RowScope scope{ &row, nullptr };
+            for (const auto& check : table.checks) {
+                SqlValue temp;
+                if (truth(eval(*check.second, scope, temp)) == 0) {
+                    throw std::runtime_error("Check constraint '" + check.first + "' is violated.");
+                }
+            }
+        }
+
+        bool matches(const Expr* where, const Row& row, const RowScope* outer) const {
+            if (!where) {
+                return true;
+            }
+            SqlValue temp;
+            RowScope scope{ &row, outer };
+            return truth(eval(*where, scope, temp)) == 1;
+        }
+
+        /**
+         * Evaluates a select-list expression of an aggregate query over its matched rows.
+         */
+        SqlValue evalAggregate(const Expr& expr, const std::vector<const Row*>& rows) const {
+            if (expr.kind == Expr::Kind::Aggregate) {
+                SqlValue result;
+                aggregate(expr, rows, result);
+                return result;
+            }
+            if (expr.kind == Expr::Kind::Function) {
+                std::vector<SqlValue> args;
+                for (const auto& arg : expr.args) {
+                    args.push_back(evalAggregate(*arg, rows));
+                }
+                return callFunction(expr, args);
+            }
+            if (rows.empty() && referencesInnermost(expr)) {
+                return SqlValue();
+            }
+            SqlValue temp;
+            RowScope scope{ rows.empty() ? nullptr : rows.front(), nullptr };
+            return eval(expr, scope, temp);
+        }
+
+        /**
+         * Calls visit(row_id, row) for every row of the select's table matching
+         * its WHERE clause, in primary key order or index order. An equality on
+         * the primary key or on a prefix of an index narrows the rows read.
+         * visit returns false to stop.
+         */
+        template <typename Visitor>
+        void forEachMatch(const Select& select, const RowScope* outer, Visitor&& visit) const {
+            const Table& table = *select.table;
+            const Expr* where = select.where.get();
+            RowScope lookup_scope{ nullptr, outer };
+            SqlValue temp;
+            for (const auto& equality : select.equalities) {
+                if (equality.first != table.key_column) {
+                    continue;
+                }
+                const SqlValue& value = eval(*equality.second, lookup_scope, temp);
+                if (isNull(value)) {
+                    return;
+                }
+                auto it = table.rows.find(toInteger(value));
+                if (it != table.rows.end() && matches(where, it->second, outer)) {
+                    visit(it->first, it->second);
+                }
+                return;
+            }
+            const Index* best = nullptr;
+            std::vector<const Expr*> best_values;
+            for (const auto& index : table.indexes) {
+                std::vector<const Expr*> values;
+                for (int column : index.columns) {
+                    auto equality = std::find_if(select.equalities.begin(), select.equalities.end(),
+                        [column](const std::pair<int, const Expr*>& entry) { return entry.first == column; });
+                    if (equality == select.equalities.end()) {
+                        break;
+                    }
+                    values.push_back(equality->second);
+                }
+                if (values.size() > best_values.size()) {
+                    best = &index;
+                    best_values = std::move(values);
+                }
+            }
+            if (best) {
+                Row prefix;
+                for (const Expr* value : best_values) {
+                    SqlValue value_temp;
+                    prefix.push_back(eval(*value, lookup_scope, value_temp));
+                    if (isNull(prefix.back())) {
+                        return;
+                    }
+                }
+                for (auto it = best->entries.lower_bound(prefix); it != best->entries.end() && hasPrefix(*it, prefix); ++it) {
+                    long long row_id = toInteger(it->back());
+                    const Row& row = table.rows.at(row_id);
+                    if (matches(where, row, outer) && !visit(row_id, row)) {
+                        return;
+                    }
+                }
+                return;
+            }
+            for (const auto& entry : table.rows) {
+                if (matches(where, entry.second, outer) && !visit(entry.first, entry.second)) {
+                    return;
+                }
+            }
+        }
+
+        long long limitOf(const Select& select) const {
+            if (!select.limit) {
+                return -1;
+            }
+            SqlValue temp;
+            RowScope scope{ nullptr, nullptr };
+            const SqlValue& value = eval(*select.limit, scope, temp);
+            if (isNull(value) || toInteger(value) < 0) {
+                throw std::runtime_error("Incorrect arguments to LIMIT");
+            }
+            return toInteger(value);
+        }
+
+        SqlResult runSelect(const Select& select) const {
+            SqlResult result;
+            result.has_rows = true;
+            for (const auto& item : select.items) {
+                result.columns.push_back(item.label);
+                result.scales.push_back(item.scale);
+            }
+            long long limit = limitOf(select);
+            if (!select.table) {
+                Row row;
+                for (const auto& item : select.items) {
+                    row.push_back(evalAggregate(*item.expr, {}));
+                }
+                if (limit != 0) {
+                    result.rows.push_back(std::move(row));
+                }
+                return result;
+            }
+
+            std::vector<const Row*> matched;
+            bool early_limit = !select.aggregate && select.order.empty() && !select.distinct && limit >= 0;
+            if (!early_limit || limit > 0) {
+                forEachMatch(select, nullptr, [&](long long, const Row& row) {
+                    matched.push_back(&row);
+                    return !early_limit || static_cast<long long>(matched.size()) < limit;
+                });
+            }
+            if (select.aggregate) {
+                Row row;
+                for (const auto& item : select.items) {
+                    row.push_back(evalAggregate(*item.expr, matched));
+                }
+                if (limit != 0) {
+                    result.rows.push_back(std::move(row));
+                }
+                return result;
+            }
+            if (!select.order.empty()) {
+                std::vector<std::pair<Row, const Row*>> keyed;
+                keyed.reserve(matched.size());
+                for (const Row* row : matched) {
+                    Row key;
+                    RowScope scope{ row, nullptr };
+                    for (const auto& item : select.order) {
+                        SqlValue temp;
+                        key.push_back(eval(*item.expr, scope, temp));
+                    }
+                    keyed.emplace_back(std::move(key), row);
+                }
+                std::stable_sort(keyed.begin(), keyed.end(), [&select](const std::pair<Row, const Row*>& a, const std::pair<Row, const Row*>& b) {
+                    for (std::size_t i = 0; i < select.order.size(); ++i) {
+                        int order = compareNullable(a.first[i], b.first[i]);
+                        if (order != 0) {
+                            return (order < 0) != select.order[i].descending;
+                        }
+                    }
+                    return false;
+                });
+                for (std::size_t i = 0; i < keyed.size(); ++i) {
+                    matched[i] = keyed[i].second;
+                }
+            }
+            std::set<Row, KeyLess> seen;
+            for (const Row* source : matched) {
+                if (limit >= 0 && static_cast<long long>(result.rows.size()) >= limit) {
+                    break;
+                }
+                Row row;
+                row.reserve(select.items.size());
+                RowScope scope{ source, nullptr };
+                for (const auto& item : select.items) {
+                    SqlValue temp;
+                    row.push_back(eval(*item.expr, scope, temp));
+                }
+                if (select.distinct && !seen.insert(row).second) {
+                    continue;
+                }
+                result.rows.push_back(std::move(row));
+            }
+            return result;
+        }
+
+        SqlResult runInsert(const InMemoryQuery& query) const {
+            Table& table = *query.select.table;
+            SqlResult result;
+            long long first_generated = 0;
+            RowScope scope{ nullptr, nullptr };
+            for (const auto& values : query.insert_rows) {
+                Row row(table.columns.size());
+                std::vector<bool> given(table.columns.size(), false);
+                for (std::size_t i = 0; i < values.size(); ++i) {
+                    int column = query.insert_columns[i];
+                    SqlValue temp;
+                    row[column] = InMemoryStore::coerce(table.columns[column], eval(*values[i], scope, temp));
+                    given[column] = true;
+                }
+                for (std::size_t column = 0; column < table.columns.size(); ++column) {
+                    const ColumnDef& def = table.columns[column];
+                    if (given[column] || def.auto_increment) {
+                        continue;
+                    }
+                    if (def.default_now) {
+                        row[column] = DateTime().getDateTimeString();
+                    }
+                    else if (def.has_default) {
+                        row[column] = def.default_value;
+                    }
+                    else if (def.not_null) {
+                        throw std::runtime_error("Field '" + def.name + "' doesn't have a default value");
+                    }
+                }
+                if (table.auto_column >= 0) {
+                    SqlValue& key = row[table.auto_column];
+                    if (isNull(key) || toInteger(key) == 0) {
+                        key = table.next_auto_increment++;
+                        if (first_generated == 0) {
+                            first_generated = std::get<long long>(key);
+                        }
+                    }
+                    else if (toInteger(key) >= table.next_auto_increment) {
+                        table.next_auto_increment = toInteger(key) + 1;
+                    }
+                }
+                for (std::size_t column = 0; column < table.columns.size(); ++column) {
+                    InMemoryStore::checkNotNull(table.columns[column], row[column]);
+                }
+                checkConstraints(table, row);
+                store.insertRow(table, std::move(row));
+                ++result.affected_rows;
+            }
+            if (first_generated != 0) {
+                store.last_insert_id = first_generated;
+            }
+            result.first_insert_id = first_generated;
+            return result;
+        }
+
+        SqlResult runUpdate(const InMemoryQuery& query) const {
+            Table& table = *query.select.table;
+            std::vector<long long> row_ids;
+            forEachMatch(query.select, nullptr, [&row_ids](long long row_id, const Row&) {
+                row_ids.push_back(row_id);
+                return true;
+            });
+            SqlResult result;
+            for (long long row_id : row_ids) {
+                const Row& before = table.rows.at(row_id);
+                Row after = before;
+                RowScope scope{ &after, nullptr };
+                for (const auto& assignment : query.assignments) {
+                    const ColumnDef& column = table.columns[assignment.first];
+                    SqlValue temp;
+                    SqlValue value = InMemoryStore::coerce(column, eval(*assignment.second, scope, temp));
+                    InMemoryStore::checkNotNull(column, value);
+                    after[assignment.first] = std::move(value);
+                }
+                bool changed = false;
+                for (std::size_t i = 0; i < after.size() && !changed; ++i) {
+                    changed = isNull(after[i]) != isNull(before[i]) || (!isNull(after[i]) && after[i] != before[i]);
+                }
+                if (changed) {
+                    checkConstraints(table, after);
+                    store.replaceRow(table, row_id, std::move(after));
+                    ++result.affected_rows;
+                }
+            }
+            return result;
+        }
+
+        SqlResult runDelete(const InMemoryQuery& query) const {
+            Table& table = *query.select.table;
+            std::vector<long long> row_ids;
+            forEachMatch(query.select, nullptr, [&row_ids](long long row_id, const Row&) {
+                row_ids.push_back(row_id);
+                return true;
+            });
+            for (long long row_id : row_ids) {
+                store.eraseRow(table, row_id);
+            }
+            SqlResult result;
+            result.affected_rows = static_cast<int>(row_ids.size());
+            return result;
+        }
+    };
+
+    std::string isolationLevelName(const std::string& level) {
+        std::string normalized = toUpper(level);
+        std::replace(normalized.begin(), normalized.end(), '-', ' ');
+        for (const char* known : { "READ UNCOMMITTED", "READ COMMITTED", "REPEATABLE READ", "SERIALIZABLE" }) {
+            if (normalized == known) {
+                std::replace(normalized.begin(), normalized.end(), ' ', '-');
+                return normalized;
+            }
+        }
+        throw std::runtime_error("Unknown transaction isolation level '" + level + "'");
+    }
+}
+
+// Constructors Definition
+InMemoryEngine::InMemoryEngine(const std::string& schema)
+    : store(std::make_unique<InMemoryStore>(schema)) {}
+
+InMemoryEngine::~InMemoryEngine() = default;
+
+// Public Functions Definition
+std::shared_ptr<const InMemoryEngine::Query> InMemoryEngine::prepare(const std::string& sql) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto cached = store->queries.find(sql);
+    if (cached != store->queries.end()) {
+        return cached->second;
+    }
+    std::shared_ptr<const Query> query = store->compile(sql);
+    if (store->queries.size() >= MAX_CACHED_QUERIES) {
+        store->queries.clear();
+    }
+    store->queries.emplace(sql, query);
+    return query;
+}
+
+std::size_t InMemoryEngine::parameterCount(const Query& query) {
+    return query.parameter_count;
+}
+
+SqlResult InMemoryEngine::execute(const Query& query, const std::vector<SqlValue>& params) {
+    if (params.size() < query.parameter_count) {
+        throw std::runtime_error("Value not set for all parameters");
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    Evaluator evaluator(*store, params);
+    switch (query.kind) {
+    case Query::Kind::Select:
+        return evaluator.runSelect(query.select);
+    case Query::Kind::Insert:
+    case Query::Kind::Update:
+    case Query::Kind::Delete: {
+        std::size_t undo_mark = store->undo_log.size();
+        SqlResult result;
+        try {
+            result = query.kind == Query::Kind::Insert ? evaluator.runInsert(query)
+                : query.kind == Query::Kind::Update ? evaluator.runUpdate(query) : evaluator.runDelete(query);
+        }
+        catch (...) {
+            store->undoTo(undo_mark); // A failed statement leaves no partial changes, as in InnoDB.
+            throw;
+        }
+        if (!store->transaction_active) {
+            store->undo_log.clear();
+        }
+        return result;
+    }
+    case Query::Kind::CreateTable:
+        store->undo_log.clear(); // DDL commits the work before it.
+        store->createTable(query.table_def);
+        return SqlResult();
+    case Query::Kind::CreateIndex: {
+        store->undo_log.clear();
+        Table* table = store->findTable(query.index_table);
+        std::vector<int> columns = store->keyColumnIndexes(*table, query.index_def.columns);
+        store->addIndex(*table, query.index_def.name, columns, query.index_def.unique);
+        store->addStatistics(*table, query.index_def.name, columns, query.index_def.unique);
+        return SqlResult();
+    }
+    case Query::Kind::SetIsolation:
+        store->isolation_level = isolationLevelName(query.isolation_level);
+        return SqlResult();
+    case Query::Kind::Use:
+        return SqlResult();
+    }
+    return SqlResult();
+}
+
+void InMemoryEngine::executeScript(const std::string& script) {
+    for (const auto& statement : Parser::splitScript(script)) {
+        execute(*prepare(statement), {});
+    }
+}
+
+void InMemoryEngine::beginTransaction() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (store->transaction_active) {
+        throw std::runtime_error("Transaction already active");
+    }
+    store->transaction_active = true;
+}
+
+void InMemoryEngine::commitTransaction() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!store->transaction_active) {
+        throw std::runtime_error("No active transaction to commit");
+    }
+    store->undo_log.clear();
+    store->transaction_active = false;
+}
+
+void InMemoryEngine::rollbackTransaction() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!store->transaction_active) {
+        throw std::runtime_error("No active transaction to rollback");
+    }
+    store->undoTo(0);
+    store->transaction_active = false;
+}
+
+bool InMemoryEngine::isTransactionActive() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return store->transaction_active;
+}
+
+long long InMemoryEngine::getLastInsertId() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return store->last_insert_id;
+}
+
+std::string InMemoryEngine::getIsolationLevel() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return store->isolation_level;
+}
+
+void InMemoryEngine::setIsolationLevel(const std::string& level) {
+    std::string name = isolationLevelName(level);
+    std::lock_guard<std::mutex> lock(mutex);
+    store->isolation_level = name;
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <variant>
+#include <vector>
+
+/**
+ * @file InMemoryEngine.h
+ * @brief Embedded table store that executes the SQL issued by the repositories.
+ *
+ * The engine parses a small MySQL dialect once per distinct SQL text and runs
+ * it against tables held in process memory:
+ * - SELECT with a column list or `*`, DISTINCT, a single table with an alias,
+ *   WHERE (comparisons, AND/OR/NOT, IN, BETWEEN, IS NULL, correlated
+ *   EXISTS), ORDER BY, LIMIT and FOR UPDATE (accepted, no locking);
+ * - COUNT/MIN/MAX/SUM, COALESCE, DATABASE(), LAST_INSERT_ID(), NOW(),
+ *   LENGTH, CHAR_LENGTH, REGEXP_LIKE, GET_LOCK/RELEASE_LOCK (never wait:
+ *   there is one session) and `@@transaction_isolation`;
+ * - INSERT ... VALUES (one or more rows), UPDATE ... SET ... WHERE and
+ *   DELETE ... WHERE;
+ * - CREATE TABLE [IF NOT EXISTS] in the form written by init.sql and
+ *   SchemaMigrator, CREATE [UNIQUE] INDEX, SET TRANSACTION ISOLATION LEVEL and
+ *   USE.
+ *
+ * Values are stored with their column type: integers, DECIMAL rounded to its
+ * scale, text with the declared length checked, ENUM values checked, and
+ * DATETIME normalized to "YYYY-MM-DD HH:MM:SS". Text compares ignoring ASCII
+ * case, like the utf8mb4_0900_ai_ci collation of the schema. NOT NULL,
+ * AUTO_INCREMENT, DEFAULT, PRIMARY KEY, UNIQUE and CHECK constraints are
+ * enforced with MySQL's error messages; as in MySQL, a CHECK whose result is
+ * NULL passes. REGEXP_LIKE uses std::regex (ECMAScript) rather than ICU, which
+ * agrees on the patterns of init.sql. Foreign keys are not enforced.
+ *
+ * Every table keeps its rows ordered by primary key and a sorted index per
+ * declared key, so `WHERE key = ?` and equality prefixes of an index (for
+ * example `room_number = ?` on idx_bookings_room_dates) are answered without
+ * a full scan. information_schema.statistics lists those indexes.
+ *
+ * The engine behaves like one MySQL session: statements run one at a time
+ * under a mutex, there is at most one transaction, and a rollback replays an
+ * undo log of the rows it changed. DDL is not transactional and, as in
+ * MySQL, makes the changes before it permanent.
+ */
+
+/// A SQL value: NULL, integer, floating point (DOUBLE and DECIMAL) or text (also dates).
+using SqlValue = std::variant<std::monostate, long long, double, std::string>;
+
+/**
+ * @struct SqlResult
+ * @brief Outcome of one executed statement.
+ */
+struct SqlResult {
+    bool has_rows = false;                    ///< Whether the statement produced a result set.
+    std::vector<std::string> columns;         ///< Column labels of the result set.
+    std::vector<int> scales;                  ///< Decimal places of DECIMAL result columns, -1 for other columns.
+    std::vector<std::vector<SqlValue>> rows;  ///< Result rows.
+    int affected_rows = 0;                    ///< Rows inserted, changed or deleted.
+    long long first_insert_id = 0;            ///< First AUTO_INCREMENT key generated, 0 if none.
+};
+
+struct InMemoryStore;   ///< Tables, indexes and undo log (defined in InMemoryEngine.cpp).
+struct InMemoryQuery;   ///< Parsed statement with resolved columns (defined in InMemoryEngine.cpp).
+
+/**
+ * @class InMemoryEngine
+ * @brief In-process SQL engine for one schema.
+ */
+class InMemoryEngine {
+public:
+    using Query = InMemoryQuery;
+
+private:
+    mutable std::mutex mutex;              ///< Serializes every operation, like a single connection.
+    std::unique_ptr<InMemoryStore> store;  ///< Guarded by mutex.
+
+public:
+    /// Maximum number of parsed statements kept for reuse.
+    static constexpr std::size_t MAX_CACHED_QUERIES = 1024;
+
+    /**
+     * @brief Create an empty schema.
+     * @param schema Schema name returned by DATABASE() and used by information_schema.
+     */
+    explicit InMemoryEngine(const std::string& schema);
+    ~InMemoryEngine();
+
+    InMemoryEngine(const InMemoryEngine&) = delete;
+    InMemoryEngine& operator=(const InMemoryEngine&) = delete;
+
+    /**
+     * @brief Parse a statement, or reuse the parse of the same SQL text.
+     * @param sql SQL text with `?` placeholders.
+     * @return std::shared_ptr<const Query> Parsed statement.
+     * @throws std::runtime_error on syntax errors and unknown tables or columns.
+     */
+    std::shared_ptr<const Query> prepare(const std::string& sql);
+
+    /**
+     * @brief Number of `?` placeholders of a parsed statement.
+     * @param query Parsed statement.
+     * @return std::size_t Placeholder count.
+     */
+    static std::size_t parameterCount(const Query& query);
+
+    /**
+     * @brief Run a parsed statement.
+     * @param query Parsed statement.
+     * @param params Placeholder values by index - 1; every placeholder must be bound.
+     * @return SqlResult Result set or affected row count.
+     * @throws std::runtime_error on constraint violations and conversion errors.
+     */
+    SqlResult execute(const Query& query, const std::vector<SqlValue>& params);
+
+    /**
+     * @brief Run a script of `;` separated statements without placeholders (for example init.sql).
+     * @param script SQL script.
+     */
+    void executeScript(const std::string& script);
+
+    void beginTransaction();            ///< @throws std::runtime_error if a transaction is already active.
+    void commitTransaction();           ///< @throws std::runtime_error if no transaction is active.
+    void rollbackTransaction();         ///< @throws std::runtime_error if no transaction is active.
+    bool isTransactionActive() const;
+
+    /**
+     * @brief Key generated by the last INSERT that used AUTO_INCREMENT.
+     * @return long long Same value as LAST_INSERT_ID().
+     */
+    long long getLastInsertId() const;
+
+    /**
+     * @brief Session isolation level, for example "REPEATABLE-READ".
+     *
+     * Recorded for compatibility only: with a single session every level
+     * behaves the same.
+     *
+     * @return std::string Level in `@@transaction_isolation` form.
+     */
+    std::string getIsolationLevel() const;
+
+    /**
+     * @brief Set the session isolation level.
+     * @param level "READ UNCOMMITTED", "READ COMMITTED", "REPEATABLE READ" or "SERIALIZABLE".
+     * @throws std::runtime_error for other levels.
+     */
+    void setIsolationLevel(const std::string& level);
+};
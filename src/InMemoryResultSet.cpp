@@ -0,0 +1,100 @@
+#include "InMemoryResultSet.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+InMemoryResultSet::InMemoryResultSet(SqlResult result)
+    : result(std::move(result)), position(0) {}
+
+const SqlValue& InMemoryResultSet::value(int columnIndex) const {
+    if (position == 0 || position > result.rows.size()) {
+        throw std::runtime_error("ResultSet is not positioned on a row");
+    }
+    if (columnIndex < 1 || static_cast<std::size_t>(columnIndex) > result.columns.size()) {
+        throw std::runtime_error("Invalid column index: " + std::to_string(columnIndex));
+    }
+    return result.rows[position - 1][columnIndex - 1];
+}
+
+int InMemoryResultSet::resolveColumn(const std::string& columnName) const {
+    for (std::size_t i = 0; i < result.columns.size(); ++i) {
+        const std::string& label = result.columns[i];
+        if (label.size() == columnName.size() && std::equal(label.begin(), label.end(), columnName.begin(),
+            [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b)); })) {
+            return static_cast<int>(i + 1);
+        }
+    }
+    throw std::runtime_error("Column not found: " + columnName);
+}
+
+bool InMemoryResultSet::next() {
+    if (position <= result.rows.size()) {
+        ++position;
+    }
+    return position <= result.rows.size();
+}
+
+int InMemoryResultSet::getInt(const std::string& columnName) const { return getInt(resolveColumn(columnName)); }
+double InMemoryResultSet::getDouble(const std::string& columnName) const { return getDouble(resolveColumn(columnName)); }
+std::string InMemoryResultSet::getString(const std::string& columnName) const { return getString(resolveColumn(columnName)); }
+bool InMemoryResultSet::getBoolean(const std::string& columnName) const { return getBoolean(resolveColumn(columnName)); }
+bool InMemoryResultSet::isNull(const std::string& columnName) const { return isNull(resolveColumn(columnName)); }
+
+int InMemoryResultSet::getInt(int columnIndex) const {
+    const SqlValue& cell = value(columnIndex);
+    if (const auto* integer = std::get_if<long long>(&cell)) {
+        return static_cast<int>(*integer);
+    }
+    if (const auto* real = std::get_if<double>(&cell)) {
+        return static_cast<int>(*real);
+    }
+    if (const auto* text = std::get_if<std::string>(&cell)) {
+        return static_cast<int>(std::strtoll(text->c_str(), nullptr, 10));
+    }
+    return 0;
+}
+
+double InMemoryResultSet::getDouble(int columnIndex) const {
+    const SqlValue& cell = value(columnIndex);
+    if (const auto* integer = std::get_if<long long>(&cell)) {
+        return static_cast<double>(*integer);
+    }
+    if (const auto* real = std::get_if<double>(&cell)) {
+        return *real;
+    }
+    if (const auto* text = std::get_if<std::string>(&cell)) {
+        return std::strtod(text->c_str(), nullptr);
+    }
+    return 0;
+}
+
+bool InMemoryResultSet::getBoolean(int columnIndex) const { return getDouble(columnIndex) != 0; }
+
+bool InMemoryResultSet::isNull(int columnIndex) const {
+    return std::holds_alternative<std::monostate>(value(columnIndex));
+}
+
+std::string InMemoryResultSet::getString(int columnIndex) const {
+    const SqlValue& cell = value(columnIndex);
+    if (const auto* text = std::get_if<std::string>(&cell)) {
+        return *text;
+    }
+    if (const auto* integer = std::get_if<long long>(&cell)) {
+        return std::to_string(*integer);
+    }
+    if (const auto* real = std::get_if<double>(&cell)) {
+        char buffer[64];
+        int scale = result.scales[columnIndex - 1];
+        if (scale >= 0) {
+            std::snprintf(buffer, sizeof(buffer), "%.*f", scale, *real);
+        }
+        else {
+            std::snprintf(buffer, sizeof(buffer), "%.15g", *real);
+        }
+        return buffer;
+    }
+    return "";
+}
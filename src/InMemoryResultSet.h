@@ -0,0 +1,56 @@
+#pragma once
+#include "IGenericResultSet.h"
+#include "InMemoryEngine.h"
+#include <cstddef>
+#include <string>
+
+/**
+ * @file InMemoryResultSet.h
+ * @brief IGenericResultSet over the rows returned by InMemoryEngine.
+ *
+ * The result set owns a copy of its rows, so it stays valid while later
+ * statements change the tables. Reads convert values the way the MySQL
+ * driver does: NULL reads as 0 or an empty string, text is parsed as a
+ * number on demand, and DECIMAL columns print with their declared scale.
+ */
+class InMemoryResultSet : public IGenericResultSet {
+    SqlResult result;       ///< Rows and column labels.
+    std::size_t position;   ///< 1-based current row; 0 before the first next().
+
+    /**
+     * @brief Value of a column in the current row.
+     * @param columnIndex 1-based column index.
+     * @return const SqlValue& Cell value.
+     * @throws std::runtime_error when there is no current row or the index is out of range.
+     */
+    const SqlValue& value(int columnIndex) const;
+
+    /**
+     * @brief Translate a column label (case-insensitive) into its 1-based index.
+     * @param columnName Column label.
+     * @return int 1-based column index.
+     * @throws std::runtime_error if no column has this label.
+     */
+    int resolveColumn(const std::string& columnName) const;
+
+public:
+    /**
+     * @brief Wrap the result of a SELECT.
+     * @param result Result returned by InMemoryEngine::execute().
+     */
+    explicit InMemoryResultSet(SqlResult result);
+
+    bool next() override;
+
+    int getInt(const std::string& columnName) const override;
+    double getDouble(const std::string& columnName) const override;
+    std::string getString(const std::string& columnName) const override;
+    bool getBoolean(const std::string& columnName) const override;
+    bool isNull(const std::string& columnName) const override;
+
+    int getInt(int columnIndex) const override;
+    double getDouble(int columnIndex) const override;
+    bool getBoolean(int columnIndex) const override;
+    bool isNull(int columnIndex) const override;
+    std::string getString(int columnIndex) const override;
+};
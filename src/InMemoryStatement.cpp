@@ -0,0 +1,76 @@
+#include "InMemoryStatement.h"
+#include "InMemoryResultSet.h"
+#include <stdexcept>
+
+InMemoryStatement::InMemoryStatement(InMemoryEngine& engine, std::shared_ptr<const InMemoryEngine::Query> query)
+    : engine(engine), query(std::move(query))
+{
+    if (!this->query) throw std::invalid_argument("Query cannot be null");
+    parameters.resize(InMemoryEngine::parameterCount(*this->query));
+}
+
+void InMemoryStatement::bind(int paramIndex, SqlValue value) {
+    if (paramIndex < 1 || static_cast<size_t>(paramIndex) > parameters.size()) {
+        throw std::runtime_error("Invalid parameter index: " + std::to_string(paramIndex));
+    }
+    parameters[paramIndex - 1] = std::move(value);
+}
+
+SqlResult InMemoryStatement::run(const std::vector<SqlValue>& values) const {
+    for (const auto& value : values) {
+        if (std::holds_alternative<std::monostate>(value)) {
+            throw std::runtime_error("Value not set for all parameters");
+        }
+    }
+    return engine.execute(*query, values);
+}
+
+void InMemoryStatement::setInt(int paramIndex, int value) { bind(paramIndex, static_cast<long long>(value)); }
+void InMemoryStatement::setString(int paramIndex, const std::string& value) { bind(paramIndex, value); }
+void InMemoryStatement::setDouble(int paramIndex, double value) { bind(paramIndex, value); }
+void InMemoryStatement::setBoolean(int paramIndex, bool value) { bind(paramIndex, static_cast<long long>(value ? 1 : 0)); }
+
+bool InMemoryStatement::execute() { return run(parameters).has_rows; }
+int InMemoryStatement::executeUpdate() { return run(parameters).affected_rows; }
+int InMemoryStatement::executeInsert() {
+    generated_keys.clear();
+    SqlResult result = run(parameters);
+    if (result.first_insert_id == 0) {
+        throw std::runtime_error("Failed to get last inserted id");
+    }
+    generated_keys.push_back(static_cast<int>(result.first_insert_id));
+    return generated_keys.front();
+}
+std::unique_ptr<IGenericResultSet> InMemoryStatement::executeQuery() const {
+    SqlResult result = run(parameters);
+    if (!result.has_rows) {
+        throw std::runtime_error("Statement did not return a result set");
+    }
+    return std::make_unique<InMemoryResultSet>(std::move(result));
+}
+void InMemoryStatement::clearParameters() { parameters.assign(parameters.size(), SqlValue()); }
+
+void InMemoryStatement::addBatch() { batch.push_back(parameters); }
+
+int InMemoryStatement::executeBatch() {
+    std::vector<std::vector<SqlValue>> rows;
+    rows.swap(batch);
+    generated_keys.clear();
+    for (size_t i = 0; i < rows.size(); ++i) {
+        for (const auto& value : rows[i]) {
+            if (std::holds_alternative<std::monostate>(value)) {
+                throw std::invalid_argument("Batch row " + std::to_string(i + 1) + " has unbound parameters");
+            }
+        }
+    }
+    int affected = 0;
+    for (const auto& row : rows) {
+        SqlResult result = run(row);
+        affected += result.affected_rows;
+        for (int i = 0; i < result.affected_rows && result.first_insert_id != 0; ++i) {
+            generated_keys.push_back(static_cast<int>(result.first_insert_id + i));
+        }
+    }
+    clearParameters();
+    return affected;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "IGenericStatement.h"
+#include "InMemoryEngine.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @file InMemoryStatement.h
+ * @brief IGenericStatement that runs a parsed statement on an InMemoryEngine.
+ *
+ * Bound values are kept per placeholder and passed to the engine on every
+ * execution. Batches run row by row; with no network in between there is
+ * nothing to gain from rewriting them into multi-row INSERTs.
+ */
+class InMemoryStatement : public IGenericStatement {
+    InMemoryEngine& engine;                           ///< Engine owning the tables.
+    std::shared_ptr<const InMemoryEngine::Query> query; ///< Parsed statement.
+    std::vector<SqlValue> parameters;                 ///< Values bound for the current row, by index - 1.
+    std::vector<std::vector<SqlValue>> batch;         ///< Rows queued by addBatch().
+    std::vector<int> generated_keys;                  ///< Keys produced by the last executeInsert() or executeBatch().
+
+    /**
+     * @brief Store a bound value.
+     * @param paramIndex 1-based parameter index.
+     * @param value Bound value.
+     * @throws std::runtime_error if the statement has no such placeholder.
+     */
+    void bind(int paramIndex, SqlValue value);
+
+    /**
+     * @brief Run the statement with the given values.
+     * @param values Placeholder values.
+     * @return SqlResult Engine result.
+     */
+    SqlResult run(const std::vector<SqlValue>& values) const;
+
+public:
+    /**
+     * @brief Create a statement.
+     * @param engine Engine to run on; must outlive the statement.
+     * @param query Statement returned by InMemoryEngine::prepare().
+     * @throws std::invalid_argument if @p query is null.
+     */
+    InMemoryStatement(InMemoryEngine& engine, std::shared_ptr<const InMemoryEngine::Query> query);
+
+    void setInt(int paramIndex, int value) override;
+    void setString(int paramIndex, const std::string& value) override;
+    void setDouble(int paramIndex, double value) override;
+    void setBoolean(int paramIndex, bool value) override;
+
+    bool execute() override;
+    int executeUpdate() override;
+    int executeInsert() override;
+    std::unique_ptr<IGenericResultSet> executeQuery() const override;
+    void clearParameters() override;
+
+    void addBatch() override;
+    int executeBatch() override;
+    std::vector<int> getGeneratedKeys() const override { return generated_keys; }
+};
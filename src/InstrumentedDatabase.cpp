@@ -0,0 +1,162 @@
+#include "InstrumentedDatabase.h"
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Result set that adds up the time spent in next() and reports it once, when destroyed.
+     */
+    class InstrumentedResultSet : public IGenericResultSet {
+    private:
+        std::unique_ptr<IGenericResultSet> inner;
+        QueryProfiler& profiler;
+        std::string key;
+        std::chrono::nanoseconds fetch_time{ 0 };
+        std::uint64_t rows = 0;
+
+    public:
+        InstrumentedResultSet(std::unique_ptr<IGenericResultSet> inner, QueryProfiler& profiler, std::string key)
+            : inner(std::move(inner)), profiler(profiler), key(std::move(key)) {}
+
+        ~InstrumentedResultSet() override {
+            profiler.record(key, QueryProfiler::Phase::Fetch, fetch_time, rows);
+        }
+
+        bool next() override {
+            Clock::time_point start = Clock::now();
+            bool has_row = inner->next();
+            fetch_time += Clock::now() - start;
+            rows += has_row ? 1 : 0;
+            return has_row;
+        }
+
+        int getInt(const std::string& columnName) const override { return inner->getInt(columnName); }
+        double getDouble(const std::string& columnName) const override { return inner->getDouble(columnName); }
+        std::string getString(const std::string& columnName) const override { return inner->getString(columnName); }
+        bool getBoolean(const std::string& columnName) const override { return inner->getBoolean(columnName); }
+        bool isNull(const std::string& columnName) const override { return inner->isNull(columnName); }
+        int getInt(int columnIndex) const override { return inner->getInt(columnIndex); }
+        double getDouble(int columnIndex) const override { return inner->getDouble(columnIndex); }
+        bool getBoolean(int columnIndex) const override { return inner->getBoolean(columnIndex); }
+        bool isNull(int columnIndex) const override { return inner->isNull(columnIndex); }
+        std::string getString(int columnIndex) const override { return inner->getString(columnIndex); }
+    };
+
+    /**
+     * @brief Statement that times every execution, counting the ones that throw as errors.
+     */
+    class InstrumentedStatement : public IGenericStatement {
+    private:
+        std::unique_ptr<IGenericStatement> inner;
+        QueryProfiler& profiler;
+        std::string key;  ///< Normalized SQL, looked up again on every record().
+
+        template <typename Call>
+        auto timed(Call call) const -> decltype(call()) {
+            Clock::time_point start = Clock::now();
+            try {
+                auto result = call();
+                profiler.record(key, QueryProfiler::Phase::Execute, Clock::now() - start);
+                return result;
+            }
+            catch (...) {
+                profiler.record(key, QueryProfiler::Phase::Execute, Clock::now() - start, 0, true);
+                throw;
+            }
+        }
+
+    public:
+        InstrumentedStatement(std::unique_ptr<IGenericStatement> inner, QueryProfiler& profiler, std::string key)
+            : inner(std::move(inner)), profiler(profiler), key(std::move(key)) {}
+
+        void setInt(int paramIndex, int value) override { inner->setInt(paramIndex, value); }
+        void setString(int paramIndex, const std::string& value) override { inner->setString(paramIndex, value); }
+        void setDouble(int paramIndex, double value) override { inner->setDouble(paramIndex, value); }
+        void setBoolean(int paramIndex, bool value) override { inner->setBoolean(paramIndex, value); }
+
+        bool execute() override { return timed([this] { return inner->execute(); }); }
+        int executeUpdate() override { return timed([this] { return inner->executeUpdate(); }); }
+        int executeInsert() override { return timed([this] { return inner->executeInsert(); }); }
+
+        std::unique_ptr<IGenericResultSet> executeQuery() const override {
+            std::unique_ptr<IGenericResultSet> result = timed([this] { return inner->executeQuery(); });
+            return std::make_unique<InstrumentedResultSet>(std::move(result), profiler, key);
+        }
+
+        void clearParameters() override { inner->clearParameters(); }
+        void addBatch() override { inner->addBatch(); }
+        int executeBatch() override { return timed([this] { return inner->executeBatch(); }); }
+        std::vector<int> getGeneratedKeys() const override { return inner->getGeneratedKeys(); }
+    };
+}
+
+// Private Functions Definition
+void InstrumentedDatabase::finishTransaction(Clock::time_point end) {
+    std::lock_guard<std::mutex> lock(transaction_mutex);
+    auto it = transaction_starts.find(std::this_thread::get_id());
+    if (it != transaction_starts.end()) {
+        profiler.record(QueryProfiler::TransactionPhase::Duration, end - it->second);
+        transaction_starts.erase(it);
+    }
+}
+
+void InstrumentedDatabase::disconnect() {}
+
+sql::Connection* InstrumentedDatabase::getConnection() {
+    throw std::logic_error("Database Error: An instrumented database has no driver connection; prepare statements through it instead.");
+}
+
+// Constructors Definition
+InstrumentedDatabase::InstrumentedDatabase(IDatabase& inner) : inner(inner) {}
+
+// Public Functions Definition
+QueryProfiler& InstrumentedDatabase::getProfiler() { return profiler; }
+
+void InstrumentedDatabase::connect(const DatabaseConfig& config) { inner.connect(config); }
+
+std::unique_ptr<IGenericStatement> InstrumentedDatabase::prepareStatement(const std::string& query) {
+    std::string key = QueryProfiler::normalize(query);
+    Clock::time_point start = Clock::now();
+    std::unique_ptr<IGenericStatement> statement = inner.prepareStatement(query);
+    profiler.record(key, QueryProfiler::Phase::Prepare, Clock::now() - start);
+    return std::make_unique<InstrumentedStatement>(std::move(statement), profiler, std::move(key));
+}
+
+bool InstrumentedDatabase::isConnected() const { return inner.isConnected(); }
+
+std::string InstrumentedDatabase::getType() const { return "Instrumented (" + inner.getType() + ")"; }
+
+void InstrumentedDatabase::beginTransaction() {
+    Clock::time_point start = Clock::now();
+    inner.beginTransaction();
+    Clock::time_point end = Clock::now();
+    profiler.record(QueryProfiler::TransactionPhase::Begin, end - start);
+    std::lock_guard<std::mutex> lock(transaction_mutex);
+    transaction_starts[std::this_thread::get_id()] = start;
+}
+
+void InstrumentedDatabase::commitTransaction() {
+    Clock::time_point start = Clock::now();
+    inner.commitTransaction();
+    Clock::time_point end = Clock::now();
+    profiler.record(QueryProfiler::TransactionPhase::Commit, end - start);
+    finishTransaction(end);
+}
+
+void InstrumentedDatabase::rollbackTransaction() {
+    Clock::time_point start = Clock::now();
+    inner.rollbackTransaction();
+    Clock::time_point end = Clock::now();
+    profiler.record(QueryProfiler::TransactionPhase::Rollback, end - start);
+    finishTransaction(end);
+}
+
+bool InstrumentedDatabase::isTransactionActive() { return inner.isTransactionActive(); }
+
+std::string InstrumentedDatabase::getTransactionIsolationLevel() const { return inner.getTransactionIsolationLevel(); }
+
+void InstrumentedDatabase::setTransactionIsolationLevel(const std::string& level) { inner.setTransactionIsolationLevel(level); }
+
+int InstrumentedDatabase::getLastInsertID() { return inner.getLastInsertID(); }
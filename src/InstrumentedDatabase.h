@@ -0,0 +1,93 @@
+#pragma once
+#include "IDatabase.h"
+#include "QueryProfiler.h"
+#include "DatabaseConfig.h"
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @file InstrumentedDatabase.h
+ * @brief IDatabase decorator that measures every statement and transaction.
+ *
+ * InstrumentedDatabase wraps another IDatabase (MySQLDatabase,
+ * MySQLConnectionPool or InMemoryDatabase) and forwards every call to it,
+ * recording the time spent in a QueryProfiler:
+ * @code
+ * MySQLConnectionPool pool;
+ * InstrumentedDatabase database(pool);
+ * database.connect(config);
+ * HotelManager manager(database);
+ * ...
+ * database.getProfiler().report(std::cout);
+ * @endcode
+ * Statements are measured when prepared, executed and while their result
+ * sets are read; ScopedTransaction goes through beginTransaction() and
+ * commitTransaction(), so its transactions are timed too. The wrapped
+ * database must outlive the decorator.
+ */
+class InstrumentedDatabase : public IDatabase {
+private:
+    IDatabase& inner;                 ///< Wrapped database.
+    QueryProfiler profiler;
+    std::mutex transaction_mutex;     ///< Guards transaction_starts.
+    std::map<std::thread::id, std::chrono::steady_clock::time_point> transaction_starts; ///< Begin time per thread.
+
+    /**
+     * @brief Record the begin-to-end duration of the calling thread's transaction.
+     * @param end Time the commit or rollback finished.
+     */
+    void finishTransaction(std::chrono::steady_clock::time_point end);
+
+protected:
+    /**
+     * @brief Does nothing: the wrapped database disconnects itself when destroyed.
+     */
+    void disconnect() override;
+
+    /**
+     * @brief Not supported: statements must go through prepareStatement() to be measured.
+     * @throws std::logic_error always.
+     */
+    sql::Connection* getConnection() override;
+
+public:
+    /**
+     * @brief Wrap a database.
+     * @param inner Database to forward to; must outlive this object.
+     */
+    explicit InstrumentedDatabase(IDatabase& inner);
+
+    /**
+     * @brief Get the collected statistics.
+     * @return QueryProfiler& Profiler fed by this database.
+     */
+    QueryProfiler& getProfiler();
+
+    void connect(const DatabaseConfig& config) override;
+
+    /**
+     * @brief Prepare a statement on the wrapped database, timing it.
+     * @param query SQL query string to prepare.
+     * @return std::unique_ptr<IGenericStatement> Statement whose executions and result sets are timed.
+     */
+    std::unique_ptr<IGenericStatement> prepareStatement(const std::string& query) override;
+
+    bool isConnected() const override;
+
+    /**
+     * @brief Return a human-friendly name for this implementation.
+     * @return std::string "Instrumented " followed by the wrapped type in parentheses.
+     */
+    std::string getType() const override;
+    void beginTransaction() override;
+    void commitTransaction() override;
+    void rollbackTransaction() override;
+    bool isTransactionActive() override;
+    std::string getTransactionIsolationLevel() const override;
+    void setTransactionIsolationLevel(const std::string& level) override;
+    int getLastInsertID() override;
+};
@@ -0,0 +1,111 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file LatencyHistogram.h
+ * @brief Fixed-size log-linear histogram of durations.
+ *
+ * Every power of two of nanoseconds is split into 16 linear buckets, so a
+ * reported percentile is within about 6% of the true value while the
+ * histogram stays a fixed array of counters: recording is a few shifts and
+ * an increment, with no allocation. Durations above MAX_EXPONENT land in
+ * the last bucket.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 4;                      ///< log2 of the buckets per power of two.
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int MAX_EXPONENT = 47;                        ///< About 39 hours in nanoseconds.
+    static constexpr std::size_t BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+private:
+    std::array<std::uint64_t, BUCKET_COUNT> buckets{};
+    std::uint64_t samples = 0;
+    std::uint64_t total_ns = 0;
+    std::uint64_t max_ns = 0;
+
+    static std::size_t bucketOf(std::uint64_t ns) {
+        if (ns < static_cast<std::uint64_t>(SUB_BUCKETS)) {
+            return static_cast<std::size_t>(ns);
+        }
+        int exponent = SUB_BUCKET_BITS;
+        while (exponent < MAX_EXPONENT && (ns >> (exponent + 1)) != 0) {
+            ++exponent;
+        }
+        if ((ns >> (exponent + 1)) != 0) {
+            return BUCKET_COUNT - 1;
+        }
+        std::size_t sub = static_cast<std::size_t>((ns >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+        return static_cast<std::size_t>(exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+    }
+
+    static std::uint64_t lowerBound(std::size_t bucket) {
+        if (bucket < static_cast<std::size_t>(SUB_BUCKETS)) {
+            return bucket;
+        }
+        int exponent = static_cast<int>(bucket / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+        std::uint64_t sub = bucket % SUB_BUCKETS;
+        return (SUB_BUCKETS + sub) << (exponent - SUB_BUCKET_BITS);
+    }
+
+public:
+    /**
+     * @brief Add one duration.
+     * @param duration Measured duration; negative values count as zero.
+     */
+    void record(std::chrono::nanoseconds duration) {
+        std::uint64_t ns = duration.count() > 0 ? static_cast<std::uint64_t>(duration.count()) : 0;
+        ++buckets[bucketOf(ns)];
+        ++samples;
+        total_ns += ns;
+        if (ns > max_ns) {
+            max_ns = ns;
+        }
+    }
+
+    /**
+     * @brief Add every sample of another histogram.
+     * @param other Histogram to merge.
+     */
+    void merge(const LatencyHistogram& other) {
+        for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+            buckets[i] += other.buckets[i];
+        }
+        samples += other.samples;
+        total_ns += other.total_ns;
+        if (other.max_ns > max_ns) {
+            max_ns = other.max_ns;
+        }
+    }
+
+    std::uint64_t count() const { return samples; }                  ///< Number of recorded durations.
+    std::chrono::nanoseconds total() const { return std::chrono::nanoseconds(total_ns); } ///< Sum of all durations.
+    std::chrono::nanoseconds max() const { return std::chrono::nanoseconds(max_ns); }     ///< Longest duration.
+
+    /**
+     * @brief Estimate a percentile.
+     * @param fraction Percentile as a fraction, for example 0.99.
+     * @return std::chrono::nanoseconds Midpoint of the bucket holding the percentile (never above max()), 0 when empty.
+     */
+    std::chrono::nanoseconds percentile(double fraction) const {
+        if (samples == 0) {
+            return std::chrono::nanoseconds(0);
+        }
+        std::uint64_t rank = static_cast<std::uint64_t>(fraction * static_cast<double>(samples) + 0.999999);
+        rank = rank == 0 ? 1 : (rank > samples ? samples : rank);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                std::uint64_t low = lowerBound(i);
+                std::uint64_t high = i + 1 < BUCKET_COUNT ? lowerBound(i + 1) : low;
+                std::uint64_t middle = low + (high - low) / 2;
+                return std::chrono::nanoseconds(static_cast<long long>(middle < max_ns ? middle : max_ns));
+            }
+        }
+        return max();
+    }
+};
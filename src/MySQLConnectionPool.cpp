@@ -0,0 +1,338 @@
+#include "MySQLConnectionPool.h"
+#include "MySQLStatementWrapper.h"
+#include <stdexcept>
+
+namespace {
+    // Keeps the pooled connection leased for as long as a statement (or a
+    // result set produced by it) is alive. The statement is declared last so
+    // it is released before its connection.
+    struct LeasedStatement {
+        std::shared_ptr<void> connection;
+        std::shared_ptr<sql::PreparedStatement> statement;
+    };
+}
+
+// Lease
+MySQLConnectionPool::Lease::Lease(MySQLConnectionPool& pool) : pool(pool) {
+    pool.bindToThread(true);
+}
+
+MySQLConnectionPool::Lease::~Lease() {
+    pool.unbindFromThread(true);
+}
+
+// Private Functions Definition
+std::unique_ptr<MySQLConnectionPool::PooledConnection> MySQLConnectionPool::openConnection(const DatabaseConfig& config) const {
+    auto pooled = std::make_unique<PooledConnection>();
+    pooled->database = std::make_unique<MySQLDatabase>(pool_config.statement_cache_capacity);
+    pooled->database->connect(config);
+    pooled->last_used = std::chrono::steady_clock::now();
+    return pooled;
+}
+
+MySQLConnectionPool::LeasedConnection MySQLConnectionPool::acquire() {
+    const auto deadline = std::chrono::steady_clock::now() + pool_config.wait_timeout;
+    std::unique_ptr<PooledConnection> pooled;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!pooled) {
+        if (!connected) {
+            throw std::runtime_error("Database Error: Connection pool not connected! Call connect() first.");
+        }
+        if (!idle.empty()) {
+            pooled = std::move(idle.back());
+            idle.pop_back();
+            if (std::chrono::steady_clock::now() - pooled->last_used < pool_config.validation_interval) {
+                break;
+            }
+            lock.unlock();
+            bool alive = pooled->database->isAlive();
+            if (!alive) {
+                pooled.reset();
+            }
+            lock.lock();
+            if (!alive) {
+                --open_connections;
+                ++discarded;
+            }
+        }
+        else if (open_connections < pool_config.max_size) {
+            ++open_connections;
+            DatabaseConfig config = *database_config;
+            lock.unlock();
+            try {
+                pooled = openConnection(config);
+            }
+            catch (...) {
+                lock.lock();
+                --open_connections;
+                available.notify_one();
+                throw;
+            }
+            lock.lock();
+        }
+        else if (available.wait_until(lock, deadline) == std::cv_status::timeout
+            && idle.empty() && open_connections >= pool_config.max_size) {
+            ++timeouts;
+            throw std::runtime_error("Database Error: Timed out waiting for a pooled connection");
+        }
+    }
+    std::string level = isolation_level;
+    lock.unlock();
+
+    LeasedConnection leased(pooled.release(), [this](PooledConnection* connection) { release(connection); });
+    if (!level.empty() && leased->isolation_level != level) {
+        leased->database->setTransactionIsolationLevel(level);
+        leased->isolation_level = level;
+    }
+    return leased;
+}
+
+void MySQLConnectionPool::release(PooledConnection* connection) {
+    // Declared before the lock so a dropped connection is closed after it is released.
+    std::unique_ptr<PooledConnection> returned(connection);
+    if (returned->database->isTransactionActive()) {
+        try {
+            returned->database->rollbackTransaction();
+        }
+        catch (...) {
+            returned.reset(); // The session state is unknown; do not reuse it.
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (returned && connected) {
+        returned->last_used = std::chrono::steady_clock::now();
+        idle.push_back(std::move(returned));
+    }
+    else {
+        --open_connections;
+    }
+    available.notify_one();
+}
+
+MySQLConnectionPool::LeasedConnection MySQLConnectionPool::threadConnection() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = bindings.find(std::this_thread::get_id());
+    if (found == bindings.end()) {
+        return nullptr;
+    }
+    return found->second.connection ? found->second.connection : found->second.recent.lock();
+}
+
+MySQLConnectionPool::LeasedConnection MySQLConnectionPool::bindToThread(bool lease) {
+    const auto thread_id = std::this_thread::get_id();
+    LeasedConnection connection;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = bindings.find(thread_id);
+        if (found != bindings.end()) {
+            ThreadBinding& binding = found->second;
+            if (!binding.connection) {
+                binding.connection = binding.recent.lock();
+            }
+            if (binding.connection) {
+                if (lease) {
+                    ++binding.leases;
+                }
+                return binding.connection;
+            }
+        }
+    }
+    connection = acquire();
+    std::lock_guard<std::mutex> lock(mutex);
+    ThreadBinding& binding = bindings[thread_id];
+    binding.connection = connection;
+    binding.recent = connection;
+    binding.leases = lease ? 1 : 0;
+    return connection;
+}
+
+void MySQLConnectionPool::unbindFromThread(bool lease) {
+    // Declared before the lock so the connection is returned after it is released.
+    LeasedConnection unbound;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = bindings.find(std::this_thread::get_id());
+    if (found == bindings.end() || !found->second.connection) {
+        return;
+    }
+    ThreadBinding& binding = found->second;
+    if (lease) {
+        --binding.leases;
+    }
+    if (binding.leases == 0 && !binding.connection->database->isTransactionActive()) {
+        unbound = std::move(binding.connection);
+    }
+}
+
+void MySQLConnectionPool::disconnect() {
+    std::vector<std::unique_ptr<PooledConnection>> closing;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        connected = false;
+        closing.swap(idle);
+        open_connections -= closing.size();
+    }
+    available.notify_all();
+}
+
+sql::Connection* MySQLConnectionPool::getConnection() {
+    throw std::logic_error("Database Error: A connection pool has no single driver connection; use a Lease instead.");
+}
+
+// Constructors Definition
+MySQLConnectionPool::MySQLConnectionPool(const ConnectionPoolConfig& config)
+    : pool_config(config), open_connections(0), timeouts(0), discarded(0), connected(false) {
+    if (config.max_size == 0 || config.max_size < config.min_size) {
+        throw std::invalid_argument("Invalid connection pool size: max_size must be positive and not below min_size");
+    }
+}
+
+// Public Functions Definition
+void MySQLConnectionPool::connect(const DatabaseConfig& config) {
+    disconnect();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        database_config = config;
+        connected = true;
+    }
+    try {
+        for (std::size_t i = 0; i < pool_config.min_size; ++i) {
+            auto pooled = openConnection(config);
+            std::lock_guard<std::mutex> lock(mutex);
+            ++open_connections;
+            idle.push_back(std::move(pooled));
+        }
+    }
+    catch (...) {
+        disconnect();
+        throw;
+    }
+}
+
+std::unique_ptr<IGenericStatement> MySQLConnectionPool::prepareStatement(const std::string& query) {
+    LeasedConnection connection = threadConnection();
+    std::shared_ptr<SlowQueryLog> slow_log;
+    if (!connection) {
+        connection = acquire();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bindings.size() > 4 * pool_config.max_size) {
+            // Forget threads that no longer hold any connection.
+            for (auto it = bindings.begin(); it != bindings.end();) {
+                it = (!it->second.connection && it->second.recent.expired()) ? bindings.erase(it) : std::next(it);
+            }
+        }
+        bindings[std::this_thread::get_id()].recent = connection;
+        slow_log = slow_query_log;
+    }
+    else {
+        std::lock_guard<std::mutex> lock(mutex);
+        slow_log = slow_query_log;
+    }
+    // Batch chunks are prepared on the same leased connection.
+    auto prepare = [connection](const std::string& sql) {
+        auto holder = std::make_shared<LeasedStatement>(
+            LeasedStatement{ connection, connection->database->prepareNativeStatement(sql) });
+        return std::shared_ptr<sql::PreparedStatement>(holder, holder->statement.get());
+    };
+    return std::make_unique<MySQLStatementWrapper>(prepare(query), query, prepare, std::move(slow_log));
+}
+
+bool MySQLConnectionPool::isConnected() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return connected;
+}
+
+std::string MySQLConnectionPool::getType() const { return "MySQL (pooled)"; }
+
+void MySQLConnectionPool::beginTransaction() {
+    LeasedConnection connection = bindToThread(false);
+    try {
+        connection->database->beginTransaction();
+    }
+    catch (...) {
+        unbindFromThread(false);
+        throw;
+    }
+}
+
+void MySQLConnectionPool::commitTransaction() {
+    LeasedConnection connection = threadConnection();
+    if (!connection) {
+        throw std::runtime_error("No active transaction to commit");
+    }
+    try {
+        connection->database->commitTransaction();
+    }
+    catch (...) {
+        unbindFromThread(false);
+        throw;
+    }
+    unbindFromThread(false);
+}
+
+void MySQLConnectionPool::rollbackTransaction() {
+    LeasedConnection connection = threadConnection();
+    if (!connection) {
+        throw std::runtime_error("No active transaction to rollback");
+    }
+    try {
+        connection->database->rollbackTransaction();
+    }
+    catch (...) {
+        unbindFromThread(false);
+        throw;
+    }
+    unbindFromThread(false);
+}
+
+bool MySQLConnectionPool::isTransactionActive() {
+    LeasedConnection connection = threadConnection();
+    return connection && connection->database->isTransactionActive();
+}
+
+std::string MySQLConnectionPool::getTransactionIsolationLevel() const {
+    LeasedConnection connection = threadConnection();
+    if (!connection) {
+        // Leasing changes pool bookkeeping only, not the observable state of the pool.
+        connection = const_cast<MySQLConnectionPool*>(this)->acquire();
+    }
+    return connection->database->getTransactionIsolationLevel();
+}
+
+void MySQLConnectionPool::setTransactionIsolationLevel(const std::string& level) {
+    LeasedConnection connection = threadConnection();
+    if (!connection) {
+        connection = acquire();
+    }
+    connection->database->setTransactionIsolationLevel(level);
+    connection->isolation_level = level;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    isolation_level = level; // Other sessions pick it up on their next lease.
+}
+
+int MySQLConnectionPool::getLastInsertID() {
+    LeasedConnection connection = threadConnection();
+    if (!connection) {
+        throw std::logic_error("getLastInsertID must be called within a transaction or a connection lease");
+    }
+    return connection->database->getLastInsertID();
+}
+
+void MySQLConnectionPool::setSlowQueryLog(std::shared_ptr<SlowQueryLog> log) {
+    std::lock_guard<std::mutex> lock(mutex);
+    slow_query_log = std::move(log);
+}
+
+ConnectionPoolStats MySQLConnectionPool::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    ConnectionPoolStats stats;
+    stats.open = open_connections;
+    stats.idle = idle.size();
+    stats.timeouts = timeouts;
+    stats.discarded = discarded;
+    return stats;
+}
+
+MySQLConnectionPool::~MySQLConnectionPool() { disconnect(); }
@@ -0,0 +1,229 @@
+#pragma once
+#include "IDatabase.h"
+#include "MySQLDatabase.h"
+#include "DatabaseConfig.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file MySQLConnectionPool.h
+ * @brief Pooled IDatabase implementation for concurrent sessions.
+ *
+ * MySQLDatabase owns a single connection with a single transaction flag, so
+ * only one operation can be in flight at a time. MySQLConnectionPool keeps a
+ * set of MySQLDatabase connections and leases them to threads, which lets the
+ * repositories and ScopedTransaction run from many threads against the same
+ * IDatabase reference.
+ */
+
+/**
+ * @struct ConnectionPoolConfig
+ * @brief Sizing and timing parameters of a MySQLConnectionPool.
+ */
+struct ConnectionPoolConfig {
+    std::size_t min_size = 1;  ///< Connections opened by connect() and kept warm.
+    std::size_t max_size = 8;  ///< Upper bound of simultaneously open connections.
+    std::chrono::milliseconds wait_timeout{ 5000 }; ///< Maximum wait for a free connection.
+    std::chrono::milliseconds validation_interval{ 30000 }; ///< Idle time after which a connection is pinged before reuse.
+    std::size_t statement_cache_capacity = MySQLDatabase::DEFAULT_STATEMENT_CACHE_CAPACITY; ///< Per-connection statement cache size.
+};
+
+/**
+ * @struct ConnectionPoolStats
+ * @brief Snapshot of the pool counters, used for diagnostics.
+ */
+struct ConnectionPoolStats {
+    std::size_t open = 0;     ///< Connections currently open (idle + leased).
+    std::size_t idle = 0;     ///< Connections waiting in the pool.
+    std::size_t timeouts = 0; ///< Lease requests that gave up after wait_timeout.
+    std::size_t discarded = 0;///< Idle connections dropped because validation failed.
+};
+
+/**
+ * @class MySQLConnectionPool
+ * @brief IDatabase adapter that leases pooled MySQL connections to threads.
+ *
+ * Connections are bound to the calling thread:
+ *  - beginTransaction() binds a connection until commitTransaction() or
+ *    rollbackTransaction(), so the transaction state is per thread;
+ *  - a Lease binds a connection for a whole scope, for callers that need
+ *    several statements on the same session outside a transaction;
+ *  - prepareStatement() on a thread without a binding leases a connection
+ *    just for the lifetime of the returned statement and its result sets;
+ *    further statements of that thread reuse it while it is still held.
+ *
+ * The pool must outlive every statement and lease obtained from it.
+ */
+class MySQLConnectionPool : public IDatabase {
+    struct PooledConnection {
+        std::unique_ptr<MySQLDatabase> database;             ///< Underlying single connection.
+        std::chrono::steady_clock::time_point last_used;     ///< When the connection was last returned.
+        std::string isolation_level;                         ///< Isolation level applied to this session.
+    };
+    using LeasedConnection = std::shared_ptr<PooledConnection>;
+
+    struct ThreadBinding {
+        LeasedConnection connection;             ///< Connection bound by a lease or transaction.
+        std::weak_ptr<PooledConnection> recent;  ///< Connection still held by the thread's statements.
+        int leases = 0;                          ///< Open Lease scopes on the thread.
+    };
+
+    ConnectionPoolConfig pool_config;
+    std::optional<DatabaseConfig> database_config;           ///< Set by connect().
+    std::vector<std::unique_ptr<PooledConnection>> idle;     ///< Connections ready to be leased.
+    std::size_t open_connections;                            ///< Idle plus leased connections.
+    std::size_t timeouts;
+    std::size_t discarded;
+    std::unordered_map<std::thread::id, ThreadBinding> bindings;
+    std::string isolation_level;                             ///< Level requested for every session; empty for server default.
+    std::shared_ptr<SlowQueryLog> slow_query_log;            ///< Shared by the statements of every connection; may be null.
+    bool connected;
+    mutable std::mutex mutex;                                ///< Guards every member above.
+    std::condition_variable available;                       ///< Signalled when a connection is returned.
+
+    /**
+     * @brief Open a new connection with the stored configuration.
+     * @param config Connection parameters.
+     * @return std::unique_ptr<PooledConnection> Ready connection.
+     */
+    std::unique_ptr<PooledConnection> openConnection(const DatabaseConfig& config) const;
+
+    /**
+     * @brief Lease a connection, waiting up to wait_timeout when the pool is exhausted.
+     * @return LeasedConnection Connection returned to the pool when released.
+     * @throws std::runtime_error when not connected or on timeout.
+     */
+    LeasedConnection acquire();
+
+    /**
+     * @brief Return a leased connection to the pool (deleter of LeasedConnection).
+     * @param connection Connection to return; ownership is transferred.
+     */
+    void release(PooledConnection* connection);
+
+    /**
+     * @brief Connection the calling thread is already using, if any.
+     *
+     * This is the bound connection, or else a connection still held by one of
+     * the thread's statements. Reusing the latter keeps a thread from waiting
+     * for a second connection while holding one, which could deadlock an
+     * exhausted pool.
+     *
+     * @return LeasedConnection Connection in use or nullptr.
+     */
+    LeasedConnection threadConnection() const;
+
+    /**
+     * @brief Bind a connection to the calling thread, reusing an existing binding.
+     * @param lease True when called for a Lease scope.
+     * @return LeasedConnection Bound connection.
+     */
+    LeasedConnection bindToThread(bool lease);
+
+    /**
+     * @brief Drop the thread binding once no lease or transaction needs it.
+     * @param lease True when called for a Lease scope.
+     */
+    void unbindFromThread(bool lease);
+
+protected:
+    /**
+     * @brief Close every idle connection; leased ones are closed when returned.
+     */
+    void disconnect() override;
+
+    /**
+     * @brief Not supported: the pool has no single driver connection.
+     * @throws std::logic_error always.
+     */
+    sql::Connection* getConnection() override;
+
+public:
+    /**
+     * @class Lease
+     * @brief RAII scope that binds one pooled connection to the current thread.
+     *
+     * All IDatabase calls made on the thread while a Lease is alive run on the
+     * same session. Leases nest; the connection goes back to the pool when the
+     * outermost Lease ends and no transaction is active.
+     */
+    class Lease {
+        MySQLConnectionPool& pool;
+    public:
+        explicit Lease(MySQLConnectionPool& pool);
+        ~Lease();
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+    };
+
+    /**
+     * @brief Construct an unconnected pool.
+     * @param config Pool sizing and timing parameters.
+     * @throws std::invalid_argument if max_size is 0 or smaller than min_size.
+     */
+    explicit MySQLConnectionPool(const ConnectionPoolConfig& config = ConnectionPoolConfig());
+
+    /**
+     * @brief Store the connection parameters and open min_size connections.
+     * @param config Database connection parameters.
+     */
+    void connect(const DatabaseConfig& config) override;
+
+    /**
+     * @brief Prepare a statement on the thread's connection, or on a temporary lease.
+     * @param query SQL query string to prepare.
+     * @return std::unique_ptr<IGenericStatement> Statement that keeps its connection leased.
+     */
+    std::unique_ptr<IGenericStatement> prepareStatement(const std::string& query) override;
+
+    /**
+     * @brief Check whether connect() succeeded and the pool is open.
+     * @return true if connections can be leased.
+     */
+    bool isConnected() const override;
+
+    /**
+     * @brief Return a human-friendly name for this implementation.
+     * @return std::string "MySQL (pooled)".
+     */
+    std::string getType() const override;
+
+    void beginTransaction() override;
+    void commitTransaction() override;
+    void rollbackTransaction() override;
+    bool isTransactionActive() override;
+    std::string getTransactionIsolationLevel() const override;
+    void setTransactionIsolationLevel(const std::string& level) override;
+    int getLastInsertID() override;
+
+    /**
+     * @brief Log statements slower than the log's threshold, with their EXPLAIN plan.
+     *
+     * One log serves every pooled connection. Applies to statements prepared afterwards.
+     *
+     * @param log Slow-query log; null to stop logging.
+     */
+    void setSlowQueryLog(std::shared_ptr<SlowQueryLog> log);
+
+    /**
+     * @brief Read the pool counters.
+     * @return ConnectionPoolStats Open/idle connections, timeouts and discards.
+     */
+    ConnectionPoolStats getStats() const;
+
+    MySQLConnectionPool(const MySQLConnectionPool&) = delete;
+    MySQLConnectionPool& operator=(const MySQLConnectionPool&) = delete;
+
+    /**
+     * @brief Destructor that closes the idle connections.
+     */
+    ~MySQLConnectionPool();
+};
@@ -2,7 +2,8 @@
 #include <cppconn/driver.h>
 #include <cppconn/connection.h>
 
-MySQLDatabase::MySQLDatabase():transactionActive(false){}
+MySQLDatabase::MySQLDatabase(std::size_t statement_cache_capacity)
+    :statement_cache_capacity(statement_cache_capacity), transactionActive(false){}
 sql::Connection* MySQLDatabase::getConnection() {
     if (!isConnected()) {
         throw std::runtime_error("Database Error: MySQL database not connected! Call connect() first.");
@@ -11,6 +12,7 @@ sql::Connection* MySQLDatabase::getConnection() {
 }
 
 void MySQLDatabase::disconnect() {
+    statement_cache.reset();
     if (connection) {
         connection->close();
         connection.reset();
@@ -20,8 +22,10 @@ void MySQLDatabase::disconnect() {
 void MySQLDatabase::connect(const DatabaseConfig& config) {
     try {
         auto driver = get_driver_instance();
+        statement_cache.reset();
         connection.reset(driver->connect(config.getServer(), config.getUsername(), config.getPassword()));
         connection->setSchema(config.getSchema());
+        statement_cache = PreparedStatementCache::create(*connection, statement_cache_capacity);
     }
         catch (const std::exception& e) {
             throw std::runtime_error("Database Error: Connection failed: " + std::string(e.what()));
@@ -29,13 +33,28 @@ void MySQLDatabase::connect(const DatabaseConfig& config) {
 }
 
 std::unique_ptr<IGenericStatement> MySQLDatabase::prepareStatement(const std::string& query) {
-    return std::make_unique<MySQLStatementWrapper>(getConnection()->prepareStatement(query));
+    return std::make_unique<MySQLStatementWrapper>(prepareNativeStatement(query), query,
+        [this](const std::string& sql) { return prepareNativeStatement(sql); }, slow_query_log);
+}
+
+std::shared_ptr<sql::PreparedStatement> MySQLDatabase::prepareNativeStatement(const std::string& query) {
+    getConnection(); // throws when not connected
+    return statement_cache->acquire(query);
 }
 
 bool MySQLDatabase::isConnected() const {
     return connection && !connection->isClosed();
 }
 
+bool MySQLDatabase::isAlive() {
+    try {
+        return isConnected() && connection->isValid();
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+}
+
 std::string MySQLDatabase::getType() const { return "MySQL"; }
 
 
@@ -129,4 +148,10 @@ int MySQLDatabase::getLastInsertID() {
         throw std::runtime_error("Failed to get last inserted id");
 }
 
+void MySQLDatabase::setSlowQueryLog(std::shared_ptr<SlowQueryLog> log) { slow_query_log = std::move(log); }
+
+StatementCacheStats MySQLDatabase::getStatementCacheStats() const {
+    return statement_cache ? statement_cache->getStats() : StatementCacheStats{};
+}
+
 MySQLDatabase::~MySQLDatabase() { disconnect(); }
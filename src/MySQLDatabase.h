@@ -1,6 +1,7 @@
 #pragma once
 #include "IDatabase.h"
 #include "MySQLStatementWrapper.h"
+#include "PreparedStatementCache.h"
 #include <cppconn/connection.h>
 #include <cppconn/driver.h>
 #include <cppconn/exception.h>
@@ -20,6 +21,9 @@
 class MySQLDatabase : public IDatabase {
 private:
     std::unique_ptr<sql::Connection> connection; ///< Owning pointer to the driver connection.
+    std::shared_ptr<PreparedStatementCache> statement_cache; ///< Prepared statements of the current connection.
+    std::size_t statement_cache_capacity; ///< Maximum number of idle statements cached per connection.
+    std::shared_ptr<SlowQueryLog> slow_query_log; ///< Receives slow executions; may be null.
     bool transactionActive;
     /**
      * @brief Returns a raw pointer to the driver connection.
@@ -34,10 +38,14 @@ protected:
     void disconnect() override;
 
 public:
+    static constexpr std::size_t DEFAULT_STATEMENT_CACHE_CAPACITY = 64;
+
     /**
      * @brief Default constructor.
+     * @param statement_cache_capacity Maximum number of prepared statements kept
+     *        per connection; 0 disables statement caching.
      */
-    MySQLDatabase();
+    explicit MySQLDatabase(std::size_t statement_cache_capacity = DEFAULT_STATEMENT_CACHE_CAPACITY);
 
     /**
      * @brief Connect to a MySQL server using the supplied configuration.
@@ -47,17 +55,44 @@ public:
 
     /**
      * @brief Prepare a statement wrapper for a SQL query.
+     *
+     * Statements are served from a per-connection LRU cache keyed by the SQL
+     * text, so repeated queries skip the server-side prepare. The returned
+     * statement starts with no bound parameters.
+     *
      * @param query SQL query string to prepare.
      * @return std::unique_ptr<IGenericStatement> Prepared statement adapter.
      */
     std::unique_ptr<IGenericStatement> prepareStatement(const std::string& query) override;
 
+    /**
+     * @brief Check out a cached driver statement for a SQL query.
+     *
+     * Adapter-level variant of prepareStatement() for code that needs to wrap
+     * the driver statement itself (for example the connection pool). The
+     * statement goes back to the cache when the last copy is released.
+     *
+     * @param query SQL query string to prepare.
+     * @return std::shared_ptr<sql::PreparedStatement> Driver statement.
+     */
+    std::shared_ptr<sql::PreparedStatement> prepareNativeStatement(const std::string& query);
+
     /**
      * @brief Check whether a usable connection is established.
      * @return true if connected and the underlying connection is valid.
      */
     bool isConnected() const override;
 
+    /**
+     * @brief Verify the connection with a round trip to the server.
+     *
+     * Unlike isConnected(), which only inspects local state, this detects
+     * connections dropped by the server (for example after wait_timeout).
+     *
+     * @return true if the server answered.
+     */
+    bool isAlive();
+
     /**
      * @brief Return a human-friendly name for this implementation.
      * @return std::string Typically "MySQL".
@@ -70,6 +105,22 @@ public:
      std::string getTransactionIsolationLevel() const override;
      void setTransactionIsolationLevel(const std::string& level) override;
      int getLastInsertID()  override;
+
+    /**
+     * @brief Log statements slower than the log's threshold, with their EXPLAIN plan.
+     *
+     * Applies to statements prepared afterwards.
+     *
+     * @param log Slow-query log, possibly shared with other connections; null to stop logging.
+     */
+    void setSlowQueryLog(std::shared_ptr<SlowQueryLog> log);
+
+    /**
+     * @brief Read the prepared statement cache counters of the current connection.
+     * @return StatementCacheStats Hits, misses, evictions and current size.
+     */
+    StatementCacheStats getStatementCacheStats() const;
+
     /**
      * @brief Destructor that ensures the connection is closed.
      */
@@ -1,19 +1,40 @@
 #include "MySQLResultSetWrapper.h"
 
-MySQLResultSetWrapper::MySQLResultSetWrapper(sql::ResultSet* result_set)
-    : result(result_set)
+MySQLResultSetWrapper::MySQLResultSetWrapper(sql::ResultSet* result_set, std::shared_ptr<sql::PreparedStatement> owner)
+    : statement(std::move(owner)), result(result_set)
 {
     if (!result) {
         throw std::invalid_argument("ResultSet cannot be null");
     }
 }
 
+uint32_t MySQLResultSetWrapper::resolveColumn(const std::string& columnName) const {
+    if (!columns_resolved) {
+        sql::ResultSetMetaData* metadata = result->getMetaData(); // owned by the result set
+        unsigned int column_count = metadata->getColumnCount();
+        column_indexes.reserve(column_count);
+        for (unsigned int column = 1; column <= column_count; ++column) {
+            column_indexes.emplace(metadata->getColumnLabel(column).asStdString(), column);
+        }
+        columns_resolved = true;
+    }
+    auto found = column_indexes.find(columnName);
+    if (found != column_indexes.end()) {
+        return found->second;
+    }
+    uint32_t column = result->findColumn(columnName);
+    if (column != 0) {
+        column_indexes.emplace(columnName, column);
+    }
+    return column;
+}
+
 bool MySQLResultSetWrapper::next() { return result->next(); }
-int MySQLResultSetWrapper::getInt(const std::string& columnName) const { return result->getInt(columnName); }
-std::string MySQLResultSetWrapper::getString(const std::string& columnName) const { return result->getString(columnName); }
-double MySQLResultSetWrapper::getDouble(const std::string& columnName) const { return result->getDouble(columnName); }
-bool MySQLResultSetWrapper::getBoolean(const std::string& columnName) const { return result->getBoolean(columnName); }
-bool MySQLResultSetWrapper::isNull(const std::string& columnName) const { return result->isNull(columnName); }
+int MySQLResultSetWrapper::getInt(const std::string& columnName) const { return result->getInt(resolveColumn(columnName)); }
+std::string MySQLResultSetWrapper::getString(const std::string& columnName) const { return result->getString(resolveColumn(columnName)); }
+double MySQLResultSetWrapper::getDouble(const std::string& columnName) const { return result->getDouble(resolveColumn(columnName)); }
+bool MySQLResultSetWrapper::getBoolean(const std::string& columnName) const { return result->getBoolean(resolveColumn(columnName)); }
+bool MySQLResultSetWrapper::isNull(const std::string& columnName) const { return result->isNull(resolveColumn(columnName)); }
 
 int MySQLResultSetWrapper::getInt(int columnIndex) const { return result->getInt(columnIndex); }
 double MySQLResultSetWrapper::getDouble(int columnIndex) const { return result->getDouble(columnIndex); }
@@ -1,8 +1,13 @@
 #pragma once
 #include "IGenericResultSet.h"
 #include <cppconn/resultset.h>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset_metadata.h>
+#include <cstdint>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <unordered_map>
 
 /**
  * @file MySQLResultSetWrapper.h
@@ -10,9 +15,29 @@
  *
  * The wrapper takes ownership of a raw `sql::ResultSet*` provided by the
  * driver and exposes a driver-agnostic interface used by repository code.
+ * Reads by column name are served through a name-to-index table built once
+ * per result set.
  */
 class MySQLResultSetWrapper : public IGenericResultSet {
+    std::shared_ptr<sql::PreparedStatement> statement; ///< Statement that produced the result; kept alive until the result is closed
     std::unique_ptr<sql::ResultSet> result; ///< Owned driver result set
+    mutable std::unordered_map<std::string, uint32_t> column_indexes; ///< Column label -> 1-based index
+    mutable bool columns_resolved = false; ///< Whether column_indexes was filled from the metadata
+
+    /**
+     * @brief Translate a column name into its 1-based index.
+     *
+     * The first call reads every column label from the result metadata; later
+     * calls are a single hash lookup, so by-name reads no longer make the
+     * driver search its column list for every column of every row. Names that
+     * are not an exact label (for example a different letter case) fall back
+     * to the driver's lookup and are remembered.
+     *
+     * @param columnName Column name as used by the repositories.
+     * @return uint32_t 1-based column index.
+     */
+    uint32_t resolveColumn(const std::string& columnName) const;
+
 public:
     /**
      * @brief Construct the wrapper and assume ownership of the provided result pointer.
@@ -25,9 +50,12 @@ public:
      * @param result_set Raw pointer returned by the driver. Ownership is
      *                   transferred to the wrapper and will be managed via
      *                   std::unique_ptr internally.
+     * @param owner Optional statement that produced @p result_set. The wrapper
+     *              holds it so the statement cannot be reused (for example by
+     *              the statement cache) while this result set is still open.
      * @throws std::invalid_argument if @p result_set is nullptr.
      */
-    MySQLResultSetWrapper(sql::ResultSet* result_set);
+    MySQLResultSetWrapper(sql::ResultSet* result_set, std::shared_ptr<sql::PreparedStatement> owner = nullptr);
 
     MySQLResultSetWrapper(std::unique_ptr<sql::ResultSet>) = delete;
     MySQLResultSetWrapper(const MySQLResultSetWrapper&) = delete;
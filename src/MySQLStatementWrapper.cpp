@@ -1,4 +1,118 @@
 #include "MySQLStatementWrapper.h"
+#include <cppconn/connection.h>
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+    const char* const WHITESPACE = " \t\r\n";
+
+    // Largest power of two not above n (n > 0).
+    size_t floorPowerOfTwo(size_t n) {
+        size_t power = 1;
+        while (power <= n / 2) {
+            power *= 2;
+        }
+        return power;
+    }
+
+    // Splits "INSERT ... VALUES (row)" into the text before the row and the row
+    // itself, so the row can be repeated. Anything else (INSERT ... SELECT,
+    // ON DUPLICATE KEY UPDATE, UPDATE, DELETE) is left alone.
+    bool splitInsertValues(const std::string& query, std::string& head, std::string& row) {
+        std::string upper(query);
+        std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+        size_t start = upper.find_first_not_of(WHITESPACE);
+        if (start == std::string::npos || upper.compare(start, 6, "INSERT") != 0
+            || upper.find("ON DUPLICATE") != std::string::npos) {
+            return false;
+        }
+        size_t values = upper.rfind("VALUES");
+        if (values == std::string::npos || (values > 0 && (std::isalnum(static_cast<unsigned char>(upper[values - 1])) || upper[values - 1] == '_'))) {
+            return false;
+        }
+        size_t open = upper.find_first_not_of(WHITESPACE, values + 6);
+        if (open == std::string::npos || upper[open] != '(') {
+            return false;
+        }
+
+        size_t close = std::string::npos;
+        int depth = 0;
+        char quote = 0;
+        for (size_t i = open; i < query.size() && close == std::string::npos; ++i) {
+            char c = query[i];
+            if (quote) {
+                if (c == quote) quote = 0;
+            }
+            else if (c == '\'' || c == '"' || c == '`') quote = c;
+            else if (c == '(') ++depth;
+            else if (c == ')' && --depth == 0) close = i;
+        }
+        if (close == std::string::npos || upper.find_first_not_of(" \t\r\n;", close + 1) != std::string::npos
+            || std::count(query.begin(), query.begin() + open, '?') != 0) {
+            return false;
+        }
+        head = query.substr(0, open);
+        row = query.substr(open, close - open + 1);
+        return true;
+    }
+
+    // True for INSERT and REPLACE, the statements whose rows get auto-increment keys.
+    bool isInsert(const std::string& query) {
+        size_t start = query.find_first_not_of(WHITESPACE);
+        if (start == std::string::npos) {
+            return false;
+        }
+        std::string verb = query.substr(start, 7);
+        std::transform(verb.begin(), verb.end(), verb.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        return verb.compare(0, 6, "INSERT") == 0 || verb == "REPLACE";
+    }
+
+    template <typename Parameter>
+    void bindRow(sql::PreparedStatement& stmt, const std::vector<Parameter>& row, size_t offset) {
+        for (size_t i = 0; i < row.size(); ++i) {
+            unsigned int index = static_cast<unsigned int>(offset + i + 1);
+            std::visit([&](const auto& value) {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, int>) stmt.setInt(index, value);
+                else if constexpr (std::is_same_v<T, double>) stmt.setDouble(index, value);
+                else if constexpr (std::is_same_v<T, bool>) stmt.setBoolean(index, value);
+                else if constexpr (std::is_same_v<T, std::string>) stmt.setString(index, value);
+            }, row[i]);
+        }
+    }
+
+    /// SQL literals of bound values, for the slow-query log.
+    template <typename Parameter>
+    std::vector<std::string> renderRow(const std::vector<Parameter>& row) {
+        std::vector<std::string> literals;
+        literals.reserve(row.size());
+        for (const auto& parameter : row) {
+            std::visit([&](const auto& value) {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, int>) literals.push_back(std::to_string(value));
+                else if constexpr (std::is_same_v<T, double>) {
+                    std::ostringstream text;
+                    text << value;
+                    literals.push_back(text.str());
+                }
+                else if constexpr (std::is_same_v<T, bool>) literals.push_back(value ? "TRUE" : "FALSE");
+                else if constexpr (std::is_same_v<T, std::string>) {
+                    std::string quoted = "'";
+                    for (char c : value) {
+                        quoted += c == '\'' ? std::string("''") : std::string(1, c);
+                    }
+                    literals.push_back(quoted + "'");
+                }
+                else literals.push_back("NULL");
+            }, parameter);
+        }
+        return literals;
+    }
+}
 
 MySQLStatementWrapper::MySQLStatementWrapper(sql::PreparedStatement* statement)
     : stmt(statement)
@@ -6,14 +120,169 @@ MySQLStatementWrapper::MySQLStatementWrapper(sql::PreparedStatement* statement)
     if (!stmt) throw std::invalid_argument("PreparedStatement cannot be null");
 }
 
-void MySQLStatementWrapper::setInt(int paramIndex, int value) { stmt->setInt(paramIndex, value); }
-void MySQLStatementWrapper::setString(int paramIndex, const std::string& value) { stmt->setString(paramIndex, value); }
-void MySQLStatementWrapper::setDouble(int paramIndex, double value) { stmt->setDouble(paramIndex, value); }
-void MySQLStatementWrapper::setBoolean(int paramIndex, bool value) { stmt->setBoolean(paramIndex, value); }
+MySQLStatementWrapper::MySQLStatementWrapper(std::shared_ptr<sql::PreparedStatement> statement)
+    : stmt(std::move(statement))
+{
+    if (!stmt) throw std::invalid_argument("PreparedStatement cannot be null");
+}
+
+MySQLStatementWrapper::MySQLStatementWrapper(std::shared_ptr<sql::PreparedStatement> statement, std::string query, StatementPreparer preparer,
+    std::shared_ptr<SlowQueryLog> slow_log)
+    : stmt(std::move(statement)), query(std::move(query)), preparer(std::move(preparer)), slow_log(std::move(slow_log))
+{
+    if (!stmt) throw std::invalid_argument("PreparedStatement cannot be null");
+}
+
+void MySQLStatementWrapper::record(int paramIndex, Parameter value) {
+    if (paramIndex < 1) {
+        return; // The driver reports the invalid index.
+    }
+    if (parameters.size() < static_cast<size_t>(paramIndex)) {
+        parameters.resize(paramIndex);
+    }
+    parameters[paramIndex - 1] = std::move(value);
+}
+
+int MySQLStatementWrapper::executeRowByRow(const std::vector<std::vector<Parameter>>& rows) {
+    const bool insert = isInsert(query);
+    int affected = 0;
+    for (const auto& row : rows) {
+        bindRow(*stmt, row, 0);
+        affected += stmt->executeUpdate();
+        if (insert) {
+            collectGeneratedKeys(1);
+        }
+    }
+    return affected;
+}
+
+void MySQLStatementWrapper::collectGeneratedKeys(size_t count) {
+    const std::string query = "SELECT LAST_INSERT_ID()";
+    auto id_stmt = preparer ? preparer(query) : std::shared_ptr<sql::PreparedStatement>(stmt->getConnection()->prepareStatement(query));
+    std::unique_ptr<sql::ResultSet> result(id_stmt->executeQuery());
+    if (!result->next()) {
+        throw std::runtime_error("Failed to get last inserted id");
+    }
+    int first = result->getInt(1);
+    if (first == 0) {
+        return; // The table has no auto-increment column.
+    }
+    for (size_t i = 0; i < count; ++i) {
+        generated_keys.push_back(first + static_cast<int>(i));
+    }
+}
+
+template <typename Call>
+auto MySQLStatementWrapper::timed(Call call, const std::vector<Parameter>& values) const -> decltype(call()) {
+    if (!slow_log || query.empty()) {
+        return call();
+    }
+    auto start = std::chrono::steady_clock::now();
+    auto result = call();
+    auto duration = std::chrono::steady_clock::now() - start;
+    if (slow_log->isSlow(duration)) {
+        slow_log->log(query, renderRow(values), duration, [this, &values] { return explain(values); });
+    }
+    return result;
+}
+
+std::string MySQLStatementWrapper::explain(const std::vector<Parameter>& values) const {
+    const std::string explain_query = "EXPLAIN FORMAT=JSON " + query;
+    auto explain_stmt = preparer ? preparer(explain_query) : std::shared_ptr<sql::PreparedStatement>(stmt->getConnection()->prepareStatement(explain_query));
+    bindRow(*explain_stmt, values, 0);
+    std::unique_ptr<sql::ResultSet> result(explain_stmt->executeQuery());
+    if (!result->next()) {
+        throw std::runtime_error("EXPLAIN returned no plan");
+    }
+    return result->getString(1);
+}
+
+void MySQLStatementWrapper::setInt(int paramIndex, int value) { stmt->setInt(paramIndex, value); record(paramIndex, value); }
+void MySQLStatementWrapper::setString(int paramIndex, const std::string& value) { stmt->setString(paramIndex, value); record(paramIndex, value); }
+void MySQLStatementWrapper::setDouble(int paramIndex, double value) { stmt->setDouble(paramIndex, value); record(paramIndex, value); }
+void MySQLStatementWrapper::setBoolean(int paramIndex, bool value) { stmt->setBoolean(paramIndex, value); record(paramIndex, value); }
 
-bool MySQLStatementWrapper::execute() { return stmt->execute(); }
-int MySQLStatementWrapper::executeUpdate() { return stmt->executeUpdate(); }
+bool MySQLStatementWrapper::execute() { return timed([this] { return stmt->execute(); }, parameters); }
+int MySQLStatementWrapper::executeUpdate() { return timed([this] { return stmt->executeUpdate(); }, parameters); }
+int MySQLStatementWrapper::executeInsert() {
+    generated_keys.clear();
+    timed([this] { return stmt->executeUpdate(); }, parameters);
+    collectGeneratedKeys(1);
+    if (generated_keys.empty()) {
+        throw std::runtime_error("Failed to get last inserted id");
+    }
+    return generated_keys.front();
+}
 std::unique_ptr<IGenericResultSet> MySQLStatementWrapper::executeQuery() const {
-    return std::make_unique<MySQLResultSetWrapper>(stmt->executeQuery());
+    return std::make_unique<MySQLResultSetWrapper>(timed([this] { return stmt->executeQuery(); }, parameters), stmt);
 }
-void MySQLStatementWrapper::clearParameters() { stmt->clearParameters(); }
+void MySQLStatementWrapper::clearParameters() { stmt->clearParameters(); parameters.clear(); }
+
+void MySQLStatementWrapper::addBatch() { batch.push_back(parameters); }
+
+int MySQLStatementWrapper::executeBatch() {
+    std::vector<Parameter> first_row = batch.empty() ? std::vector<Parameter>() : batch.front();
+    return timed([this] { return executeQueuedBatch(); }, first_row);
+}
+
+int MySQLStatementWrapper::executeQueuedBatch() {
+    std::vector<std::vector<Parameter>> rows;
+    rows.swap(batch);
+    generated_keys.clear();
+    if (rows.empty()) {
+        return 0;
+    }
+    const size_t per_row = rows.front().size();
+    bool same_shape = true;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        for (const auto& value : rows[i]) {
+            if (std::holds_alternative<std::monostate>(value)) {
+                throw std::invalid_argument("Batch row " + std::to_string(i + 1) + " has unbound parameters");
+            }
+        }
+        same_shape = same_shape && rows[i].size() == per_row;
+    }
+
+    std::string head;
+    std::string values;
+    if (!preparer || per_row == 0 || !same_shape || !splitInsertValues(query, head, values)
+        || static_cast<size_t>(std::count(values.begin(), values.end(), '?')) != per_row) {
+        int affected = executeRowByRow(rows);
+        clearParameters();
+        return affected;
+    }
+
+    // Chunks are MAX_BATCH_ROWS rows (fewer when the placeholder limit needs it,
+    // then a power of two) and the remainder is split into powers of two, so a
+    // batch of any size uses at most about a dozen distinct INSERT texts and
+    // cannot flush the connection's statement cache.
+    const size_t placeholder_rows = std::max<size_t>(1, MAX_PLACEHOLDERS / per_row);
+    const size_t chunk_rows = placeholder_rows >= MAX_BATCH_ROWS ? MAX_BATCH_ROWS : floorPowerOfTwo(placeholder_rows);
+    std::string chunk_query;
+    size_t chunk_query_rows = 0;
+    int affected = 0;
+    generated_keys.reserve(rows.size());
+    for (size_t first = 0, count = 0; first < rows.size(); first += count) {
+        const size_t remaining = rows.size() - first;
+        count = remaining >= chunk_rows ? chunk_rows : floorPowerOfTwo(remaining);
+        if (count != chunk_query_rows) {
+            chunk_query = head;
+            chunk_query.reserve(head.size() + count * (values.size() + 2));
+            for (size_t i = 0; i < count; ++i) {
+                chunk_query += (i == 0 ? "" : ", ");
+                chunk_query += values;
+            }
+            chunk_query_rows = count;
+        }
+        auto chunk = preparer(chunk_query);
+        for (size_t i = 0; i < count; ++i) {
+            bindRow(*chunk, rows[first + i], i * per_row);
+        }
+        affected += chunk->executeUpdate();
+        collectGeneratedKeys(count);
+    }
+    clearParameters();
+    return affected;
+}
+
+std::vector<int> MySQLStatementWrapper::getGeneratedKeys() const { return generated_keys; }
@@ -1,8 +1,15 @@
 #pragma once
 #include "IGenericStatement.h"
 #include "MySQLResultSetWrapper.h"
+#include "SlowQueryLog.h"
 #include <cppconn/prepared_statement.h>
+#include <chrono>
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <string>
+#include <variant>
+#include <vector>
 
 /**
  * @file MySQLStatementWrapper.h
@@ -11,9 +18,83 @@
  * The wrapper holds the native `sql::PreparedStatement` and exposes the
  * IGenericStatement interface so repository code can bind parameters and
  * execute statements without depending on the MySQL driver API.
+ *
+ * Bound values are also recorded so they can be queued with addBatch(). A
+ * batch of single-row `INSERT ... VALUES (...)` rows is rewritten into
+ * multi-row INSERTs of up to MAX_BATCH_ROWS rows each, which costs one round
+ * trip per chunk instead of one per row. The rows left after the full chunks
+ * go in chunks of powers of two, so only a few chunk texts per statement
+ * reach the prepared statement cache. Other statements run row by row.
+ *
+ * With a SlowQueryLog, every execute*() call is timed and the ones reaching
+ * its threshold are logged with their parameters and, on the first
+ * occurrence, the statement's EXPLAIN plan.
  */
 class MySQLStatementWrapper : public IGenericStatement {
-    std::unique_ptr<sql::PreparedStatement> stmt; ///< Owned driver prepared statement
+public:
+    /// Prepares another statement on the same connection (used for batch chunks and LAST_INSERT_ID()).
+    using StatementPreparer = std::function<std::shared_ptr<sql::PreparedStatement>(const std::string&)>;
+
+    static constexpr std::size_t MAX_BATCH_ROWS = 1000;       ///< Rows per rewritten INSERT.
+    static constexpr std::size_t MAX_PLACEHOLDERS = 65535;    ///< MySQL limit of parameters per prepared statement.
+
+private:
+    using Parameter = std::variant<std::monostate, int, double, bool, std::string>;
+
+    std::shared_ptr<sql::PreparedStatement> stmt; ///< Driver prepared statement, shared with open result sets
+    std::string query;                            ///< SQL text of stmt; empty when unknown.
+    StatementPreparer preparer;                   ///< Empty when batches cannot be rewritten.
+    std::vector<Parameter> parameters;            ///< Values bound for the current row, by index - 1.
+    std::vector<std::vector<Parameter>> batch;    ///< Rows queued by addBatch().
+    std::vector<int> generated_keys;              ///< Keys produced by the last executeInsert() or executeBatch().
+    std::shared_ptr<SlowQueryLog> slow_log;       ///< Receives slow executions; may be null.
+
+    /**
+     * @brief Remember a bound value for addBatch().
+     * @param paramIndex 1-based parameter index.
+     * @param value Bound value.
+     */
+    void record(int paramIndex, Parameter value);
+
+    /**
+     * @brief Execute queued rows one at a time on stmt.
+     *
+     * For an INSERT, LAST_INSERT_ID() is read after every row so getGeneratedKeys()
+     * still returns one key per row when the batch cannot be rewritten.
+     *
+     * @param rows Rows to execute.
+     * @return int Rows affected.
+     */
+    int executeRowByRow(const std::vector<std::vector<Parameter>>& rows);
+
+    /**
+     * @brief Execute the rows queued by addBatch(), rewriting INSERTs into multi-row ones.
+     * @return int Rows affected.
+     */
+    int executeQueuedBatch();
+
+    /**
+     * @brief Record the keys of an INSERT that generated @p count rows.
+     * @param count Number of rows inserted by the last statement.
+     */
+    void collectGeneratedKeys(std::size_t count);
+
+    /**
+     * @brief Run an execution, logging it to slow_log when it is slow.
+     * @param call Execution to run.
+     * @param values Parameters the execution was bound with.
+     * @return Result of @p call.
+     */
+    template <typename Call>
+    auto timed(Call call, const std::vector<Parameter>& values) const -> decltype(call());
+
+    /**
+     * @brief Capture the EXPLAIN FORMAT=JSON plan of query with the given parameters.
+     * @param values Parameters to bind.
+     * @return std::string JSON plan.
+     */
+    std::string explain(const std::vector<Parameter>& values) const;
+
 public:
     /**
      * @brief Construct wrapper and take ownership of the provided native statement.
@@ -21,6 +102,29 @@ public:
      */
     MySQLStatementWrapper(sql::PreparedStatement* statement);
 
+    /**
+     * @brief Construct wrapper around a shared (typically cached) native statement.
+     *
+     * Result sets produced by executeQuery() keep a copy of @p statement, so a
+     * cached statement is only handed back to its cache once both the wrapper
+     * and every result set obtained from it are destroyed.
+     *
+     * @param statement Shared driver prepared statement.
+     * @throws std::invalid_argument if @p statement is empty.
+     */
+    MySQLStatementWrapper(std::shared_ptr<sql::PreparedStatement> statement);
+
+    /**
+     * @brief Construct wrapper that can rewrite batches on its own connection.
+     * @param statement Shared driver prepared statement.
+     * @param query SQL text @p statement was prepared from.
+     * @param preparer Prepares further statements on the same connection.
+     * @param slow_log Log receiving slow executions; null to skip timing.
+     * @throws std::invalid_argument if @p statement is empty.
+     */
+    MySQLStatementWrapper(std::shared_ptr<sql::PreparedStatement> statement, std::string query, StatementPreparer preparer,
+        std::shared_ptr<SlowQueryLog> slow_log = nullptr);
+
     MySQLStatementWrapper(std::unique_ptr<sql::PreparedStatement>) = delete;
     MySQLStatementWrapper(const MySQLStatementWrapper&) = delete;
     MySQLStatementWrapper& operator=(const MySQLStatementWrapper&) = delete;
@@ -71,6 +175,18 @@ public:
      */
     int executeUpdate() override;
 
+    /**
+     * @brief Execute a single-row INSERT and return its auto-increment key.
+     *
+     * Connector/C++ 1.1 does not expose the insert id of the OK packet, so the
+     * key is read with LAST_INSERT_ID() on the same session. That statement
+     * comes from the statement cache, so no prepare round trip is paid.
+     *
+     * @return int Generated key.
+     * @throws std::runtime_error if no key was generated or on driver errors.
+     */
+    int executeInsert() override;
+
     /**
      * @brief Execute a query that returns a result set.
      * @return A unique_ptr owning an `IGenericResultSet` that wraps the native result.
@@ -83,4 +199,28 @@ public:
      * @throws std::runtime_error on driver errors.
      */
     void clearParameters() override;
+
+    /**
+     * @brief Queue the currently bound parameters as one batch row.
+     */
+    void addBatch() override;
+
+    /**
+     * @brief Execute the queued rows, as multi-row INSERTs when possible.
+     *
+     * Generated keys are derived from LAST_INSERT_ID() of each chunk, which
+     * InnoDB allocates consecutively for a multi-row INSERT; this assumes the
+     * server default auto_increment_increment of 1.
+     *
+     * @return int Total rows affected.
+     * @throws std::invalid_argument if a queued row has unbound parameters.
+     * @throws std::runtime_error on driver errors.
+     */
+    int executeBatch() override;
+
+    /**
+     * @brief Keys generated by the last executeInsert() or executeBatch().
+     * @return std::vector<int> One key per inserted row, in batch order.
+     */
+    std::vector<int> getGeneratedKeys() const override;
 };
@@ -0,0 +1,120 @@
+#include "OccupancyCalendar.h"
+#include <algorithm>
+
+namespace {
+	constexpr int NOON = 12 * 60 * 60; ///< Seconds since midnight at which a night starts.
+}
+
+// Private Functions Definition
+std::size_t OccupancyCalendar::slotOf(int room_number) {
+	auto it = room_slots.find(room_number);
+	if (it != room_slots.end()) {
+		return it->second;
+	}
+	if (slot_rooms.size() == slot_capacity) {
+		std::size_t new_capacity = std::max<std::size_t>(BITS_PER_WORD, slot_capacity * 2);
+		std::vector<Word> new_touched(words_per_room * new_capacity, 0);
+		std::vector<Word> new_full(words_per_room * new_capacity, 0);
+		for (std::size_t w = 0; w < words_per_room; ++w) {
+			std::copy_n(touched.begin() + w * slot_capacity, slot_capacity, new_touched.begin() + w * new_capacity);
+			std::copy_n(full.begin() + w * slot_capacity, slot_capacity, new_full.begin() + w * new_capacity);
+		}
+		touched.swap(new_touched);
+		full.swap(new_full);
+		slot_capacity = new_capacity;
+	}
+	std::size_t slot = slot_rooms.size();
+	slot_rooms.push_back(room_number);
+	room_slots.emplace(room_number, slot);
+	return slot;
+}
+
+void OccupancyCalendar::setNights(std::vector<Word>& bits, std::size_t slot, int first, int last) {
+	first = std::max(first, first_night);
+	last = std::min(last, first_night + night_count - 1);
+	for (int night = first; night <= last; ) {
+		int bit = night - first_night;
+		int word = bit / BITS_PER_WORD;
+		int offset = bit % BITS_PER_WORD;
+		int count = std::min(BITS_PER_WORD - offset, last - night + 1);
+		Word mask = (count == BITS_PER_WORD ? ~Word(0) : ((Word(1) << count) - 1)) << offset;
+		bits[word * slot_capacity + slot] |= mask;
+		night += count;
+	}
+}
+
+// Constructors Definition
+OccupancyCalendar::OccupancyCalendar(int first_night, int night_count)
+	: first_night(first_night), night_count(night_count),
+	words_per_room(static_cast<std::size_t>((night_count + BITS_PER_WORD - 1) / BITS_PER_WORD)), slot_capacity(0) {}
+
+// Public Functions Definition
+int OccupancyCalendar::nightOf(const DateTime& time) {
+	return time.getEpochDay() - (time.getSecondOfDay() < NOON ? 1 : 0);
+}
+
+int OccupancyCalendar::lastNightBefore(const DateTime& time) {
+	return time.getEpochDay() - (time.getSecondOfDay() <= NOON ? 1 : 0);
+}
+
+void OccupancyCalendar::reset(int first_night) {
+	this->first_night = first_night;
+	std::fill(touched.begin(), touched.end(), 0);
+	std::fill(full.begin(), full.end(), 0);
+}
+
+bool OccupancyCalendar::covers(const DateTime& check_in, const DateTime& check_out) const {
+	return nightOf(check_in) >= first_night && lastNightBefore(check_out) < first_night + night_count;
+}
+
+void OccupancyCalendar::clearRoom(int room_number) {
+	auto it = room_slots.find(room_number);
+	if (it == room_slots.end()) {
+		return;
+	}
+	for (std::size_t w = 0; w < words_per_room; ++w) {
+		touched[w * slot_capacity + it->second] = 0;
+		full[w * slot_capacity + it->second] = 0;
+	}
+}
+
+void OccupancyCalendar::markStay(int room_number, const DateTime& check_in, const DateTime& check_out) {
+	if (!(check_in < check_out)) {
+		return;
+	}
+	std::size_t slot = slotOf(room_number);
+	setNights(touched, slot, nightOf(check_in), lastNightBefore(check_out));
+	int first_full = check_in.getEpochDay() + (check_in.getSecondOfDay() <= NOON ? 0 : 1);
+	int last_full = check_out.getEpochDay() - (check_out.getSecondOfDay() >= NOON ? 1 : 2);
+	setNights(full, slot, first_full, last_full);
+}
+
+void OccupancyCalendar::scan(const DateTime& check_in, const DateTime& check_out, std::vector<int>& occupied, std::vector<int>& undecided) const {
+	if (!(check_in < check_out) || slot_rooms.empty()) {
+		return;
+	}
+	int first_bit = nightOf(check_in) - first_night;
+	int last_bit = lastNightBefore(check_out) - first_night;
+	std::size_t rooms = slot_rooms.size();
+	std::vector<Word> any_touched(rooms, 0);
+	std::vector<Word> any_full(rooms, 0);
+	for (int word = first_bit / BITS_PER_WORD; word <= last_bit / BITS_PER_WORD; ++word) {
+		int from = std::max(first_bit - word * BITS_PER_WORD, 0);
+		int to = std::min(last_bit - word * BITS_PER_WORD, BITS_PER_WORD - 1);
+		Word mask = (to - from + 1 == BITS_PER_WORD ? ~Word(0) : ((Word(1) << (to - from + 1)) - 1)) << from;
+		const Word* touched_column = touched.data() + word * slot_capacity;
+		const Word* full_column = full.data() + word * slot_capacity;
+		for (std::size_t slot = 0; slot < rooms; ++slot) {
+			any_touched[slot] |= touched_column[slot] & mask;
+			any_full[slot] |= full_column[slot] & mask;
+		}
+	}
+	for (std::size_t slot = 0; slot < rooms; ++slot) {
+		if (any_full[slot] != 0) {
+			occupied.push_back(slot_rooms[slot]);
+		}
+		else if (any_touched[slot] != 0) {
+			undecided.push_back(slot_rooms[slot]);
+		}
+	}
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include "DateTime.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file OccupancyCalendar.h
+ * @brief Bitmap of booked nights per room over a rolling horizon.
+ *
+ * Night n runs from noon of day n to noon of day n + 1, matching the noon
+ * check-in time used by bookings. For every room the calendar keeps two bits
+ * per night of the horizon: "touched" when some booking intersects the night
+ * and "full" when a single booking covers all of it. A stay touching a full
+ * night certainly conflicts, a stay touching no touched night certainly does
+ * not, and anything else (bookings starting or ending off noon) is reported
+ * as undecided so the caller can check the exact times.
+ *
+ * Bits are stored word-major: word w of every room is contiguous, so a scan
+ * ORs the same masked word across all rooms in a loop the compiler can
+ * vectorize. Room numbers are mapped to dense slots, so gaps left by deleted
+ * rooms cost nothing.
+ */
+
+/**
+ * @class OccupancyCalendar
+ * @brief Per-room night bitmaps answering hotel-wide availability scans.
+ */
+class OccupancyCalendar {
+	using Word = std::uint64_t;
+	static constexpr int BITS_PER_WORD = 64;
+
+	int first_night;                          ///< Night number of bit 0.
+	int night_count;                          ///< Nights in the horizon.
+	std::size_t words_per_room;               ///< Words needed for night_count bits.
+	std::size_t slot_capacity;                ///< Rooms each word column has room for.
+	std::vector<Word> touched;                ///< touched[w * slot_capacity + slot]: nights some booking intersects.
+	std::vector<Word> full;                   ///< full[w * slot_capacity + slot]: nights a booking covers entirely.
+	std::unordered_map<int, std::size_t> room_slots; ///< Slot of every room number seen so far.
+	std::vector<int> slot_rooms;              ///< Room number of every slot.
+
+	/**
+	 * @brief Get the slot of a room, adding one (and growing the columns) if needed.
+	 * @param room_number Room number.
+	 * @return std::size_t Slot index.
+	 */
+	std::size_t slotOf(int room_number);
+
+	/**
+	 * @brief Set bits [first, last] of a room's row, clipped to the horizon.
+	 * @param bits Bitmap to update (touched or full).
+	 * @param slot Room slot.
+	 * @param first First night number.
+	 * @param last Last night number (inclusive).
+	 */
+	void setNights(std::vector<Word>& bits, std::size_t slot, int first, int last);
+
+public:
+	/// Default horizon: two years of nights.
+	static constexpr int DEFAULT_HORIZON_NIGHTS = 730;
+
+	/**
+	 * @brief Night containing an instant.
+	 * @param time Instant.
+	 * @return int Night number.
+	 */
+	static int nightOf(const DateTime& time);
+
+	/**
+	 * @brief Night containing the last instant before an exclusive end.
+	 * @param time Exclusive end of a stay.
+	 * @return int Night number.
+	 */
+	static int lastNightBefore(const DateTime& time);
+
+	/**
+	 * @brief Create an empty calendar.
+	 * @param first_night Night number of the first night in the horizon.
+	 * @param night_count Number of nights in the horizon.
+	 */
+	explicit OccupancyCalendar(int first_night = 0, int night_count = DEFAULT_HORIZON_NIGHTS);
+
+	/**
+	 * @brief Drop every booking and move the horizon.
+	 * @param first_night Night number of the first night in the new horizon.
+	 */
+	void reset(int first_night);
+
+	/**
+	 * @brief Night number of the first night in the horizon.
+	 * @return int Night number.
+	 */
+	int getFirstNight() const { return first_night; }
+
+	/**
+	 * @brief Check whether a stay lies entirely inside the horizon.
+	 * @param check_in Start of the stay (inclusive).
+	 * @param check_out End of the stay (exclusive).
+	 * @return true if scan() can answer for this stay.
+	 */
+	bool covers(const DateTime& check_in, const DateTime& check_out) const;
+
+	/**
+	 * @brief Forget every booking of a room.
+	 * @param room_number Room number.
+	 */
+	void clearRoom(int room_number);
+
+	/**
+	 * @brief Mark a booked stay; the part outside the horizon is ignored.
+	 * @param room_number Room number.
+	 * @param check_in Start of the stay (inclusive).
+	 * @param check_out End of the stay (exclusive).
+	 */
+	void markStay(int room_number, const DateTime& check_in, const DateTime& check_out);
+
+	/**
+	 * @brief Classify every room with bookings against a stay.
+	 *
+	 * Rooms the calendar has never seen have no bookings in the horizon and
+	 * are free. The stay must satisfy covers().
+	 *
+	 * @param check_in Start of the stay (inclusive).
+	 * @param check_out End of the stay (exclusive).
+	 * @param occupied Receives rooms with a booking that certainly overlaps the stay.
+	 * @param undecided Receives rooms whose bookings only partly cover a night of the stay.
+	 */
+	void scan(const DateTime& check_in, const DateTime& check_out, std::vector<int>& occupied, std::vector<int>& undecided) const;
+};
@@ -0,0 +1,84 @@
+#include "PreparedStatementCache.h"
+
+PreparedStatementCache::PreparedStatementCache(sql::Connection& connection, std::size_t capacity)
+    : connection(connection), capacity(capacity), hits(0), misses(0), evictions(0) {}
+
+std::shared_ptr<PreparedStatementCache> PreparedStatementCache::create(sql::Connection& connection, std::size_t capacity) {
+    return std::shared_ptr<PreparedStatementCache>(new PreparedStatementCache(connection, capacity));
+}
+
+void PreparedStatementCache::release(const std::string& query, sql::PreparedStatement* statement) {
+    // Declared before the lock so the driver objects are destroyed after it is released.
+    std::unique_ptr<sql::PreparedStatement> returned(statement);
+    std::unique_ptr<sql::PreparedStatement> evicted;
+    try {
+        returned->clearParameters();
+    }
+    catch (...) {
+        return; // A statement that cannot be reset is not safe to hand out again.
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (capacity == 0 || index.count(query) != 0) {
+        return;
+    }
+    entries.emplace_front(query, std::move(returned));
+    index[query] = entries.begin();
+    if (entries.size() > capacity) {
+        evicted = std::move(entries.back().second);
+        index.erase(entries.back().first);
+        entries.pop_back();
+        ++evictions;
+    }
+}
+
+std::shared_ptr<sql::PreparedStatement> PreparedStatementCache::acquire(const std::string& query) {
+    std::unique_ptr<sql::PreparedStatement> statement;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = index.find(query);
+        if (found != index.end()) {
+            statement = std::move(found->second->second);
+            entries.erase(found->second);
+            index.erase(found);
+            ++hits;
+        }
+        else {
+            ++misses;
+        }
+    }
+    if (!statement) {
+        statement.reset(connection.prepareStatement(query));
+    }
+
+    std::weak_ptr<PreparedStatementCache> owner = weak_from_this();
+    return std::shared_ptr<sql::PreparedStatement>(statement.release(),
+        [owner, query](sql::PreparedStatement* stmt) {
+            if (auto cache = owner.lock()) {
+                cache->release(query, stmt);
+            }
+            else {
+                delete stmt;
+            }
+        });
+}
+
+void PreparedStatementCache::clear() {
+    std::list<Entry> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        dropped.swap(entries);
+        index.clear();
+    }
+}
+
+StatementCacheStats PreparedStatementCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    StatementCacheStats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.evictions = evictions;
+    stats.size = entries.size();
+    stats.capacity = capacity;
+    return stats;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <cppconn/connection.h>
+#include <cppconn/prepared_statement.h>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @file PreparedStatementCache.h
+ * @brief Bounded LRU cache of server-side prepared statements for one connection.
+ *
+ * Preparing a statement costs a full round trip to the MySQL server. The
+ * repositories issue the same handful of SQL strings over and over, so the
+ * cache keeps the driver statements alive, keyed by their SQL text, and hands
+ * them out again instead of re-preparing them.
+ */
+
+/**
+ * @struct StatementCacheStats
+ * @brief Snapshot of the cache counters, used for diagnostics.
+ */
+struct StatementCacheStats {
+    std::size_t hits = 0;      ///< Lookups served by an already prepared statement.
+    std::size_t misses = 0;    ///< Lookups that required a server-side prepare.
+    std::size_t evictions = 0; ///< Statements dropped because the cache was full.
+    std::size_t size = 0;      ///< Statements currently idle in the cache.
+    std::size_t capacity = 0;  ///< Maximum number of idle statements kept.
+};
+
+/**
+ * @class PreparedStatementCache
+ * @brief LRU cache of `sql::PreparedStatement` objects keyed by SQL text.
+ *
+ * A statement is checked out of the cache by acquire() and handed back
+ * automatically when the last shared owner releases it (the statement wrapper
+ * and any result set produced from it). Because a checked out statement is
+ * not visible to other callers, two live statements never share bound
+ * parameters or a result set. On return the parameters are cleared; statements
+ * that fail to reset are discarded instead of being cached.
+ *
+ * Instances must be owned by a std::shared_ptr (use create()) so that
+ * statements outliving the cache are simply deleted on release.
+ */
+class PreparedStatementCache : public std::enable_shared_from_this<PreparedStatementCache> {
+    using Entry = std::pair<std::string, std::unique_ptr<sql::PreparedStatement>>;
+
+    sql::Connection& connection; ///< Connection the cached statements belong to.
+    std::size_t capacity;        ///< Maximum number of idle statements kept.
+    std::list<Entry> entries;    ///< Idle statements, most recently used first.
+    std::unordered_map<std::string, std::list<Entry>::iterator> index; ///< SQL text -> entry.
+    std::size_t hits;
+    std::size_t misses;
+    std::size_t evictions;
+    mutable std::mutex mutex;    ///< Guards entries, index and counters.
+
+    PreparedStatementCache(sql::Connection& connection, std::size_t capacity);
+
+    /**
+     * @brief Return a statement to the cache once its last owner is gone.
+     * @param query SQL text the statement was prepared from.
+     * @param statement Statement to reset and cache; ownership is transferred.
+     */
+    void release(const std::string& query, sql::PreparedStatement* statement);
+
+public:
+    /**
+     * @brief Create a cache bound to the given connection.
+     * @param connection Driver connection used to prepare statements on a miss.
+     * @param capacity Maximum number of idle statements kept; 0 disables caching.
+     * @return std::shared_ptr<PreparedStatementCache> The new cache.
+     */
+    static std::shared_ptr<PreparedStatementCache> create(sql::Connection& connection, std::size_t capacity);
+
+    PreparedStatementCache(const PreparedStatementCache&) = delete;
+    PreparedStatementCache& operator=(const PreparedStatementCache&) = delete;
+
+    /**
+     * @brief Check out a prepared statement for the given SQL text.
+     *
+     * Reuses an idle statement when one is cached, otherwise prepares a new one
+     * on the connection. The returned pointer puts the statement back into the
+     * cache when its last copy is destroyed.
+     *
+     * @param query SQL query string to prepare.
+     * @return std::shared_ptr<sql::PreparedStatement> Statement ready for binding.
+     * @throws sql::SQLException if the server rejects the statement.
+     */
+    std::shared_ptr<sql::PreparedStatement> acquire(const std::string& query);
+
+    /**
+     * @brief Drop every idle statement. Checked out statements are unaffected.
+     */
+    void clear();
+
+    /**
+     * @brief Read the cache counters.
+     * @return StatementCacheStats Snapshot of hits, misses, evictions and size.
+     */
+    StatementCacheStats getStats() const;
+};
@@ -0,0 +1,231 @@
+#include "QueryProfiler.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+    bool isIdentifierChar(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+    }
+
+    bool endsWithIgnoreCase(const std::string& text, const std::string& suffix) {
+        if (text.size() < suffix.size()) {
+            return false;
+        }
+        return std::equal(suffix.begin(), suffix.end(), text.end() - suffix.size(),
+            [](char a, char b) { return std::toupper(static_cast<unsigned char>(a)) == std::toupper(static_cast<unsigned char>(b)); });
+    }
+
+    // "IN (?, ?, ?)" -> "IN (?, ...)" and "VALUES (?, ?), (?, ?)" -> "VALUES (?, ?), ..."
+    std::string foldLists(const std::string& sql) {
+        std::string folded;
+        folded.reserve(sql.size());
+        std::size_t i = 0;
+        while (i < sql.size()) {
+            if (sql[i] == '(' && (endsWithIgnoreCase(folded, "IN ") || endsWithIgnoreCase(folded, "IN"))
+                && sql.compare(i, 4, "(?, ") == 0) {
+                std::size_t close = sql.find(')', i);
+                std::string list = sql.substr(i, close == std::string::npos ? std::string::npos : close - i + 1);
+                bool only_placeholders = list.find_first_not_of("(?, )") == std::string::npos;
+                if (only_placeholders) {
+                    folded += "(?, ...)";
+                    i += list.size();
+                    continue;
+                }
+            }
+            if (sql[i] == '(' && endsWithIgnoreCase(folded, "VALUES ")) {
+                std::size_t close = sql.find(')', i);
+                if (close != std::string::npos) {
+                    std::string group = sql.substr(i, close - i + 1);
+                    folded += group;
+                    i = close + 1;
+                    bool repeated = false;
+                    while (sql.compare(i, group.size() + 2, ", " + group) == 0) {
+                        i += group.size() + 2;
+                        repeated = true;
+                    }
+                    if (repeated) {
+                        folded += ", ...";
+                    }
+                    continue;
+                }
+            }
+            folded += sql[i++];
+        }
+        return folded;
+    }
+
+    double toMicroseconds(std::chrono::nanoseconds duration) {
+        return static_cast<double>(duration.count()) / 1000.0;
+    }
+
+    void printPercentiles(std::ostream& out, const LatencyHistogram& histogram) {
+        out << std::setw(9) << toMicroseconds(histogram.percentile(0.50))
+            << std::setw(9) << toMicroseconds(histogram.percentile(0.95))
+            << std::setw(9) << toMicroseconds(histogram.percentile(0.99));
+    }
+}
+
+// Public Functions Definition
+std::string QueryProfiler::normalize(const std::string& sql) {
+    std::string normalized;
+    normalized.reserve(sql.size());
+    bool pending_space = false;
+    for (std::size_t i = 0; i < sql.size(); ) {
+        char c = sql[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            pending_space = !normalized.empty();
+            ++i;
+            continue;
+        }
+        if (pending_space) {
+            normalized += ' ';
+            pending_space = false;
+        }
+        if (c == '\'' || c == '"') {
+            ++i;
+            while (i < sql.size()) {
+                if (sql[i] == '\\') {
+                    i += 2;
+                    continue;
+                }
+                if (sql[i] == c) {
+                    if (i + 1 < sql.size() && sql[i + 1] == c) {
+                        i += 2;
+                        continue;
+                    }
+                    break;
+                }
+                ++i;
+            }
+            ++i;
+            normalized += '?';
+        }
+        else if (c == '`') {
+            std::size_t close = sql.find('`', i + 1);
+            close = close == std::string::npos ? sql.size() - 1 : close;
+            normalized.append(sql, i, close - i + 1);
+            i = close + 1;
+        }
+        else if (std::isdigit(static_cast<unsigned char>(c)) && (normalized.empty() || !isIdentifierChar(normalized.back()))) {
+            while (i < sql.size() && (std::isdigit(static_cast<unsigned char>(sql[i])) || sql[i] == '.')) {
+                ++i;
+            }
+            normalized += '?';
+        }
+        else if (isIdentifierChar(c)) {
+            while (i < sql.size() && isIdentifierChar(sql[i])) {
+                normalized += sql[i++];
+            }
+        }
+        else {
+            normalized += c;
+            ++i;
+        }
+    }
+    return foldLists(normalized);
+}
+
+void QueryProfiler::record(const std::string& key, Phase phase, std::chrono::nanoseconds duration, std::uint64_t rows, bool failed) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = queries.find(key);
+    if (it == queries.end()) {
+        it = queries.emplace(key, QueryStats()).first;
+        it->second.sql = key;
+    }
+    QueryStats& entry = it->second;
+    switch (phase) {
+    case Phase::Prepare:
+        entry.prepare.record(duration);
+        break;
+    case Phase::Execute:
+        entry.execute.record(duration);
+        ++entry.calls;
+        entry.errors += failed ? 1 : 0;
+        break;
+    case Phase::Fetch:
+        entry.fetch.record(duration);
+        entry.rows += rows;
+        break;
+    }
+}
+
+void QueryProfiler::record(TransactionPhase phase, std::chrono::nanoseconds duration) {
+    std::lock_guard<std::mutex> lock(mutex);
+    switch (phase) {
+    case TransactionPhase::Begin: transactions.begin.record(duration); break;
+    case TransactionPhase::Commit: transactions.commit.record(duration); break;
+    case TransactionPhase::Rollback: transactions.rollback.record(duration); break;
+    case TransactionPhase::Duration: transactions.duration.record(duration); break;
+    }
+}
+
+std::vector<QueryStats> QueryProfiler::getQueryStats() const {
+    std::vector<QueryStats> stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.reserve(queries.size());
+        for (const auto& entry : queries) {
+            stats.push_back(entry.second);
+        }
+    }
+    std::stable_sort(stats.begin(), stats.end(), [](const QueryStats& a, const QueryStats& b) {
+        return a.totalTime() > b.totalTime();
+    });
+    return stats;
+}
+
+TransactionStats QueryProfiler::getTransactionStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return transactions;
+}
+
+void QueryProfiler::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    queries.clear();
+    transactions = TransactionStats();
+}
+
+void QueryProfiler::report(std::ostream& out) const {
+    std::vector<QueryStats> stats = getQueryStats();
+    TransactionStats transaction_stats = getTransactionStats();
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+
+    out << "Query profile (" << stats.size() << " statements, latencies in microseconds, by total time)\n";
+    out << std::setw(8) << "calls" << std::setw(8) << "errors" << std::setw(9) << "rows" << std::setw(11) << "total ms"
+        << std::setw(27) << "execute p50/p95/p99" << std::setw(27) << "fetch p50/p95/p99"
+        << std::setw(27) << "prepare p50/p95/p99" << "  sql\n";
+    for (const auto& entry : stats) {
+        out << std::setw(8) << entry.calls << std::setw(8) << entry.errors << std::setw(9) << entry.rows
+            << std::setw(11) << toMicroseconds(entry.totalTime()) / 1000.0;
+        printPercentiles(out, entry.execute);
+        printPercentiles(out, entry.fetch);
+        printPercentiles(out, entry.prepare);
+        out << "  " << entry.sql << '\n';
+    }
+
+    out << "\nTransactions" << std::setw(15) << "count" << std::setw(11) << "total ms" << std::setw(27) << "p50/p95/p99" << '\n';
+    const std::pair<const char*, const LatencyHistogram*> rows[] = {
+        { "begin", &transaction_stats.begin }, { "commit", &transaction_stats.commit },
+        { "rollback", &transaction_stats.rollback }, { "duration", &transaction_stats.duration } };
+    for (const auto& row : rows) {
+        out << "  " << std::left << std::setw(10) << row.first << std::right << std::setw(15) << row.second->count()
+            << std::setw(11) << toMicroseconds(row.second->total()) / 1000.0;
+        printPercentiles(out, *row.second);
+        out << '\n';
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+bool QueryProfiler::writeReport(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    report(file);
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include "LatencyHistogram.h"
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @file QueryProfiler.h
+ * @brief Per-statement call counts and latency histograms.
+ *
+ * Statements are grouped by their normalized SQL text: literals become `?`,
+ * whitespace is collapsed and placeholder lists such as `IN (?, ?, ?)` are
+ * folded into `(?, ...)`, so every call site of a repository method shares
+ * one entry. Each entry keeps separate histograms for prepare, execute and
+ * fetch (reading the result rows), which tells whether time goes to the
+ * server or to walking large results. Transactions are tracked the same way
+ * (begin, commit, rollback and begin-to-end duration).
+ */
+
+/**
+ * @struct QueryStats
+ * @brief Counters of one normalized statement.
+ */
+struct QueryStats {
+    std::string sql;                ///< Normalized SQL text.
+    std::uint64_t calls = 0;        ///< Executions, including failed ones.
+    std::uint64_t errors = 0;       ///< Executions that threw.
+    std::uint64_t rows = 0;         ///< Rows read from result sets.
+    LatencyHistogram prepare;       ///< prepareStatement() time.
+    LatencyHistogram execute;       ///< execute*() time.
+    LatencyHistogram fetch;         ///< Time spent in next() per result set.
+
+    /**
+     * @brief Total time attributed to the statement.
+     * @return std::chrono::nanoseconds Prepare + execute + fetch.
+     */
+    std::chrono::nanoseconds totalTime() const { return prepare.total() + execute.total() + fetch.total(); }
+};
+
+/**
+ * @struct TransactionStats
+ * @brief Transaction timing.
+ */
+struct TransactionStats {
+    LatencyHistogram begin;         ///< beginTransaction() time.
+    LatencyHistogram commit;        ///< commitTransaction() time.
+    LatencyHistogram rollback;      ///< rollbackTransaction() time.
+    LatencyHistogram duration;      ///< Time from begin to the end of commit or rollback.
+};
+
+/**
+ * @class QueryProfiler
+ * @brief Thread-safe registry of QueryStats.
+ */
+class QueryProfiler {
+public:
+    /// Phase of a statement a duration belongs to.
+    enum class Phase { Prepare, Execute, Fetch };
+
+    /// Phase of a transaction a duration belongs to.
+    enum class TransactionPhase { Begin, Commit, Rollback, Duration };
+
+private:
+    mutable std::mutex mutex;                    ///< Guards queries and transactions.
+    std::map<std::string, QueryStats> queries;   ///< By normalized SQL.
+    TransactionStats transactions;
+
+public:
+    /**
+     * @brief Normalize a SQL text for grouping.
+     * @param sql SQL text.
+     * @return std::string Text with literals replaced by `?` and whitespace collapsed.
+     */
+    static std::string normalize(const std::string& sql);
+
+    /**
+     * @brief Record a duration of a statement, creating its entry on first use.
+     *
+     * Statements keep their key rather than a pointer to the entry, so a
+     * statement prepared before reset() records into a fresh entry afterwards.
+     *
+     * @param key Normalized SQL text, as returned by normalize().
+     * @param phase Phase measured; Execute also counts a call.
+     * @param duration Measured duration.
+     * @param rows Rows read (Fetch only).
+     * @param failed Whether the call threw (Execute only).
+     */
+    void record(const std::string& key, Phase phase, std::chrono::nanoseconds duration, std::uint64_t rows = 0, bool failed = false);
+
+    /**
+     * @brief Record a duration of a transaction.
+     * @param phase Phase measured.
+     * @param duration Measured duration.
+     */
+    void record(TransactionPhase phase, std::chrono::nanoseconds duration);
+
+    /**
+     * @brief Copy every statement entry.
+     * @return std::vector<QueryStats> Entries sorted by total time, largest first.
+     */
+    std::vector<QueryStats> getQueryStats() const;
+
+    /**
+     * @brief Copy the transaction timing.
+     * @return TransactionStats Transaction histograms.
+     */
+    TransactionStats getTransactionStats() const;
+
+    /**
+     * @brief Forget everything recorded so far.
+     *
+     * Safe while statements prepared through the profiler are in use.
+     */
+    void reset();
+
+    /**
+     * @brief Print a table of the statements (by total time) and the transactions.
+     * @param out Stream to write to.
+     */
+    void report(std::ostream& out) const;
+
+    /**
+     * @brief Write report() to a file, replacing it.
+     * @param path File path.
+     * @return true if the file was written.
+     */
+    bool writeReport(const std::string& path) const;
+};
@@ -0,0 +1,232 @@
+#include "RecordingDatabase.h"
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Result set that keeps every value the caller reads and writes the query when destroyed.
+     */
+    class RecordingResultSet : public IGenericResultSet {
+    private:
+        std::unique_ptr<IGenericResultSet> inner;
+        std::shared_ptr<TraceWriter> writer;
+        mutable TraceStatement statement;   ///< Execution being recorded; getters add cells to its last row.
+
+        template <typename Value>
+        Value remember(const std::string& column, TraceGetter getter, Value value) const {
+            if (statement.rows.empty()) {
+                return value;
+            }
+            TraceRow& row = statement.rows.back();
+            for (const auto& cell : row) {
+                if (cell.getter == getter && cell.column == column) {
+                    return value;
+                }
+            }
+            if constexpr (std::is_integral_v<Value>) {
+                row.push_back(TraceCell{ column, getter, static_cast<long long>(value) });
+            }
+            else {
+                row.push_back(TraceCell{ column, getter, value });
+            }
+            return value;
+        }
+
+        static std::string indexColumn(int columnIndex) { return "#" + std::to_string(columnIndex); }
+
+    public:
+        RecordingResultSet(std::unique_ptr<IGenericResultSet> inner, std::shared_ptr<TraceWriter> writer, TraceStatement statement)
+            : inner(std::move(inner)), writer(std::move(writer)), statement(std::move(statement)) {}
+
+        ~RecordingResultSet() override { writer->write(statement); }
+
+        bool next() override {
+            Clock::time_point start = Clock::now();
+            bool has_row = inner->next();
+            statement.duration += Clock::now() - start;
+            if (has_row) {
+                statement.rows.emplace_back();
+            }
+            return has_row;
+        }
+
+        int getInt(const std::string& columnName) const override { return remember(columnName, TraceGetter::Int, inner->getInt(columnName)); }
+        double getDouble(const std::string& columnName) const override { return remember(columnName, TraceGetter::Double, inner->getDouble(columnName)); }
+        std::string getString(const std::string& columnName) const override { return remember(columnName, TraceGetter::String, inner->getString(columnName)); }
+        bool getBoolean(const std::string& columnName) const override { return remember(columnName, TraceGetter::Boolean, inner->getBoolean(columnName)); }
+        bool isNull(const std::string& columnName) const override { return remember(columnName, TraceGetter::IsNull, inner->isNull(columnName)); }
+        int getInt(int columnIndex) const override { return remember(indexColumn(columnIndex), TraceGetter::Int, inner->getInt(columnIndex)); }
+        double getDouble(int columnIndex) const override { return remember(indexColumn(columnIndex), TraceGetter::Double, inner->getDouble(columnIndex)); }
+        bool getBoolean(int columnIndex) const override { return remember(indexColumn(columnIndex), TraceGetter::Boolean, inner->getBoolean(columnIndex)); }
+        bool isNull(int columnIndex) const override { return remember(indexColumn(columnIndex), TraceGetter::IsNull, inner->isNull(columnIndex)); }
+        std::string getString(int columnIndex) const override { return remember(indexColumn(columnIndex), TraceGetter::String, inner->getString(columnIndex)); }
+    };
+
+    /**
+     * @brief Statement that tracks its bound parameters and records each execution.
+     */
+    class RecordingStatement : public IGenericStatement {
+    private:
+        std::unique_ptr<IGenericStatement> inner;
+        std::shared_ptr<TraceWriter> writer;
+        std::string sql;
+        std::vector<SqlValue> parameters;               ///< Values bound for the current row, by index - 1.
+        std::vector<std::vector<SqlValue>> batch;       ///< Rows queued by addBatch().
+
+        void bind(int paramIndex, SqlValue value) {
+            if (paramIndex >= 1) {
+                if (parameters.size() < static_cast<std::size_t>(paramIndex)) {
+                    parameters.resize(static_cast<std::size_t>(paramIndex));
+                }
+                parameters[paramIndex - 1] = std::move(value);
+            }
+        }
+
+        TraceStatement begin(TraceCall call) const {
+            TraceStatement statement;
+            statement.sql = sql;
+            statement.call = call;
+            if (call == TraceCall::ExecuteBatch) {
+                statement.parameters = batch;
+            }
+            else {
+                statement.parameters.push_back(parameters);
+            }
+            return statement;
+        }
+
+        /// Run a call, filling duration, result and error; failures are written and rethrown.
+        template <typename Call>
+        auto recorded(TraceStatement& statement, Call call) const -> decltype(call()) {
+            Clock::time_point start = Clock::now();
+            try {
+                auto result = call();
+                statement.duration = Clock::now() - start;
+                return result;
+            }
+            catch (const std::exception& e) {
+                statement.duration = Clock::now() - start;
+                statement.failed = true;
+                statement.error = e.what();
+                writer->write(statement);
+                throw;
+            }
+        }
+
+        template <typename Call>
+        long long run(TraceCall kind, Call call) {
+            TraceStatement statement = begin(kind);
+            long long result = recorded(statement, call);
+            statement.result = result;
+            if (kind == TraceCall::ExecuteInsert || kind == TraceCall::ExecuteBatch) {
+                statement.generated_keys = inner->getGeneratedKeys();
+            }
+            writer->write(statement);
+            return result;
+        }
+
+    public:
+        RecordingStatement(std::unique_ptr<IGenericStatement> inner, std::shared_ptr<TraceWriter> writer, std::string sql)
+            : inner(std::move(inner)), writer(std::move(writer)), sql(std::move(sql)) {}
+
+        void setInt(int paramIndex, int value) override { inner->setInt(paramIndex, value); bind(paramIndex, static_cast<long long>(value)); }
+        void setString(int paramIndex, const std::string& value) override { inner->setString(paramIndex, value); bind(paramIndex, value); }
+        void setDouble(int paramIndex, double value) override { inner->setDouble(paramIndex, value); bind(paramIndex, value); }
+        void setBoolean(int paramIndex, bool value) override { inner->setBoolean(paramIndex, value); bind(paramIndex, static_cast<long long>(value)); }
+
+        bool execute() override {
+            return run(TraceCall::Execute, [this] { return static_cast<long long>(inner->execute()); }) != 0;
+        }
+
+        int executeUpdate() override {
+            return static_cast<int>(run(TraceCall::ExecuteUpdate, [this] { return static_cast<long long>(inner->executeUpdate()); }));
+        }
+
+        int executeInsert() override {
+            return static_cast<int>(run(TraceCall::ExecuteInsert, [this] { return static_cast<long long>(inner->executeInsert()); }));
+        }
+
+        std::unique_ptr<IGenericResultSet> executeQuery() const override {
+            TraceStatement statement = begin(TraceCall::ExecuteQuery);
+            std::unique_ptr<IGenericResultSet> result = recorded(statement, [this] { return inner->executeQuery(); });
+            return std::make_unique<RecordingResultSet>(std::move(result), writer, std::move(statement));
+        }
+
+        void clearParameters() override {
+            inner->clearParameters();
+            parameters.clear();
+        }
+
+        void addBatch() override {
+            inner->addBatch();
+            batch.push_back(parameters);
+        }
+
+        int executeBatch() override {
+            int result = static_cast<int>(run(TraceCall::ExecuteBatch, [this] { return static_cast<long long>(inner->executeBatch()); }));
+            batch.clear();
+            return result;
+        }
+
+        std::vector<int> getGeneratedKeys() const override { return inner->getGeneratedKeys(); }
+    };
+
+    /// Time a transaction call and record it once it returned.
+    template <typename Call>
+    void recordTransaction(TraceWriter& writer, TraceTransaction kind, Call call) {
+        Clock::time_point start = Clock::now();
+        call();
+        writer.writeTransaction(kind, Clock::now() - start);
+    }
+}
+
+// Private Functions Definition
+void RecordingDatabase::disconnect() { writer->flush(); }
+
+sql::Connection* RecordingDatabase::getConnection() {
+    throw std::logic_error("Database Error: A recording database has no driver connection; prepare statements through it instead.");
+}
+
+// Constructors Definition
+RecordingDatabase::RecordingDatabase(IDatabase& inner, const std::string& trace_path)
+    : inner(inner), writer(std::make_shared<TraceWriter>(trace_path)) {}
+
+// Public Functions Definition
+void RecordingDatabase::connect(const DatabaseConfig& config) { inner.connect(config); }
+
+std::unique_ptr<IGenericStatement> RecordingDatabase::prepareStatement(const std::string& query) {
+    return std::make_unique<RecordingStatement>(inner.prepareStatement(query), writer, query);
+}
+
+bool RecordingDatabase::isConnected() const { return inner.isConnected(); }
+
+std::string RecordingDatabase::getType() const { return "Recording (" + inner.getType() + ")"; }
+
+void RecordingDatabase::beginTransaction() {
+    recordTransaction(*writer, TraceTransaction::Begin, [this] { inner.beginTransaction(); });
+}
+
+void RecordingDatabase::commitTransaction() {
+    recordTransaction(*writer, TraceTransaction::Commit, [this] { inner.commitTransaction(); });
+}
+
+void RecordingDatabase::rollbackTransaction() {
+    recordTransaction(*writer, TraceTransaction::Rollback, [this] { inner.rollbackTransaction(); });
+}
+
+bool RecordingDatabase::isTransactionActive() { return inner.isTransactionActive(); }
+
+std::string RecordingDatabase::getTransactionIsolationLevel() const {
+    std::string level = inner.getTransactionIsolationLevel();
+    writer->writeIsolationLevel(level);
+    return level;
+}
+
+void RecordingDatabase::setTransactionIsolationLevel(const std::string& level) { inner.setTransactionIsolationLevel(level); }
+
+int RecordingDatabase::getLastInsertID() { return inner.getLastInsertID(); }
+
+RecordingDatabase::~RecordingDatabase() { disconnect(); }
@@ -0,0 +1,83 @@
+#pragma once
+#include "IDatabase.h"
+#include "SessionTrace.h"
+#include "DatabaseConfig.h"
+#include <memory>
+#include <string>
+
+/**
+ * @file RecordingDatabase.h
+ * @brief IDatabase decorator that records a session to a trace file.
+ *
+ * RecordingDatabase forwards every call to the wrapped database and writes
+ * what happened to a SessionTrace file: each execution with its SQL, bound
+ * parameters, return value or error message, generated keys, the cells the
+ * caller read from the result set and the time the call took, plus
+ * transaction boundaries. ReplayDatabase serves the file back without a
+ * server:
+ * @code
+ * MySQLConnectionPool pool;
+ * RecordingDatabase database(pool, "session.trace");
+ * database.connect(config);
+ * HotelManager manager(database);
+ * @endcode
+ * A query is written when its result set is destroyed, so the trace holds
+ * exactly the rows and columns the application consumed. Parameters and
+ * results are stored verbatim: a trace of production traffic contains
+ * customer data and must be handled like a database dump.
+ */
+class RecordingDatabase : public IDatabase {
+private:
+    IDatabase& inner;                      ///< Wrapped database.
+    std::shared_ptr<TraceWriter> writer;   ///< Shared with statements, which may outlive a flush.
+
+protected:
+    /**
+     * @brief Flush the trace; the wrapped database disconnects itself when destroyed.
+     */
+    void disconnect() override;
+
+    /**
+     * @brief Not supported: statements must go through prepareStatement() to be recorded.
+     * @throws std::logic_error always.
+     */
+    sql::Connection* getConnection() override;
+
+public:
+    /**
+     * @brief Wrap a database and start a trace file.
+     * @param inner Database to forward to; must outlive this object.
+     * @param trace_path File to create, replacing an existing one.
+     * @throws std::runtime_error if the file cannot be created.
+     */
+    RecordingDatabase(IDatabase& inner, const std::string& trace_path);
+
+    void connect(const DatabaseConfig& config) override;
+
+    /**
+     * @brief Prepare a statement on the wrapped database.
+     * @param query SQL query string to prepare.
+     * @return std::unique_ptr<IGenericStatement> Statement whose executions are recorded.
+     */
+    std::unique_ptr<IGenericStatement> prepareStatement(const std::string& query) override;
+
+    bool isConnected() const override;
+
+    /**
+     * @brief Return a human-friendly name for this implementation.
+     * @return std::string "Recording " followed by the wrapped type in parentheses.
+     */
+    std::string getType() const override;
+    void beginTransaction() override;
+    void commitTransaction() override;
+    void rollbackTransaction() override;
+    bool isTransactionActive() override;
+    std::string getTransactionIsolationLevel() const override;
+    void setTransactionIsolationLevel(const std::string& level) override;
+    int getLastInsertID() override;
+
+    /**
+     * @brief Destructor. Flushes the trace.
+     */
+    ~RecordingDatabase();
+};
@@ -0,0 +1,292 @@
+#include "ReplayDatabase.h"
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    long long toInteger(const SqlValue& value) {
+        if (const auto* integer = std::get_if<long long>(&value)) {
+            return *integer;
+        }
+        if (const auto* real = std::get_if<double>(&value)) {
+            return static_cast<long long>(*real);
+        }
+        if (const auto* text = std::get_if<std::string>(&value)) {
+            return std::strtoll(text->c_str(), nullptr, 10);
+        }
+        return 0;
+    }
+
+    double toReal(const SqlValue& value) {
+        if (const auto* real = std::get_if<double>(&value)) {
+            return *real;
+        }
+        if (const auto* text = std::get_if<std::string>(&value)) {
+            return std::strtod(text->c_str(), nullptr);
+        }
+        return static_cast<double>(toInteger(value));
+    }
+
+    std::string toText(const SqlValue& value) {
+        if (const auto* text = std::get_if<std::string>(&value)) {
+            return *text;
+        }
+        if (const auto* integer = std::get_if<long long>(&value)) {
+            return std::to_string(*integer);
+        }
+        if (const auto* real = std::get_if<double>(&value)) {
+            char formatted[32];
+            std::snprintf(formatted, sizeof(formatted), "%.17g", *real);
+            return formatted;
+        }
+        return "";
+    }
+
+    /**
+     * @brief Result set over the rows of a recorded query.
+     */
+    class ReplayResultSet : public IGenericResultSet {
+    private:
+        const TraceStatement& statement;
+        std::size_t position = 0;      ///< 1-based row, 0 before the first next().
+
+        /// Cell read by the same getter during recording, else any cell of the column.
+        const TraceCell& cell(const std::string& column, TraceGetter getter) const {
+            if (position == 0 || position > statement.rows.size()) {
+                throw std::runtime_error("ResultSet is not positioned on a row");
+            }
+            const TraceRow& row = statement.rows[position - 1];
+            const TraceCell* fallback = nullptr;
+            for (const auto& recorded : row) {
+                if (recorded.column == column) {
+                    if (recorded.getter == getter) {
+                        return recorded;
+                    }
+                    if (recorded.getter != TraceGetter::IsNull && getter != TraceGetter::IsNull) {
+                        fallback = &recorded;
+                    }
+                }
+            }
+            if (fallback == nullptr) {
+                throw std::runtime_error("Database Error: Replay trace did not read column " + column + " of: " + statement.sql);
+            }
+            return *fallback;
+        }
+
+        static std::string indexColumn(int columnIndex) { return "#" + std::to_string(columnIndex); }
+
+    public:
+        explicit ReplayResultSet(const TraceStatement& statement) : statement(statement) {}
+
+        bool next() override {
+            if (position <= statement.rows.size()) {
+                ++position;
+            }
+            return position <= statement.rows.size();
+        }
+
+        int getInt(const std::string& columnName) const override { return static_cast<int>(toInteger(cell(columnName, TraceGetter::Int).value)); }
+        double getDouble(const std::string& columnName) const override { return toReal(cell(columnName, TraceGetter::Double).value); }
+        std::string getString(const std::string& columnName) const override { return toText(cell(columnName, TraceGetter::String).value); }
+        bool getBoolean(const std::string& columnName) const override { return toInteger(cell(columnName, TraceGetter::Boolean).value) != 0; }
+        bool isNull(const std::string& columnName) const override { return toInteger(cell(columnName, TraceGetter::IsNull).value) != 0; }
+        int getInt(int columnIndex) const override { return getInt(indexColumn(columnIndex)); }
+        double getDouble(int columnIndex) const override { return getDouble(indexColumn(columnIndex)); }
+        bool getBoolean(int columnIndex) const override { return getBoolean(indexColumn(columnIndex)); }
+        bool isNull(int columnIndex) const override { return isNull(indexColumn(columnIndex)); }
+        std::string getString(int columnIndex) const override { return getString(indexColumn(columnIndex)); }
+    };
+
+    /**
+     * @brief Statement that collects its parameters and asks the ReplayDatabase for each execution.
+     */
+    class ReplayStatement : public IGenericStatement {
+    private:
+        ReplayDatabase& database;
+        std::string sql;
+        std::vector<SqlValue> parameters;               ///< Values bound for the current row, by index - 1.
+        std::vector<std::vector<SqlValue>> batch;       ///< Rows queued by addBatch().
+        std::vector<int> generated_keys;                ///< Keys of the last replayed executeInsert() or executeBatch().
+
+        void bind(int paramIndex, SqlValue value) {
+            if (paramIndex >= 1) {
+                if (parameters.size() < static_cast<std::size_t>(paramIndex)) {
+                    parameters.resize(static_cast<std::size_t>(paramIndex));
+                }
+                parameters[paramIndex - 1] = std::move(value);
+            }
+        }
+
+        const TraceStatement& replay(TraceCall call, const std::vector<std::vector<SqlValue>>& values) const {
+            const TraceStatement& recorded = database.replay(sql, call, values);
+            if (recorded.failed) {
+                throw std::runtime_error(recorded.error);
+            }
+            return recorded;
+        }
+
+        const TraceStatement& replay(TraceCall call) const { return replay(call, { parameters }); }
+
+    public:
+        ReplayStatement(ReplayDatabase& database, std::string sql) : database(database), sql(std::move(sql)) {}
+
+        void setInt(int paramIndex, int value) override { bind(paramIndex, static_cast<long long>(value)); }
+        void setString(int paramIndex, const std::string& value) override { bind(paramIndex, value); }
+        void setDouble(int paramIndex, double value) override { bind(paramIndex, value); }
+        void setBoolean(int paramIndex, bool value) override { bind(paramIndex, static_cast<long long>(value)); }
+
+        bool execute() override { return replay(TraceCall::Execute).result != 0; }
+        int executeUpdate() override { return static_cast<int>(replay(TraceCall::ExecuteUpdate).result); }
+
+        int executeInsert() override {
+            const TraceStatement& recorded = replay(TraceCall::ExecuteInsert);
+            generated_keys = recorded.generated_keys;
+            return static_cast<int>(recorded.result);
+        }
+
+        std::unique_ptr<IGenericResultSet> executeQuery() const override {
+            return std::make_unique<ReplayResultSet>(replay(TraceCall::ExecuteQuery));
+        }
+
+        void clearParameters() override { parameters.clear(); }
+        void addBatch() override { batch.push_back(parameters); }
+
+        int executeBatch() override {
+            std::vector<std::vector<SqlValue>> rows;
+            rows.swap(batch);
+            const TraceStatement& recorded = replay(TraceCall::ExecuteBatch, rows);
+            generated_keys = recorded.generated_keys;
+            return static_cast<int>(recorded.result);
+        }
+
+        std::vector<int> getGeneratedKeys() const override { return generated_keys; }
+    };
+}
+
+// Private Functions Definition
+void ReplayDatabase::disconnect() {
+    transaction_active = false;
+    connected = false;
+}
+
+sql::Connection* ReplayDatabase::getConnection() { return nullptr; }
+
+// Constructors Definition
+ReplayDatabase::ReplayDatabase(const std::string& trace_path)
+    : trace(SessionTrace::load(trace_path)), last_insert_id(0), transaction_active(false), connected(false) {
+    for (const auto& statement : trace.statements) {
+        recordings[executionKey(statement.sql, statement.call, statement.parameters)].statements.push_back(&statement);
+    }
+    isolation_level = trace.isolation_level.empty() ? "REPEATABLE-READ" : trace.isolation_level;
+}
+
+// Public Functions Definition
+std::string ReplayDatabase::executionKey(const std::string& sql, TraceCall call, const std::vector<std::vector<SqlValue>>& parameters) {
+    std::string key = sql;
+    key += '\x1f';
+    key += static_cast<char>('0' + static_cast<int>(call));
+    for (const auto& row : parameters) {
+        key += '\x1e';
+        for (const auto& value : row) {
+            // The type tag keeps 1 and '1' apart, the length keeps text from spilling into the next value.
+            key += std::holds_alternative<std::monostate>(value) ? 'N'
+                : std::holds_alternative<long long>(value) ? 'I'
+                : std::holds_alternative<double>(value) ? 'D' : 'S';
+            std::string text = toText(value);
+            key += std::to_string(text.size());
+            key += ':';
+            key += text;
+        }
+    }
+    return key;
+}
+
+const TraceStatement& ReplayDatabase::replay(const std::string& sql, TraceCall call, const std::vector<std::vector<SqlValue>>& parameters) {
+    if (!connected) {
+        throw std::runtime_error("Database Error: replay database not connected! Call connect() first.");
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = recordings.find(executionKey(sql, call, parameters));
+    if (it == recordings.end()) {
+        ++stats.missing;
+        throw std::runtime_error("Database Error: Replay trace has no recording of: " + sql);
+    }
+    Recordings& found = it->second;
+    const TraceStatement* recorded;
+    if (found.next < found.statements.size()) {
+        recorded = found.statements[found.next++];
+    }
+    else {
+        recorded = found.statements.back();
+        ++stats.repeated;
+    }
+    ++stats.served;
+    stats.recorded_time += recorded->duration;
+    if (!recorded->failed && call == TraceCall::ExecuteInsert) {
+        last_insert_id = static_cast<int>(recorded->result);
+    }
+    else if (!recorded->failed && !recorded->generated_keys.empty()) {
+        last_insert_id = recorded->generated_keys.front();
+    }
+    return *recorded;
+}
+
+ReplayStats ReplayDatabase::getReplayStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void ReplayDatabase::connect(const DatabaseConfig&) { connected = true; }
+
+std::unique_ptr<IGenericStatement> ReplayDatabase::prepareStatement(const std::string& query) {
+    if (!connected) {
+        throw std::runtime_error("Database Error: replay database not connected! Call connect() first.");
+    }
+    return std::make_unique<ReplayStatement>(*this, query);
+}
+
+bool ReplayDatabase::isConnected() const { return connected; }
+
+std::string ReplayDatabase::getType() const { return "Replay"; }
+
+void ReplayDatabase::beginTransaction() {
+    if (!connected) {
+        throw std::runtime_error("Cannot begin transaction: not connected to database");
+    }
+    if (transaction_active) {
+        throw std::runtime_error("Transaction already active");
+    }
+    transaction_active = true;
+}
+
+void ReplayDatabase::commitTransaction() {
+    if (!transaction_active) {
+        throw std::runtime_error("No active transaction to commit");
+    }
+    transaction_active = false;
+}
+
+void ReplayDatabase::rollbackTransaction() {
+    if (!transaction_active) {
+        throw std::runtime_error("No active transaction to rollback");
+    }
+    transaction_active = false;
+}
+
+bool ReplayDatabase::isTransactionActive() { return transaction_active; }
+
+std::string ReplayDatabase::getTransactionIsolationLevel() const { return isolation_level; }
+
+void ReplayDatabase::setTransactionIsolationLevel(const std::string& level) {
+    std::string normalized = level;
+    for (char& c : normalized) {
+        c = c == ' ' ? '-' : c;
+    }
+    isolation_level = normalized;
+}
+
+int ReplayDatabase::getLastInsertID() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return last_insert_id;
+}
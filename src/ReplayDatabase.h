@@ -0,0 +1,144 @@
+#pragma once
+#include "IDatabase.h"
+#include "SessionTrace.h"
+#include "DatabaseConfig.h"
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file ReplayDatabase.h
+ * @brief IDatabase implementation that answers from a recorded SessionTrace.
+ *
+ * ReplayDatabase needs no server: every execution is looked up in a trace
+ * written by RecordingDatabase by its SQL text, method and bound parameters,
+ * and gets the recorded return value, generated keys, rows or exception.
+ * Running the same trace before and after a change therefore exercises the
+ * repository and model layers on identical data with no network or server
+ * time in the profile:
+ * @code
+ * ReplayDatabase database("session.trace");
+ * database.connect(DatabaseConfig("hotelmanagement", "", "", ""));
+ * HotelManager manager(database);
+ * @endcode
+ * Identical executions are served in recording order, and the last one is
+ * repeated once they are used up, so a changed caller that reads the same
+ * row twice still replays. An execution that was never recorded throws, as
+ * does reading a column the recording never read. Transactions only toggle
+ * isTransactionActive(); writes do not change later answers.
+ */
+
+/**
+ * @struct ReplayStats
+ * @brief Counters of a replay, used to spot divergence from the recording.
+ */
+struct ReplayStats {
+    std::size_t served = 0;                         ///< Executions answered by a recorded execution.
+    std::size_t repeated = 0;                       ///< Of which answered again after their recordings were used up.
+    std::size_t missing = 0;                        ///< Executions with no recording (they threw).
+    std::chrono::nanoseconds recorded_time{ 0 };    ///< Time the served executions took when recorded.
+};
+
+/**
+ * @class ReplayDatabase
+ * @brief Server-less IDatabase serving the executions of a SessionTrace.
+ */
+class ReplayDatabase : public IDatabase {
+private:
+    /// Recordings of one execution key, served in order.
+    struct Recordings {
+        std::vector<const TraceStatement*> statements;
+        std::size_t next = 0;
+    };
+
+    SessionTrace trace;
+    std::map<std::string, Recordings> recordings;   ///< By execution key (SQL, method, parameters).
+    ReplayStats stats;
+    std::string isolation_level;
+    int last_insert_id;
+    bool transaction_active;
+    bool connected;
+    mutable std::mutex mutex;                       ///< Guards recordings, stats and last_insert_id.
+
+protected:
+    /**
+     * @brief Mark the database disconnected.
+     */
+    void disconnect() override;
+
+    /**
+     * @brief No driver connection exists.
+     * @return sql::Connection* Always nullptr.
+     */
+    sql::Connection* getConnection() override;
+
+public:
+    /**
+     * @brief Key identifying executions that must get the same answer.
+     * @param sql SQL text.
+     * @param call Method called.
+     * @param parameters Bound values; one row per batch row.
+     * @return std::string Key.
+     */
+    static std::string executionKey(const std::string& sql, TraceCall call, const std::vector<std::vector<SqlValue>>& parameters);
+
+    /**
+     * @brief Load a trace.
+     * @param trace_path File written by RecordingDatabase.
+     * @throws std::runtime_error if the file cannot be read.
+     */
+    explicit ReplayDatabase(const std::string& trace_path);
+
+    /**
+     * @brief Find the recording answering an execution.
+     * @param sql SQL text.
+     * @param call Method called.
+     * @param parameters Bound values; one row per batch row.
+     * @return const TraceStatement& Recorded execution.
+     * @throws std::runtime_error if the trace holds no such execution.
+     */
+    const TraceStatement& replay(const std::string& sql, TraceCall call, const std::vector<std::vector<SqlValue>>& parameters);
+
+    /**
+     * @brief Copy the replay counters.
+     * @return ReplayStats Counters since construction.
+     */
+    ReplayStats getReplayStats() const;
+
+    /**
+     * @brief Mark the database connected; the configuration is ignored.
+     * @param config Unused.
+     */
+    void connect(const DatabaseConfig& config) override;
+
+    /**
+     * @brief Create a statement answered from the trace.
+     * @param query SQL query string.
+     * @return std::unique_ptr<IGenericStatement> Statement with no bound parameters.
+     */
+    std::unique_ptr<IGenericStatement> prepareStatement(const std::string& query) override;
+
+    bool isConnected() const override;
+
+    /**
+     * @brief Return a human-friendly name for this implementation.
+     * @return std::string "Replay".
+     */
+    std::string getType() const override;
+    void beginTransaction() override;
+    void commitTransaction() override;
+    void rollbackTransaction() override;
+    bool isTransactionActive() override;
+    std::string getTransactionIsolationLevel() const override;
+    void setTransactionIsolationLevel(const std::string& level) override;
+
+    /**
+     * @brief Key generated by the last replayed insert.
+     * @return int First generated key of the last replayed executeInsert() or executeBatch(), 0 if none.
+     */
+    int getLastInsertID() override;
+};
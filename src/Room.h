@@ -1,6 +1,7 @@
 #pragma once
 
 #include<string>
+#include <memory>
 
 /**
   * @class Room
@@ -54,6 +55,11 @@ public:
 	 * @virtual
 	 */
 	virtual double getTotalPrice()const =0;
+	/**
+	 * @brief Copies the room, keeping its concrete type.
+	 * @return std::unique_ptr<Room> Independent copy of this room.
+	 */
+	virtual std::unique_ptr<Room> clone()const = 0;
 	/**
 	 * @brief Sets price per night for the room.
 	 * @param price_ The new price per night.
@@ -1,42 +1,57 @@
 #include "RoomRepository.h"
 #include "Suite.h"
 #include "ScopedTransaction.h"
-//Private Functions Definition
-std::unique_ptr<Room> RoomRepository::createRoomFromRow(const IGenericResultSet& result)const {
-	int room_number = result.getInt("room_number");
-	std::string status = result.getString("status");
-	std::string type = result.getString("room_type");
-	double base_price = result.getDouble("base_price");
-	if (type == "standard") {
-		return std::make_unique<StandardRoom>(room_number, base_price, status);
-	}
-	else if (type == "deluxe") {
-		double extra_fees = result.getDouble("extra_fees");
-		return std::make_unique<DeluxeRoom>(room_number, base_price, status, extra_fees);
-	}
-	else if (type == "suite") {
-		bool has_jacuzzi = result.getBoolean("has_jacuzzi");
-		double jacuzzi_cost = result.getDouble("jacuzzi_cost");
-		return std::make_unique<Suite>(room_number, base_price, status, has_jacuzzi, jacuzzi_cost);
-	}
-	throw std::runtime_error("Database Error: couldn't create room from row!");
-}
+#include "RowMapper.h"
+#include <set>
 
-int RoomRepository::addBaseRoomAndGetId(const Room& room) {
-	if (!database.isTransactionActive()) {
-		throw std::logic_error("addBaseRoomAndGetId function must be called within a transaction");
-	}
+namespace {
+	struct RoomMapping {
+		using Entity = std::unique_ptr<Room>;
+		using Columns = std::tuple<int, std::string, std::string, double, double, bool, double>;
+		static constexpr const char* table = "rooms";
+		static constexpr std::array<const char*, 7> names = {
+			"room_number", "room_type", "status", "base_price", "extra_fees", "has_jacuzzi", "jacuzzi_cost" };
 
-	auto stmt = database.prepareStatement(
-		"INSERT INTO rooms (room_type, status, base_price) VALUES (?, ?, ?)");
-	stmt->setString(1, room.getType());
-	stmt->setString(2, room.getStatus());
-	stmt->setDouble(3, room.getBasePrice());
-	stmt->executeUpdate();
-	return database.getLastInsertID();
+		static std::unique_ptr<Room> create(int room_number, const std::string& type, const std::string& status,
+			double base_price, double extra_fees, bool has_jacuzzi, double jacuzzi_cost) {
+			if (type == "standard") {
+				return std::make_unique<StandardRoom>(room_number, base_price, status);
+			}
+			else if (type == "deluxe") {
+				return std::make_unique<DeluxeRoom>(room_number, base_price, status, extra_fees);
+			}
+			else if (type == "suite") {
+				return std::make_unique<Suite>(room_number, base_price, status, has_jacuzzi, jacuzzi_cost);
+			}
+			throw std::runtime_error("Database Error: couldn't create room from row!");
+		}
+
+		// Subtype columns keep their table defaults for the room types that do not use them.
+		static auto insertValues(const Room& room) {
+			double extra_fees = 0;
+			bool has_jacuzzi = false;
+			double jacuzzi_cost = 0;
+			if (const auto* deluxe = dynamic_cast<const DeluxeRoom*>(&room)) {
+				extra_fees = deluxe->getExtraFees();
+			}
+			else if (const auto* suite = dynamic_cast<const Suite*>(&room)) {
+				has_jacuzzi = suite->hasJacuzzi();
+				jacuzzi_cost = suite->getJacuzziCost();
+			}
+			return std::make_tuple(room.getType(), room.getStatus(), room.getBasePrice(), extra_fees, has_jacuzzi, jacuzzi_cost);
+		}
+	};
+	using RoomRows = RowMapper<RoomMapping>;
+}
+
+//Private Functions Definition
+std::unique_ptr<Room> RoomRepository::createRoomFromRow(const IGenericResultSet& result)const {
+	return RoomRows::read(result);
 }
 
 void RoomRepository::validateRoomExists(int room_number)const {
+	// Never answered from the snapshot: it guards writes, and bookings has no
+	// foreign key to catch a room another client deleted since the last load.
 	auto stmt = database.prepareStatement("SELECT 1 FROM rooms WHERE room_number=? FOR UPDATE");
 	stmt->setInt(1, room_number);
 	auto result = stmt->executeQuery();
@@ -52,68 +67,211 @@ std::vector<std::unique_ptr<Room>> RoomRepository::fetchRooms(std::unique_ptr<IG
 	return rooms;
 }
 
+bool RoomRepository::isCacheUsable()const {
+	return cache_staleness.count() > 0 && !database.isTransactionActive();
+}
+
+void RoomRepository::refreshCache()const {
+	auto now = std::chrono::steady_clock::now();
+	if (cache_loaded && now - cache_loaded_at <= cache_staleness) {
+		++cache_stats.hits;
+		return;
+	}
+	++cache_stats.misses;
+	cache_loaded = false;
+	cached_rooms.clear();
+	auto stmt = database.prepareStatement(RoomRows::select());
+	auto result = stmt->executeQuery();
+	while (result->next()) {
+		auto room = createRoomFromRow(*result);
+		int room_number = room->getNumber();
+		cached_rooms.emplace(room_number, std::move(room));
+	}
+	cache_loaded_at = now;
+	cache_loaded = true;
+	++cache_stats.loads;
+}
+
+std::vector<std::unique_ptr<Room>> RoomRepository::selectCached(const std::function<bool(const Room&)>& filter)const {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	refreshCache();
+	std::vector<std::unique_ptr<Room>> rooms;
+	for (const auto& entry : cached_rooms) {
+		if (filter(*entry.second)) {
+			rooms.push_back(entry.second->clone());
+		}
+	}
+	return rooms;
+}
+
+void RoomRepository::writeThrough(const std::function<void(RoomMap&)>& change) {
+	if (cache_staleness.count() <= 0) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	if (!cache_loaded) {
+		return;
+	}
+	if (database.isTransactionActive()) {
+		cached_rooms.clear();
+		cache_loaded = false;
+		++cache_stats.invalidations;
+		return;
+	}
+	change(cached_rooms);
+}
+
 //Constructors Definition
-RoomRepository::RoomRepository(IDatabase& db) :database(db) {}
+RoomRepository::RoomRepository(IDatabase& db, std::chrono::milliseconds cache_staleness)
+	:database(db), cache_staleness(cache_staleness), cache_loaded(false) {}
 
 //Public Functions Definition
+void RoomRepository::invalidateCache() {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	if (cache_loaded) {
+		cached_rooms.clear();
+		cache_loaded = false;
+		++cache_stats.invalidations;
+	}
+}
 
-int RoomRepository::addStandardRoom(const StandardRoom& standard_room) {
-		ScopedTransaction transaction(database);
-		int room_number=addBaseRoomAndGetId(standard_room);
-		transaction.commit();
-		return room_number;
+RoomCacheStats RoomRepository::getCacheStats()const {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	return cache_stats;
 }
 
-int RoomRepository::addDeluxeRoom(const DeluxeRoom& deluxe_room) {
+std::chrono::milliseconds RoomRepository::getCacheStaleness()const {
+	return cache_staleness;
+}
 
-		ScopedTransaction transaction(database);
-		int room_number = addBaseRoomAndGetId(deluxe_room);
-		auto stmt = database.prepareStatement("UPDATE rooms SET extra_fees = ? WHERE room_number=?");
-		stmt->setDouble(1, deluxe_room.getExtraFees());
-		stmt->setInt(2, room_number);
-		stmt->executeUpdate();
-		transaction.commit();
-		return room_number;
-	
+std::unique_ptr<Room> RoomRepository::addRoom(const Room& room) {
+	auto stmt = database.prepareStatement(RoomRows::insert());
+	RoomRows::bindInsert(*stmt, room);
+	auto stored = RoomRows::hydrate(stmt->executeInsert(), room);
+	writeThrough([&stored](RoomMap& rooms) {
+		rooms[stored->getNumber()] = stored->clone();
+	});
+	return stored;
 }
-int RoomRepository::addSuite(const Suite& suite) {
-		ScopedTransaction transaction(database);
 
-		int room_number = addBaseRoomAndGetId(suite);
-		auto stmt = database.prepareStatement("UPDATE rooms SET has_jacuzzi= ? ,jacuzzi_cost = ? WHERE room_number=?");
-		stmt->setBoolean(1, suite.hasJacuzzi());
-		stmt->setDouble(2, suite.getJacuzziCost());
-		stmt->setInt(3, room_number);
-		stmt->executeUpdate();
+std::vector<std::unique_ptr<Room>> RoomRepository::addRooms(const std::vector<std::unique_ptr<Room>>& rooms) {
+	std::vector<std::unique_ptr<Room>> stored;
+	if (rooms.empty()) {
+		return stored;
+	}
+	ScopedTransaction transaction(database);
 
-		transaction.commit();
-		return room_number;
+	auto stmt = database.prepareStatement(RoomRows::insert());
+	for (const auto& room : rooms) {
+		RoomRows::bindInsert(*stmt, *room);
+		stmt->addBatch();
+	}
+	stmt->executeBatch();
+	auto room_numbers = stmt->getGeneratedKeys();
+	if (room_numbers.size() != rooms.size()) {
+		throw std::runtime_error("Database Error: Batch insert returned " + std::to_string(room_numbers.size())
+			+ " room numbers for " + std::to_string(rooms.size()) + " rooms");
+	}
+	transaction.commit();
+
+	stored.reserve(rooms.size());
+	for (size_t i = 0; i < rooms.size(); ++i) {
+		stored.push_back(RoomRows::hydrate(room_numbers[i], *rooms[i]));
+	}
+	writeThrough([&stored](RoomMap& cached) {
+		for (const auto& room : stored) {
+			cached[room->getNumber()] = room->clone();
+		}
+	});
+	return stored;
 }
 
 int RoomRepository::getNumberOfRooms()const {
+	if (isCacheUsable()) {
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		refreshCache();
+		return static_cast<int>(cached_rooms.size());
+	}
 	auto stmt = database.prepareStatement("SELECT COUNT(*) FROM rooms");
 	auto result = stmt->executeQuery();
 	return result->next() ? result->getInt(1) : 0;
 }
-std::unique_ptr<Room>RoomRepository::getRoomByNumber(int room_num)const {
-	auto stmt = database.prepareStatement("SELECT * FROM rooms WHERE room_number=?");
+std::unique_ptr<Room>RoomRepository::lockRoomByNumber(int room_num)const {
+	static const std::string query = RoomRows::select() + " WHERE room_number=? FOR UPDATE";
+	auto stmt = database.prepareStatement(query);
 	stmt->setInt(1, room_num);
 	auto result = stmt->executeQuery();
 	if (!result->next()) {
-		throw std::runtime_error("Room " + std::to_string(room_num) + " not found!");
+		return nullptr;
+	}
+	return createRoomFromRow(*result);
+}
+
+std::unique_ptr<Room>RoomRepository::findRoomByNumber(int room_num)const {
+	if (isCacheUsable()) {
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		refreshCache();
+		auto it = cached_rooms.find(room_num);
+		return it == cached_rooms.end() ? nullptr : it->second->clone();
+	}
+	static const std::string query = RoomRows::select() + " WHERE room_number=?";
+	auto stmt = database.prepareStatement(query);
+	stmt->setInt(1, room_num);
+	auto result = stmt->executeQuery();
+	if (!result->next()) {
+		return nullptr;
 	}
 	return createRoomFromRow(*result);
 }
 
+std::unique_ptr<Room>RoomRepository::getRoomByNumber(int room_num)const {
+	auto room = findRoomByNumber(room_num);
+	if (!room) {
+		throw std::runtime_error("Room " + std::to_string(room_num) + " not found!");
+	}
+	return room;
+}
+
+std::vector<std::unique_ptr<Room>> RoomRepository::getAvailableRooms(const DateTime& check_in, const DateTime& check_out)const {
+	if (isCacheUsable()) {
+		auto stmt = database.prepareStatement("SELECT DISTINCT room_number FROM bookings WHERE check_in < ? AND check_out > ?");
+		stmt->setString(1, check_out.getDateTimeString());
+		stmt->setString(2, check_in.getDateTimeString());
+		auto result = stmt->executeQuery();
+		std::set<int> booked_rooms;
+		while (result->next()) {
+			booked_rooms.insert(result->getInt(1));
+		}
+		return selectCached([&booked_rooms](const Room& room) {
+			return room.getStatus() == "available" && booked_rooms.count(room.getNumber()) == 0;
+		});
+	}
+	static const std::string query = "SELECT " + RoomRows::columnList("r.") + " FROM rooms r WHERE r.status = 'available' "
+		"AND NOT EXISTS (SELECT 1 FROM bookings b WHERE b.room_number = r.room_number AND b.check_in < ? AND b.check_out > ?)";
+	auto stmt = database.prepareStatement(query);
+	stmt->setString(1, check_out.getDateTimeString());
+	stmt->setString(2, check_in.getDateTimeString());
+	auto result = stmt->executeQuery();
+	return fetchRooms(std::move(result));
+}
+
 std::vector<std::unique_ptr<Room>> RoomRepository::getRoomsByStatus(const std::string& status)const {
-	auto stmt = database.prepareStatement("SELECT * FROM rooms WHERE status=?");
+	if (isCacheUsable()) {
+		return selectCached([&status](const Room& room) { return room.getStatus() == status; });
+	}
+	static const std::string query = RoomRows::select() + " WHERE status=?";
+	auto stmt = database.prepareStatement(query);
 	stmt->setString(1, status);
 	auto result = stmt->executeQuery();
 	auto rooms = fetchRooms(std::move(result));
 	return rooms;
 }
 std::vector<std::unique_ptr<Room>> RoomRepository::getRoomsByType(const std::string& type)const {
-	auto stmt = database.prepareStatement("SELECT * FROM rooms WHERE room_type=?");
+	if (isCacheUsable()) {
+		return selectCached([&type](const Room& room) { return room.getType() == type; });
+	}
+	static const std::string query = RoomRows::select() + " WHERE room_type=?";
+	auto stmt = database.prepareStatement(query);
 	stmt->setString(1, type);
 	auto result = stmt->executeQuery();
 	auto rooms = fetchRooms(std::move(result));
@@ -122,11 +280,20 @@ std::vector<std::unique_ptr<Room>> RoomRepository::getRoomsByType(const std::str
 
 
 std::vector<std::unique_ptr<Room>>RoomRepository::getAllRooms()const {
-	auto stmt = database.prepareStatement("SELECT * FROM rooms");
+	if (isCacheUsable()) {
+		return selectCached([](const Room&) { return true; });
+	}
+	auto stmt = database.prepareStatement(RoomRows::select());
 	auto result = stmt->executeQuery();
 	return fetchRooms(std::move(result));
 }
 
+RowCursor<std::unique_ptr<Room>> RoomRepository::streamAllRooms()const {
+	auto stmt = database.prepareStatement(RoomRows::select());
+	auto result = stmt->executeQuery();
+	return RowCursor<std::unique_ptr<Room>>(std::move(stmt), std::move(result), &RoomRows::read);
+}
+
 void RoomRepository::updateRoomPrice(int room_num, double new_price) {
 	ScopedTransaction transaction(database);
 
@@ -137,6 +304,12 @@ void RoomRepository::updateRoomPrice(int room_num, double new_price) {
 	stmt->executeUpdate();
 
 	transaction.commit();
+	writeThrough([room_num, new_price](RoomMap& rooms) {
+		auto it = rooms.find(room_num);
+		if (it != rooms.end()) {
+			it->second->setPrice(ColumnCodec<double>::stored(new_price));
+		}
+	});
 }
 void RoomRepository::updateRoomStatus(int room_num, const std::string& status) {
 	ScopedTransaction transaction(database);
@@ -148,6 +321,12 @@ void RoomRepository::updateRoomStatus(int room_num, const std::string& status) {
 		stmt->executeUpdate();
 
 		transaction.commit();
+		writeThrough([room_num, &status](RoomMap& rooms) {
+			auto it = rooms.find(room_num);
+			if (it != rooms.end()) {
+				it->second->setStatus(status);
+			}
+		});
 }
 
 void RoomRepository::deleteRoom(int room_num) {
@@ -159,4 +338,5 @@ void RoomRepository::deleteRoom(int room_num) {
 		stmt->executeUpdate();
 
 		transaction.commit();
+		writeThrough([room_num](RoomMap& rooms) { rooms.erase(room_num); });
 }
\ No newline at end of file
@@ -6,7 +6,13 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
 #include "IDatabase.h"
+#include "DateTime.h"
+#include "RowCursor.h"
 
 /**
  * @file RoomRepository.h
@@ -15,10 +21,46 @@
  * The RoomRepository implements CRUD operations for Room objects using the
  * provided IDatabase adapter. All methods operate on the underlying
  * database and translate rows into concrete Room subclasses.
+ *
+ * Room inventory rarely changes, so reads are served from an in-process
+ * snapshot of the rooms table. The snapshot is loaded on first use, reloaded
+ * once it is older than the configured staleness bound, and updated in place
+ * by every mutation made through this repository. Inside a transaction all
+ * reads go to the database so row locks (FOR UPDATE) keep working.
+ */
+
+/**
+ * @struct RoomCacheStats
+ * @brief Counters describing how the room cache is being used.
  */
+struct RoomCacheStats {
+	unsigned long long hits = 0;          ///< Reads answered from a fresh snapshot.
+	unsigned long long misses = 0;        ///< Reads that had to (re)load the snapshot first.
+	unsigned long long loads = 0;         ///< Snapshot loads from the rooms table.
+	unsigned long long invalidations = 0; ///< Snapshots dropped instead of updated.
+
+	/**
+	 * @brief Fraction of cached reads answered without touching the rooms table.
+	 * @return double Value in [0, 1]; 0 when nothing has been read yet.
+	 */
+	double hitRate() const {
+		unsigned long long reads = hits + misses;
+		return reads == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(reads);
+	}
+};
+
 class RoomRepository {
+	using RoomMap = std::map<int, std::unique_ptr<Room>>;
+
 	IDatabase& database; ///< Reference to the database adapter used for queries.
 
+	std::chrono::milliseconds cache_staleness;                  ///< Maximum snapshot age; zero disables the cache.
+	mutable std::mutex cache_mutex;                             ///< Guards every cache member below.
+	mutable RoomMap cached_rooms;                               ///< Snapshot of the rooms table, keyed by room number.
+	mutable std::chrono::steady_clock::time_point cache_loaded_at; ///< When cached_rooms was read from the database.
+	mutable bool cache_loaded;                                  ///< Whether cached_rooms holds a snapshot.
+	mutable RoomCacheStats cache_stats;                         ///< Hit and miss counters.
+
 	/**
 	 * @brief Helper: create a concrete Room instance from a result row.
 	 * @param result Result row abstraction to read columns from.
@@ -26,32 +68,75 @@ class RoomRepository {
 	 */
 	std::unique_ptr<Room> createRoomFromRow(const IGenericResultSet& result) const;
 
+
 	/**
-	 * @brief Insert the common base room fields and return the generated id.
-	 * @param room Room object containing base fields to insert.
-	 * @return int Newly inserted room id.
+	 * @brief Convert a driver result into a vector of Room pointers.
+	 * @param result Owned result set returned from a query.
+	 * @return std::vector<std::unique_ptr<Room>> Vector of owned Room objects.
 	 */
-	int addBaseRoomAndGetId(const Room& room);
+	std::vector<std::unique_ptr<Room>> fetchRooms(std::unique_ptr<IGenericResultSet> result) const;
 
 	/**
-	 * @brief Helper: read last inserted id from the connection.
-	 * @return int The last auto-increment id for the session.
+	 * @brief Whether reads may be served from the snapshot right now.
+	 * @return true if the cache is enabled and no transaction is active.
 	 */
-	int getLastInsertedId() const;
+	bool isCacheUsable() const;
 
 	/**
-	 * @brief Convert a driver result into a vector of Room pointers.
-	 * @param result Owned result set returned from a query.
-	 * @return std::vector<std::unique_ptr<Room>> Vector of owned Room objects.
+	 * @brief Count a cached read and reload the snapshot if it is missing or stale.
+	 * @note Caller must hold cache_mutex.
 	 */
-	std::vector<std::unique_ptr<Room>> fetchRooms(std::unique_ptr<IGenericResultSet> result) const;
+	void refreshCache() const;
+
+	/**
+	 * @brief Copy the cached rooms accepted by a filter, in room number order.
+	 * @param filter Predicate selecting the rooms to return.
+	 * @return std::vector<std::unique_ptr<Room>> Copies of the matching rooms.
+	 */
+	std::vector<std::unique_ptr<Room>> selectCached(const std::function<bool(const Room&)>& filter) const;
+
+	/**
+	 * @brief Apply a committed change to the snapshot.
+	 *
+	 * When the change was made inside a caller's transaction it may still be
+	 * rolled back, so the snapshot is dropped instead of updated.
+	 *
+	 * @param change Update to apply to the cached rooms.
+	 */
+	void writeThrough(const std::function<void(RoomMap&)>& change);
 
 public:
+	/// Default staleness bound for the room cache.
+	static constexpr std::chrono::milliseconds DEFAULT_CACHE_STALENESS{ 60000 };
+
 	/**
 	 * @brief Construct a RoomRepository using the given database adapter.
 	 * @param db Adapter that performs the actual DB operations.
+	 * @param cache_staleness How old the cached room snapshot may get before it
+	 *        is reloaded; rooms changed by another process show up after at most
+	 *        this long. Zero disables the cache.
+	 */
+	RoomRepository(IDatabase& db, std::chrono::milliseconds cache_staleness = DEFAULT_CACHE_STALENESS);
+
+	/**
+	 * @brief Drop the cached snapshot so the next read reloads it.
+	 *
+	 * Only needed when rooms are changed outside this repository and must be
+	 * visible before the staleness bound expires.
+	 */
+	void invalidateCache();
+
+	/**
+	 * @brief Get a copy of the cache counters.
+	 * @return RoomCacheStats Current hits, misses, loads and invalidations.
+	 */
+	RoomCacheStats getCacheStats() const;
+
+	/**
+	 * @brief Get the staleness bound of the cache.
+	 * @return std::chrono::milliseconds Maximum snapshot age; zero when the cache is disabled.
 	 */
-	RoomRepository(IDatabase& db);
+	std::chrono::milliseconds getCacheStaleness() const;
 
 	/**
 	 * @brief Check if a room with the given number exists.
@@ -62,32 +147,44 @@ public:
 
 	/**
 	 * @brief Validate existence of a room and throw if not present.
+	 *
+	 * Always queried, never answered from the cached inventory. Inside a
+	 * transaction the query also locks the room row (FOR UPDATE) until the
+	 * transaction ends, so the room cannot be deleted or re-booked meanwhile.
+	 *
 	 * @param room_number Room number to validate.
 	 * @throws std::invalid_argument if the room does not exist.
 	 */
 	void validateRoomExists(int room_number) const;
 
-	// CREATE operations
 	/**
-	 * @brief Insert a StandardRoom and return its generated id.
-	 * @param room StandardRoom object to insert.
-	 * @return int Inserted record id.
+	 * @brief Read a room and lock its row (FOR UPDATE) in one statement.
+	 *
+	 * Always queried, never answered from the cached inventory. Inside a
+	 * transaction the row stays locked until the transaction ends.
+	 *
+	 * @param room_num Room number to read.
+	 * @return std::unique_ptr<Room> Owned Room object, or nullptr if there is no such room.
 	 */
-	int addStandardRoom(const StandardRoom& room);
+	std::unique_ptr<Room> lockRoomByNumber(int room_num) const;
 
+	// CREATE operations
 	/**
-	 * @brief Insert a DeluxeRoom and return its generated id.
-	 * @param room DeluxeRoom object to insert.
-	 * @return int Inserted record id.
+	 * @brief Insert a room of any type in a single statement.
+	 * @param room Room to insert; its number is ignored.
+	 * @return std::unique_ptr<Room> Stored room with its generated number.
 	 */
-	int addDeluxeRoom(const DeluxeRoom& room);
+	std::unique_ptr<Room> addRoom(const Room& room);
 
 	/**
-	 * @brief Insert a Suite and return its generated id.
-	 * @param suite Suite object to insert.
-	 * @return int Inserted record id.
+	 * @brief Insert many rooms in one transaction using a batched statement.
+	 *
+	 * Used when provisioning whole floors; rooms of different types can be mixed.
+	 *
+	 * @param rooms Rooms to insert; their numbers are ignored.
+	 * @return std::vector<std::unique_ptr<Room>> Stored rooms, in the order of @p rooms.
 	 */
-	int addSuite(const Suite& suite);
+	std::vector<std::unique_ptr<Room>> addRooms(const std::vector<std::unique_ptr<Room>>& rooms);
 
 	// READ operations
 	/**
@@ -102,13 +199,42 @@ public:
 	 */
 	std::vector<std::unique_ptr<Room>> getAllRooms() const;
 
+	/**
+	 * @brief Stream all rooms one row at a time.
+	 * @return RowCursor<std::unique_ptr<Room>> Single-pass range over every room.
+	 */
+	RowCursor<std::unique_ptr<Room>> streamAllRooms() const;
+
+	/**
+	 * @brief Look up a single room by its number.
+	 * @param room_num Room number to look up.
+	 * @return std::unique_ptr<Room> Owned Room object, or nullptr if there is no such room.
+	 */
+	std::unique_ptr<Room> findRoomByNumber(int room_num) const;
+
 	/**
 	 * @brief Load a single room by its number.
 	 * @param room_num Room number to load.
 	 * @return std::unique_ptr<Room> Owned Room object.
+	 * @throws std::runtime_error if the room does not exist.
 	 */
 	std::unique_ptr<Room> getRoomByNumber(int room_num) const;
 
+	/**
+	 * @brief Get rooms that are available and free for a stay.
+	 *
+	 * With the cache in use, only the numbers of rooms booked during the stay
+	 * are queried and the rooms table is not read. Otherwise runs a single
+	 * anti-join against the bookings table, so the cost grows with the number
+	 * of rooms rather than with the booking history.
+	 *
+	 * @param check_in Start of the stay (inclusive).
+	 * @param check_out End of the stay (exclusive).
+	 * @return std::vector<std::unique_ptr<Room>> Rooms with status "available"
+	 *         and no booking overlapping [check_in, check_out).
+	 */
+	std::vector<std::unique_ptr<Room>> getAvailableRooms(const DateTime& check_in, const DateTime& check_out) const;
+
 	/**
 	 * @brief Get rooms filtered by their status string.
 	 * @param status Status to filter by (e.g. "available").
@@ -0,0 +1,127 @@
+#pragma once
+#include "IGenericResultSet.h"
+#include "IGenericStatement.h"
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <utility>
+
+/**
+ * @file RowCursor.h
+ * @brief Lazy, forward-only range of entities mapped from a result set.
+ *
+ * Repository methods returning std::vector read the whole result set before
+ * the caller sees the first row. A RowCursor maps one row at a time instead,
+ * so only the current entity is held in memory:
+ * @code
+ * for (const Booking& booking : repo.streamAllBookings()) {
+ *     booking.printBookingInfo();
+ * }
+ * @endcode
+ * The cursor owns the statement and result set it reads from; both are
+ * released as soon as the last row has been read, which also hands a pooled
+ * connection back early.
+ */
+
+/**
+ * @class RowCursor
+ * @brief Single-pass input range over the rows of a query.
+ * @tparam T Entity type produced for each row.
+ */
+template <typename T>
+class RowCursor {
+public:
+    using Mapper = T (*)(const IGenericResultSet&); ///< Converts the current row into an entity.
+
+private:
+    std::unique_ptr<IGenericStatement> statement; ///< Declared before result so it is released after it.
+    std::unique_ptr<IGenericResultSet> result;
+    Mapper mapper;
+    std::optional<T> current; ///< Entity mapped from the current row; empty once exhausted.
+    bool started;
+
+    /**
+     * @brief Move to the next row, releasing the query once it is exhausted.
+     */
+    void advance() {
+        if (result && result->next()) {
+            current.emplace(mapper(*result));
+            return;
+        }
+        current.reset();
+        result.reset();
+        statement.reset();
+    }
+
+public:
+    /**
+     * @class iterator
+     * @brief Input iterator; every copy refers to the same cursor position.
+     */
+    class iterator {
+        RowCursor* cursor; ///< nullptr for the end iterator.
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        explicit iterator(RowCursor* cursor = nullptr) : cursor(cursor) {}
+
+        reference operator*() const { return *cursor->current; }
+        pointer operator->() const { return &*cursor->current; }
+
+        iterator& operator++() {
+            cursor->advance();
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        bool operator==(const iterator& other) const {
+            bool at_end = !cursor || !cursor->current;
+            bool other_at_end = !other.cursor || !other.cursor->current;
+            return at_end == other_at_end && (at_end || cursor == other.cursor);
+        }
+
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief Take ownership of an executed query.
+     * @param statement Statement that produced the result set.
+     * @param result Result set positioned before its first row.
+     * @param mapper Function converting a row into an entity.
+     */
+    RowCursor(std::unique_ptr<IGenericStatement> statement, std::unique_ptr<IGenericResultSet> result, Mapper mapper)
+        : statement(std::move(statement)), result(std::move(result)), mapper(mapper), started(false) {}
+
+    RowCursor(RowCursor&&) = default;
+    RowCursor& operator=(RowCursor&&) = default;
+    RowCursor(const RowCursor&) = delete;
+    RowCursor& operator=(const RowCursor&) = delete;
+
+    /**
+     * @brief Read the first row and return an iterator to it.
+     *
+     * The cursor is single-pass: calling begin() again continues from the
+     * current row rather than restarting the query.
+     *
+     * @return iterator Iterator on the current row, or end() when there is none.
+     */
+    iterator begin() {
+        if (!started) {
+            started = true;
+            advance();
+        }
+        return iterator(this);
+    }
+
+    /**
+     * @brief Past-the-end iterator.
+     * @return iterator End sentinel.
+     */
+    iterator end() { return iterator(); }
+};
@@ -0,0 +1,181 @@
+#pragma once
+#include "IGenericResultSet.h"
+#include "IGenericStatement.h"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @file RowMapper.h
+ * @brief Compile-time mapping between entities and table rows.
+ *
+ * Each repository describes its table once, as a mapping type:
+ * @code
+ * struct CustomerMapping {
+ *     using Entity = Customer;
+ *     using Columns = std::tuple<int, std::string, int, std::string, std::string>;
+ *     static constexpr const char* table = "customers";
+ *     static constexpr std::array<const char*, 5> names = { "customer_id", "name", "age", "phone_number", "email" };
+ *     static Customer create(int id, std::string name, int age, std::string phone, std::string email);
+ *     static auto insertValues(const Customer& customer); // values of columns 2..N, in order
+ * };
+ * @endcode
+ * The first column is the auto-increment key: it is selected but never
+ * inserted. RowMapper<Mapping> derives the SELECT column list, the INSERT
+ * statement with its bind order, and a row decoder that reads every column
+ * by position, so the same description drives reads and writes.
+ */
+
+/**
+ * @brief Reads and binds a single column of a given C++ type.
+ *
+ * stored() returns a bound value as the column keeps it, so an entity built
+ * without reading the row back matches one read from the table.
+ */
+template <typename T>
+struct ColumnCodec;
+
+template <>
+struct ColumnCodec<int> {
+    static int read(const IGenericResultSet& row, int column) { return row.getInt(column); }
+    static void bind(IGenericStatement& stmt, int param, int value) { stmt.setInt(param, value); }
+    static int stored(int value) { return value; }
+};
+
+template <>
+struct ColumnCodec<double> {
+    static double read(const IGenericResultSet& row, int column) { return row.getDouble(column); }
+    static void bind(IGenericStatement& stmt, int param, double value) { stmt.setDouble(param, value); }
+
+    /// Every floating-point column of the schema is money stored as DECIMAL(10,2): round to cents.
+    static double stored(double value) { return std::round(value * 100.0) / 100.0; }
+};
+
+template <>
+struct ColumnCodec<bool> {
+    static bool read(const IGenericResultSet& row, int column) { return row.getBoolean(column); }
+    static void bind(IGenericStatement& stmt, int param, bool value) { stmt.setBoolean(param, value); }
+    static bool stored(bool value) { return value; }
+};
+
+template <>
+struct ColumnCodec<std::string> {
+    static std::string read(const IGenericResultSet& row, int column) { return row.getString(column); }
+    static void bind(IGenericStatement& stmt, int param, const std::string& value) { stmt.setString(param, value); }
+    static std::string stored(const std::string& value) { return value; }
+};
+
+/**
+ * @class RowMapper
+ * @brief SQL text and row conversion generated from a mapping description.
+ * @tparam Mapping Table description (see the file documentation).
+ */
+template <typename Mapping>
+class RowMapper {
+    using Columns = typename Mapping::Columns;
+    static constexpr std::size_t column_count = std::tuple_size<Columns>::value;
+
+    static_assert(column_count == Mapping::names.size(), "Every column needs exactly one name");
+    static_assert(column_count >= 2, "A mapping needs a key column and at least one value column");
+
+    template <std::size_t... I>
+    static typename Mapping::Entity readColumns(const IGenericResultSet& row, std::index_sequence<I...>) {
+        return Mapping::create(ColumnCodec<std::tuple_element_t<I, Columns>>::read(row, static_cast<int>(I + 1))...);
+    }
+
+    template <typename Values, std::size_t... I>
+    static typename Mapping::Entity hydrateColumns(std::tuple_element_t<0, Columns> key, const Values& values, std::index_sequence<I...>) {
+        return Mapping::create(key, ColumnCodec<std::tuple_element_t<I + 1, Columns>>::stored(std::get<I>(values))...);
+    }
+
+    template <typename Values, std::size_t... I>
+    static void bindColumns(IGenericStatement& stmt, const Values& values, std::index_sequence<I...>) {
+        (ColumnCodec<std::tuple_element_t<I + 1, Columns>>::bind(stmt, static_cast<int>(I + 1), std::get<I>(values)), ...);
+    }
+
+public:
+    /**
+     * @brief Comma separated list of every column, in mapping order.
+     * @param prefix Optional table alias prefix (for example "r.").
+     * @return std::string Column list for a SELECT.
+     */
+    static std::string columnList(const std::string& prefix = "") {
+        std::string list;
+        for (std::size_t i = 0; i < column_count; ++i) {
+            if (i != 0) {
+                list += ", ";
+            }
+            list += prefix;
+            list += Mapping::names[i];
+        }
+        return list;
+    }
+
+    /**
+     * @brief "SELECT <columns> FROM <table>", ready for a WHERE clause.
+     * @return const std::string& SELECT prefix built once per mapping.
+     */
+    static const std::string& select() {
+        static const std::string query = "SELECT " + columnList() + " FROM " + Mapping::table;
+        return query;
+    }
+
+    /**
+     * @brief INSERT statement for every column except the key.
+     * @return const std::string& INSERT statement built once per mapping.
+     */
+    static const std::string& insert() {
+        static const std::string query = [] {
+            std::string columns;
+            std::string params;
+            for (std::size_t i = 1; i < column_count; ++i) {
+                columns += (i == 1 ? "" : ", ");
+                columns += Mapping::names[i];
+                params += (i == 1 ? "?" : ", ?");
+            }
+            return "INSERT INTO " + std::string(Mapping::table) + " (" + columns + ") VALUES (" + params + ")";
+        }();
+        return query;
+    }
+
+    /**
+     * @brief Decode the current row into an entity.
+     *
+     * The row must have been selected with select() or columnList(), so that
+     * column positions match the mapping.
+     *
+     * @param row Result set positioned on a row.
+     * @return Entity Decoded entity.
+     */
+    static typename Mapping::Entity read(const IGenericResultSet& row) {
+        return readColumns(row, std::make_index_sequence<column_count>{});
+    }
+
+    /**
+     * @brief Build the entity a successful insert() stored, without reading it back.
+     * @param key Key generated for the inserted row.
+     * @param entity Entity that was bound with bindInsert().
+     * @return Entity Entity carrying the generated key, with values as the columns store them.
+     */
+    template <typename T>
+    static typename Mapping::Entity hydrate(std::tuple_element_t<0, Columns> key, const T& entity) {
+        return hydrateColumns(key, Mapping::insertValues(entity), std::make_index_sequence<column_count - 1>{});
+    }
+
+    /**
+     * @brief Bind an entity's values to a statement prepared from insert().
+     * @param stmt Statement prepared from insert().
+     * @param entity Entity to persist (any type accepted by Mapping::insertValues).
+     */
+    template <typename T>
+    static void bindInsert(IGenericStatement& stmt, const T& entity) {
+        auto values = Mapping::insertValues(entity);
+        static_assert(std::tuple_size<decltype(values)>::value == column_count - 1,
+            "insertValues must provide every column except the key");
+        bindColumns(stmt, values, std::make_index_sequence<column_count - 1>{});
+    }
+};
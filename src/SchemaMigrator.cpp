@@ -0,0 +1,151 @@
+#include "SchemaMigrator.h"
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+    // Skip condition for steps that create an index init.sql may already define.
+    std::string indexExists(const std::string& table, const std::string& index) {
+        return "SELECT COUNT(*) FROM information_schema.statistics WHERE table_schema = DATABASE() "
+            "AND table_name = '" + table + "' AND index_name = '" + index + "'";
+    }
+
+    long long millisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * Holds the server-wide named lock that serializes migrations across
+     * processes, and releases it on every exit path.
+     */
+    class MigrationLock {
+        IDatabase& database;
+
+    public:
+        MigrationLock(IDatabase& db, int timeout_seconds) : database(db) {
+            auto stmt = database.prepareStatement("SELECT GET_LOCK('" + std::string(SchemaMigrator::LOCK_NAME) + "', ?)");
+            stmt->setInt(1, timeout_seconds);
+            auto result = stmt->executeQuery();
+            if (!result->next() || result->isNull(1) || result->getInt(1) != 1) {
+                throw std::runtime_error("Database Error: Timed out after " + std::to_string(timeout_seconds)
+                    + " s waiting for another process to finish the schema migrations");
+            }
+        }
+
+        ~MigrationLock() {
+            try {
+                auto stmt = database.prepareStatement("SELECT RELEASE_LOCK('" + std::string(SchemaMigrator::LOCK_NAME) + "')");
+                stmt->executeQuery();
+            }
+            catch (const std::exception&) {
+                // The server releases the lock when the session ends anyway.
+            }
+        }
+
+        MigrationLock(const MigrationLock&) = delete;
+        MigrationLock& operator=(const MigrationLock&) = delete;
+    };
+}
+
+// Migrations
+std::vector<Migration> SchemaMigrator::getMigrations() {
+    return {
+        { 1, "Add booking lookup indexes", {
+            { "CREATE INDEX idx_bookings_room_dates ON bookings (room_number, check_in, check_out)",
+                indexExists("bookings", "idx_bookings_room_dates") },
+            { "CREATE INDEX idx_bookings_customer ON bookings (customer_id)",
+                indexExists("bookings", "idx_bookings_customer") },
+            { "CREATE INDEX idx_bookings_dates ON bookings (check_out, check_in)",
+                indexExists("bookings", "idx_bookings_dates") },
+        } },
+    };
+}
+
+// Constructors Definition
+SchemaMigrator::SchemaMigrator(IDatabase& db, std::vector<Migration> migrations)
+    : database(db), migrations(std::move(migrations)) {
+    for (size_t i = 1; i < this->migrations.size(); ++i) {
+        if (this->migrations[i].version <= this->migrations[i - 1].version) {
+            throw std::invalid_argument("Migration versions must be strictly increasing");
+        }
+    }
+}
+
+// Private Functions Definition
+void SchemaMigrator::ensureVersionTable() {
+    auto stmt = database.prepareStatement(
+        "CREATE TABLE IF NOT EXISTS schema_version ("
+        "version int NOT NULL, "
+        "description varchar(200) NOT NULL, "
+        "duration_ms int NOT NULL, "
+        "applied_at timestamp NULL DEFAULT CURRENT_TIMESTAMP, "
+        "PRIMARY KEY (version))");
+    stmt->execute();
+}
+
+bool SchemaMigrator::isSatisfied(const MigrationStep& step) const {
+    if (step.skip_if_query.empty()) {
+        return false;
+    }
+    auto stmt = database.prepareStatement(step.skip_if_query);
+    auto result = stmt->executeQuery();
+    return result->next() && result->getInt(1) != 0;
+}
+
+long long SchemaMigrator::apply(const Migration& migration, std::ostream& log) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < migration.steps.size(); ++i) {
+        const auto& step = migration.steps[i];
+        auto step_start = std::chrono::steady_clock::now();
+        log << "  step " << (i + 1) << "/" << migration.steps.size() << ": ";
+        if (isSatisfied(step)) {
+            log << "already satisfied, checked in " << millisecondsSince(step_start) << " ms\n";
+            continue;
+        }
+        auto stmt = database.prepareStatement(step.sql);
+        stmt->execute();
+        log << "applied in " << millisecondsSince(step_start) << " ms\n";
+    }
+    auto elapsed = millisecondsSince(start);
+
+    auto stmt = database.prepareStatement(
+        "INSERT INTO schema_version (version, description, duration_ms) VALUES (?, ?, ?)");
+    stmt->setInt(1, migration.version);
+    stmt->setString(2, migration.description);
+    stmt->setInt(3, static_cast<int>(elapsed));
+    stmt->executeUpdate();
+    return elapsed;
+}
+
+// Public Functions Definition
+int SchemaMigrator::getCurrentVersion() const {
+    auto stmt = database.prepareStatement("SELECT COALESCE(MAX(version), 0) FROM schema_version");
+    auto result = stmt->executeQuery();
+    return result->next() ? result->getInt(1) : 0;
+}
+
+int SchemaMigrator::migrate(std::ostream& log, int lock_timeout_seconds) {
+    ensureVersionTable();
+    int version = getCurrentVersion();
+    if (migrations.empty() || migrations.back().version <= version) {
+        return version;
+    }
+    MigrationLock lock(database, lock_timeout_seconds);
+    // Another process may have applied some migrations while this one waited.
+    version = getCurrentVersion();
+    for (const auto& migration : migrations) {
+        if (migration.version <= version) {
+            continue;
+        }
+        try {
+            log << "Schema migration " << migration.version << " (" << migration.description << "):\n";
+            long long elapsed = apply(migration, log);
+            log << "  recorded, " << elapsed << " ms in total\n";
+        }
+        catch (const std::exception& e) {
+            throw std::runtime_error("Database Error: Schema migration " + std::to_string(migration.version)
+                + " (" + migration.description + ") failed: " + e.what());
+        }
+        version = migration.version;
+    }
+    return version;
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include "IDatabase.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @file SchemaMigrator.h
+ * @brief Versioned, in-application schema migrations.
+ *
+ * init-db/init.sql only runs when the MySQL volume is created. Changes made
+ * after that (indexes, column types, summary tables) are shipped as numbered
+ * migrations that the application applies at startup. Applied versions are
+ * recorded in the `schema_version` table so each migration runs once.
+ */
+
+/**
+ * @struct MigrationStep
+ * @brief One SQL statement of a migration.
+ */
+struct MigrationStep {
+    std::string sql;           ///< Statement to execute.
+    std::string skip_if_query; ///< Optional COUNT query; the step is skipped when it returns a non-zero value.
+};
+
+/**
+ * @struct Migration
+ * @brief A numbered schema change made of one or more statements.
+ */
+struct Migration {
+    int version;                    ///< Strictly increasing version number.
+    std::string description;        ///< Short human readable summary, stored in schema_version.
+    std::vector<MigrationStep> steps; ///< Statements executed in order.
+};
+
+/**
+ * @class SchemaMigrator
+ * @brief Applies pending migrations and records them in `schema_version`.
+ *
+ * MySQL commits DDL implicitly, so a migration is recorded only after all of
+ * its steps succeeded. Steps that may already be satisfied by init.sql (for
+ * example an index created on fresh volumes) use skip_if_query to stay
+ * idempotent. Several processes may start at once: migrate() holds the
+ * named lock LOCK_NAME (GET_LOCK) while it reads the version and applies
+ * the pending migrations, so they run once and in order.
+ */
+class SchemaMigrator {
+    IDatabase& database;            ///< Database adapter used to run the migrations.
+    std::vector<Migration> migrations; ///< Known migrations ordered by version.
+
+    /**
+     * @brief Create the schema_version table when it is missing.
+     */
+    void ensureVersionTable();
+
+    /**
+     * @brief Check whether a step has already been satisfied.
+     * @param step Step to check.
+     * @return true when skip_if_query returned a non-zero count.
+     */
+    bool isSatisfied(const MigrationStep& step) const;
+
+    /**
+     * @brief Run all steps of a migration and record it.
+     * @param migration Migration to apply.
+     * @param log Stream receiving one line per step with its duration.
+     * @return long long Elapsed time in milliseconds.
+     */
+    long long apply(const Migration& migration, std::ostream& log);
+
+public:
+    /// Name of the server-wide lock held while migrating.
+    static constexpr const char* LOCK_NAME = "schema_migrations";
+
+    /// Default wait for a migration running in another process.
+    static constexpr int DEFAULT_LOCK_TIMEOUT_SECONDS = 60;
+
+    /**
+     * @brief Construct a migrator for the given database.
+     * @param db Database adapter to migrate.
+     * @param migrations Migrations to apply; defaults to the application's list.
+     * @throws std::invalid_argument if versions are not strictly increasing.
+     */
+    SchemaMigrator(IDatabase& db, std::vector<Migration> migrations = getMigrations());
+
+    /**
+     * @brief Read the highest applied version.
+     * @return int Current schema version, 0 when nothing was applied.
+     */
+    int getCurrentVersion() const;
+
+    /**
+     * @brief Apply every migration newer than the current version.
+     *
+     * When a migration is pending, the version is read again under the
+     * migration lock, so migrations another process applied meanwhile are
+     * skipped. Nothing is logged and no lock is taken when the schema is
+     * already current.
+     *
+     * @param log Stream receiving the duration of every applied migration and of each of its steps.
+     * @param lock_timeout_seconds How long to wait for another process's migration.
+     * @return int Schema version after migrating.
+     * @throws std::runtime_error naming the failing migration, or when the lock is not granted in time.
+     */
+    int migrate(std::ostream& log, int lock_timeout_seconds = DEFAULT_LOCK_TIMEOUT_SECONDS);
+
+    /**
+     * @brief The application's migrations, ordered by version.
+     * @return std::vector<Migration> Migration list.
+     */
+    static std::vector<Migration> getMigrations();
+};
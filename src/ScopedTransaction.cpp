@@ -1,13 +1,73 @@
 #include "ScopedTransaction.h"
-ScopedTransaction:: ScopedTransaction(IDatabase& db) :database(db), commited(false) {
-	database.beginTransaction();
+#include <algorithm>
+#include <utility>
+
+namespace {
+	/// Outermost ScopedTransaction the current thread has open on a database.
+	struct OwnedTransaction {
+		const IDatabase* database;
+		std::vector<std::function<void()>> after_commit; ///< Queued by afterCommit().
+	};
+
+	thread_local std::vector<OwnedTransaction> owned_transactions;
+
+	std::vector<OwnedTransaction>::iterator findOwned(const IDatabase& database) {
+		return std::find_if(owned_transactions.begin(), owned_transactions.end(),
+			[&database](const OwnedTransaction& owned) { return owned.database == &database; });
+	}
+}
+
+// Private Functions Definition
+std::vector<std::function<void()>> ScopedTransaction::release() {
+	std::vector<std::function<void()>> actions;
+	auto it = findOwned(database);
+	if (it != owned_transactions.end()) {
+		actions = std::move(it->after_commit);
+		owned_transactions.erase(it);
+	}
+	return actions;
 }
+
+// Constructors Definition
+ScopedTransaction:: ScopedTransaction(IDatabase& db) :database(db), commited(false),
+	joined(findOwned(db) != owned_transactions.end() && db.isTransactionActive()) {
+	if (!joined) {
+		database.beginTransaction();
+		owned_transactions.push_back(OwnedTransaction{ &database, {} });
+	}
+}
+
+// Public Functions Definition
 void ScopedTransaction::commit() {
-	database.commitTransaction();
+	if (!joined) {
+		database.commitTransaction();
+		for (auto& action : release()) {
+			action();
+		}
+	}
 	commited = true;
 }
+
+bool ScopedTransaction::afterCommit(IDatabase& db, std::function<void()> action) {
+	bool active = db.isTransactionActive();
+	auto owned = findOwned(db);
+	if (active && owned != owned_transactions.end()) {
+		owned->after_commit.push_back(std::move(action));
+		return true;
+	}
+	if (active) {
+		return false;
+	}
+	action();
+	return true;
+}
+
 ScopedTransaction:: ~ScopedTransaction() {
-	if (!commited && database.isTransactionActive()) {
+	if (joined || commited) {
+		return;
+	}
+	release();
+	if (database.isTransactionActive()) {
 		database.rollbackTransaction();
 	}
-}
\ No newline at end of file
+}
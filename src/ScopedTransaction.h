@@ -1,13 +1,50 @@
 #pragma once
 #include "IDatabase.h"
+#include <functional>
+#include <vector>
+/**
+ * @class ScopedTransaction
+ * @brief RAII transaction; joins an outer ScopedTransaction of the same thread.
+ *
+ * A scope opened while the calling thread already has a ScopedTransaction on
+ * the same database joins it: it neither commits nor rolls back, and the
+ * outer scope (for example a GroupCommitQueue batch) decides, so repository
+ * methods can run both on their own and as part of a larger unit. A
+ * transaction opened by another thread is never joined: beginTransaction()
+ * runs and, on backends with one transaction per connection, throws.
+ *
+ * afterCommit() defers work, such as updating an in-memory index, until the
+ * outermost scope commits; a rollback discards it.
+ */
 class ScopedTransaction{
 private:
 	IDatabase& database;
 	bool commited;
+	bool joined; ///< True when an outer scope of this thread opened the transaction.
+
+	/**
+	 * @brief Forget this thread's ownership of the transaction once it has ended.
+	 * @return std::vector<std::function<void()>> Actions queued by afterCommit().
+	 */
+	std::vector<std::function<void()>> release();
 public:
 	explicit ScopedTransaction(IDatabase& db);
 	void commit();
+
+	/**
+	 * @brief Run an action once the calling thread's changes to a database are committed.
+	 *
+	 * Inside a ScopedTransaction of the calling thread the action is queued and
+	 * runs on this thread after the outermost scope commits; if it rolls back
+	 * instead, the action is dropped. Outside a transaction it runs at once.
+	 *
+	 * @param db Database the changes were made on.
+	 * @param action Action to run; must not throw.
+	 * @return bool False, without running the action, when a transaction not
+	 *         opened by a ScopedTransaction of this thread is active.
+	 */
+	static bool afterCommit(IDatabase& db, std::function<void()> action);
 	~ScopedTransaction();
 	ScopedTransaction(const ScopedTransaction&) = delete;
 	ScopedTransaction& operator=(const ScopedTransaction&) = delete;
-};
\ No newline at end of file
+};
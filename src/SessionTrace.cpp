@@ -0,0 +1,279 @@
+#include "SessionTrace.h"
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+    const char TRACE_HEADER[] = "HMTRACE1";
+    const std::size_t TRACE_HEADER_SIZE = sizeof(TRACE_HEADER) - 1;
+
+    enum RecordTag : std::uint8_t { STRING = 1, STATEMENT = 2, TRANSACTION = 3, ISOLATION_LEVEL = 4 };
+    enum ValueTag : std::uint8_t { NULL_VALUE = 0, INTEGER = 1, REAL = 2, TEXT = 3 };
+
+    void putVarint(std::string& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    void putSigned(std::string& out, long long value) {
+        putVarint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+    }
+
+    void putText(std::string& out, const std::string& text) {
+        putVarint(out, text.size());
+        out += text;
+    }
+
+    void putValue(std::string& out, const SqlValue& value) {
+        if (const auto* integer = std::get_if<long long>(&value)) {
+            out += static_cast<char>(INTEGER);
+            putSigned(out, *integer);
+        }
+        else if (const auto* real = std::get_if<double>(&value)) {
+            out += static_cast<char>(REAL);
+            std::uint64_t bits;
+            std::memcpy(&bits, real, sizeof(bits));
+            for (int i = 0; i < 8; ++i) {
+                out += static_cast<char>((bits >> (8 * i)) & 0xFF);
+            }
+        }
+        else if (const auto* text = std::get_if<std::string>(&value)) {
+            out += static_cast<char>(TEXT);
+            putText(out, *text);
+        }
+        else {
+            out += static_cast<char>(NULL_VALUE);
+        }
+    }
+
+    /// Thrown by Cursor when a record runs past the end of the file.
+    struct TruncatedRecord {};
+
+    class Cursor {
+    private:
+        const std::string& data;
+        std::size_t position;
+
+    public:
+        Cursor(const std::string& data, std::size_t position) : data(data), position(position) {}
+
+        bool atEnd() const { return position >= data.size(); }
+        std::size_t offset() const { return position; }
+
+        std::uint8_t byte() {
+            if (position >= data.size()) {
+                throw TruncatedRecord();
+            }
+            return static_cast<std::uint8_t>(data[position++]);
+        }
+
+        std::uint64_t varint() {
+            std::uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                std::uint8_t next = byte();
+                value |= static_cast<std::uint64_t>(next & 0x7F) << shift;
+                if ((next & 0x80) == 0) {
+                    return value;
+                }
+            }
+            throw std::runtime_error("Database Error: Corrupt trace: varint too long at offset " + std::to_string(position));
+        }
+
+        long long signedVarint() {
+            std::uint64_t value = varint();
+            return static_cast<long long>((value >> 1) ^ (~(value & 1) + 1));
+        }
+
+        std::string text() {
+            std::uint64_t size = varint();
+            if (size > data.size() - position) {
+                throw TruncatedRecord();
+            }
+            std::string value = data.substr(position, static_cast<std::size_t>(size));
+            position += static_cast<std::size_t>(size);
+            return value;
+        }
+
+        SqlValue value() {
+            switch (byte()) {
+            case NULL_VALUE:
+                return SqlValue();
+            case INTEGER:
+                return signedVarint();
+            case REAL: {
+                std::uint64_t bits = 0;
+                for (int i = 0; i < 8; ++i) {
+                    bits |= static_cast<std::uint64_t>(byte()) << (8 * i);
+                }
+                double real;
+                std::memcpy(&real, &bits, sizeof(real));
+                return real;
+            }
+            case TEXT:
+                return text();
+            default:
+                throw std::runtime_error("Database Error: Corrupt trace: unknown value type at offset " + std::to_string(position - 1));
+            }
+        }
+    };
+
+    const std::string& lookup(const std::vector<std::string>& strings, std::uint64_t id) {
+        if (id >= strings.size()) {
+            throw std::runtime_error("Database Error: Corrupt trace: unknown string id " + std::to_string(id));
+        }
+        return strings[static_cast<std::size_t>(id)];
+    }
+
+    TraceStatement readStatement(Cursor& cursor, const std::vector<std::string>& strings) {
+        TraceStatement statement;
+        statement.sql = lookup(strings, cursor.varint());
+        statement.call = static_cast<TraceCall>(cursor.byte());
+        statement.duration = std::chrono::nanoseconds(static_cast<long long>(cursor.varint()));
+        statement.failed = cursor.byte() != 0;
+        if (statement.failed) {
+            statement.error = cursor.text();
+        }
+        statement.result = cursor.signedVarint();
+        statement.parameters.resize(static_cast<std::size_t>(cursor.varint()));
+        for (auto& row : statement.parameters) {
+            row.resize(static_cast<std::size_t>(cursor.varint()));
+            for (auto& value : row) {
+                value = cursor.value();
+            }
+        }
+        statement.generated_keys.resize(static_cast<std::size_t>(cursor.varint()));
+        for (auto& key : statement.generated_keys) {
+            key = static_cast<int>(cursor.signedVarint());
+        }
+        statement.rows.resize(static_cast<std::size_t>(cursor.varint()));
+        for (auto& row : statement.rows) {
+            row.resize(static_cast<std::size_t>(cursor.varint()));
+            for (auto& cell : row) {
+                cell.column = lookup(strings, cursor.varint());
+                cell.getter = static_cast<TraceGetter>(cursor.byte());
+                cell.value = cursor.value();
+            }
+        }
+        return statement;
+    }
+}
+
+// Public Functions Definition
+SessionTrace SessionTrace::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Database Error: Cannot open trace file: " + path);
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.compare(0, TRACE_HEADER_SIZE, TRACE_HEADER) != 0) {
+        throw std::runtime_error("Database Error: Not a session trace: " + path);
+    }
+
+    SessionTrace trace;
+    std::vector<std::string> strings;
+    Cursor cursor(data, TRACE_HEADER_SIZE);
+    try {
+        while (!cursor.atEnd()) {
+            std::size_t start = cursor.offset();
+            switch (cursor.byte()) {
+            case STRING:
+                strings.push_back(cursor.text());
+                break;
+            case STATEMENT:
+                trace.statements.push_back(readStatement(cursor, strings));
+                break;
+            case TRANSACTION:
+                trace.transactions += static_cast<TraceTransaction>(cursor.byte()) == TraceTransaction::Begin ? 1 : 0;
+                cursor.varint();
+                break;
+            case ISOLATION_LEVEL:
+                trace.isolation_level = lookup(strings, cursor.varint());
+                break;
+            default:
+                throw std::runtime_error("Database Error: Corrupt trace: unknown record at offset " + std::to_string(start));
+            }
+        }
+    }
+    catch (const TruncatedRecord&) {
+        // The recording process stopped in the middle of a record; keep the complete ones.
+    }
+    return trace;
+}
+
+TraceWriter::TraceWriter(const std::string& path) : file(path, std::ios::binary | std::ios::trunc) {
+    if (!file) {
+        throw std::runtime_error("Database Error: Cannot create trace file: " + path);
+    }
+    file.write(TRACE_HEADER, TRACE_HEADER_SIZE);
+}
+
+std::uint64_t TraceWriter::stringId(const std::string& text) {
+    auto it = strings.find(text);
+    if (it != strings.end()) {
+        return it->second;
+    }
+    std::string record(1, static_cast<char>(STRING));
+    putText(record, text);
+    file.write(record.data(), static_cast<std::streamsize>(record.size()));
+    std::uint64_t id = strings.size();
+    strings.emplace(text, id);
+    return id;
+}
+
+void TraceWriter::write(const TraceStatement& statement) {
+    std::lock_guard<std::mutex> lock(mutex);
+    buffer.clear();
+    buffer += static_cast<char>(STATEMENT);
+    putVarint(buffer, stringId(statement.sql));
+    buffer += static_cast<char>(statement.call);
+    putVarint(buffer, static_cast<std::uint64_t>(statement.duration.count() > 0 ? statement.duration.count() : 0));
+    buffer += static_cast<char>(statement.failed ? 1 : 0);
+    if (statement.failed) {
+        putText(buffer, statement.error);
+    }
+    putSigned(buffer, statement.result);
+    putVarint(buffer, statement.parameters.size());
+    for (const auto& row : statement.parameters) {
+        putVarint(buffer, row.size());
+        for (const auto& value : row) {
+            putValue(buffer, value);
+        }
+    }
+    putVarint(buffer, statement.generated_keys.size());
+    for (int key : statement.generated_keys) {
+        putSigned(buffer, key);
+    }
+    putVarint(buffer, statement.rows.size());
+    for (const auto& row : statement.rows) {
+        putVarint(buffer, row.size());
+        for (const auto& cell : row) {
+            putVarint(buffer, stringId(cell.column));
+            buffer += static_cast<char>(cell.getter);
+            putValue(buffer, cell.value);
+        }
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+void TraceWriter::writeTransaction(TraceTransaction call, std::chrono::nanoseconds duration) {
+    std::lock_guard<std::mutex> lock(mutex);
+    buffer.assign(1, static_cast<char>(TRANSACTION));
+    buffer += static_cast<char>(call);
+    putVarint(buffer, static_cast<std::uint64_t>(duration.count() > 0 ? duration.count() : 0));
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+void TraceWriter::writeIsolationLevel(const std::string& level) {
+    std::lock_guard<std::mutex> lock(mutex);
+    buffer.assign(1, static_cast<char>(ISOLATION_LEVEL));
+    putVarint(buffer, stringId(level));
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+void TraceWriter::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    file.flush();
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include "InMemoryEngine.h"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file SessionTrace.h
+ * @brief Binary trace of the statements a session sent to an IDatabase.
+ *
+ * RecordingDatabase writes one TraceStatement per executed statement (SQL
+ * text, bound parameters, outcome, the cells the caller read from its
+ * result set and the execution time) and ReplayDatabase serves them back.
+ *
+ * File layout: the 8 byte header "HMTRACE1", then records that each start
+ * with a tag byte. Integers are LEB128 varints (signed ones zigzag encoded),
+ * doubles are 8 little-endian bytes. SQL texts and column names are written
+ * once as a string record and referenced by number afterwards, so a trace
+ * costs a few bytes per parameter and cell. A record cut short by a crash
+ * at the end of the file is ignored when loading.
+ */
+
+/// Statement method a TraceStatement records.
+enum class TraceCall : std::uint8_t { Execute, ExecuteUpdate, ExecuteInsert, ExecuteQuery, ExecuteBatch };
+
+/// Result set getter a TraceCell records.
+enum class TraceGetter : std::uint8_t { Int, Double, String, Boolean, IsNull };
+
+/// Transaction method a trace records.
+enum class TraceTransaction : std::uint8_t { Begin, Commit, Rollback };
+
+/**
+ * @struct TraceCell
+ * @brief One value the caller read from a result row.
+ */
+struct TraceCell {
+    std::string column;     ///< Column label, or "#<index>" for access by index.
+    TraceGetter getter;     ///< Getter called.
+    SqlValue value;         ///< Returned value (booleans as 0/1).
+};
+
+using TraceRow = std::vector<TraceCell>;
+
+/**
+ * @struct TraceStatement
+ * @brief One executed statement.
+ */
+struct TraceStatement {
+    std::string sql;                                ///< SQL text as prepared.
+    TraceCall call = TraceCall::Execute;            ///< Method called.
+    std::vector<std::vector<SqlValue>> parameters;  ///< Bound values by index - 1; one row per batch row.
+    bool failed = false;                            ///< Whether the call threw.
+    std::string error;                              ///< what() of the exception when failed.
+    long long result = 0;                           ///< Return value of execute (0/1), executeUpdate, executeInsert or executeBatch.
+    std::vector<int> generated_keys;                ///< getGeneratedKeys() after the call.
+    std::vector<TraceRow> rows;                     ///< Rows read by the caller (ExecuteQuery).
+    std::chrono::nanoseconds duration{ 0 };         ///< Time spent in the call.
+};
+
+/**
+ * @struct SessionTrace
+ * @brief Loaded content of a trace file.
+ */
+struct SessionTrace {
+    std::vector<TraceStatement> statements;         ///< In the order they completed.
+    std::size_t transactions = 0;                   ///< Recorded beginTransaction() calls.
+    std::string isolation_level;                    ///< Last isolation level reported during recording, empty if never asked.
+
+    /**
+     * @brief Read a trace file.
+     * @param path File written by TraceWriter.
+     * @return SessionTrace Content of the file.
+     * @throws std::runtime_error if the file cannot be read or is not a trace.
+     */
+    static SessionTrace load(const std::string& path);
+};
+
+/**
+ * @class TraceWriter
+ * @brief Thread-safe appender of trace records.
+ */
+class TraceWriter {
+private:
+    std::mutex mutex;                                           ///< Serializes records.
+    std::ofstream file;
+    std::unordered_map<std::string, std::uint64_t> strings;     ///< Ids of the strings written so far.
+    std::string buffer;                                         ///< Record being encoded.
+
+    std::uint64_t stringId(const std::string& text);
+
+public:
+    /**
+     * @brief Create or truncate a trace file and write its header.
+     * @param path File path.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    explicit TraceWriter(const std::string& path);
+
+    void write(const TraceStatement& statement);
+    void writeTransaction(TraceTransaction call, std::chrono::nanoseconds duration);
+    void writeIsolationLevel(const std::string& level);
+
+    /**
+     * @brief Push the written records to the file.
+     */
+    void flush();
+};
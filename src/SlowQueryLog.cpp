@@ -0,0 +1,251 @@
+#include "SlowQueryLog.h"
+#include "DateTime.h"
+#include "QueryProfiler.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    const char* const REDACTED = "'<redacted>'";
+
+    /// Columns holding customer data.
+    bool isPiiColumn(const std::string& column) {
+        return column == "name" || column == "phone_number" || column == "phone" || column == "email";
+    }
+
+    std::string lower(std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return text;
+    }
+
+    bool looksLikeContact(const std::string& text) {
+        if (text.find('@') != std::string::npos) {
+            return true;
+        }
+        std::size_t start = !text.empty() && text[0] == '+' ? 1 : 0;
+        std::size_t digits = text.size() - start;
+        return digits >= 8 && digits <= 15
+            && std::all_of(text.begin() + start, text.end(), [](unsigned char c) { return std::isdigit(c) != 0; });
+    }
+
+    /// Dates, times and numbers ("2027-01-02 12:00:00", "12.50") identify no one.
+    bool looksLikeDateOrNumber(const std::string& text) {
+        return !text.empty() && std::all_of(text.begin(), text.end(),
+            [](unsigned char c) { return std::isdigit(c) || c == '-' || c == ':' || c == ' ' || c == '.'; });
+    }
+
+    /// Identifiers (lower case, without backticks or table prefix), operators and `?`; literals become "'".
+    std::vector<std::string> tokenize(const std::string& sql) {
+        std::vector<std::string> tokens;
+        std::size_t i = 0;
+        while (i < sql.size()) {
+            unsigned char c = static_cast<unsigned char>(sql[i]);
+            if (std::isspace(c)) {
+                ++i;
+            }
+            else if (c == '\'' || c == '"') {
+                std::size_t close = i + 1;
+                while (close < sql.size() && sql[close] != static_cast<char>(c)) {
+                    close += sql[close] == '\\' ? 2 : 1;
+                }
+                tokens.push_back("'");
+                i = close + 1;
+            }
+            else if (std::isalnum(c) || c == '_' || c == '`') {
+                std::string word;
+                while (i < sql.size() && (std::isalnum(static_cast<unsigned char>(sql[i])) || sql[i] == '_' || sql[i] == '`' || sql[i] == '.')) {
+                    if (sql[i] == '.') {
+                        word.clear();
+                    }
+                    else if (sql[i] != '`') {
+                        word += sql[i];
+                    }
+                    ++i;
+                }
+                tokens.push_back(lower(word));
+            }
+            else if ((c == '<' || c == '>' || c == '!') && i + 1 < sql.size() && (sql[i + 1] == '=' || sql[i + 1] == '>')) {
+                tokens.push_back(sql.substr(i, 2));
+                i += 2;
+            }
+            else {
+                tokens.push_back(std::string(1, static_cast<char>(c)));
+                ++i;
+            }
+        }
+        return tokens;
+    }
+
+    /// Column each `?` is bound to, empty where the SQL does not tell.
+    std::vector<std::string> placeholderColumns(const std::string& sql) {
+        std::vector<std::string> tokens = tokenize(sql);
+        std::vector<std::string> insert_columns;
+        std::size_t values_start = tokens.size();
+        if (!tokens.empty() && (tokens[0] == "insert" || tokens[0] == "replace")) {
+            auto open = std::find(tokens.begin(), tokens.end(), "(");
+            auto values = std::find(tokens.begin(), tokens.end(), "values");
+            if (open < values) {
+                for (auto it = open + 1; it < values && *it != ")"; ++it) {
+                    if (*it != ",") {
+                        insert_columns.push_back(*it);
+                    }
+                }
+            }
+            values_start = static_cast<std::size_t>(values - tokens.begin());
+        }
+
+        static const std::set<std::string> comparisons = { "=", "<>", "!=", "<", ">", "<=", ">=", "like" };
+        std::vector<std::string> columns;
+        std::size_t value_position = 0;
+        for (std::size_t i = 0; i < tokens.size(); ++i) {
+            if (tokens[i] != "?") {
+                continue;
+            }
+            std::string column;
+            if (i > values_start && !insert_columns.empty()) {
+                column = insert_columns[value_position++ % insert_columns.size()];
+            }
+            else if (i >= 2 && comparisons.count(tokens[i - 1]) != 0) {
+                column = tokens[i - 2];
+            }
+            else {
+                // "column IN (?, ?)" and "column BETWEEN ? AND ?"
+                std::size_t j = i;
+                while (j > 0 && (tokens[j - 1] == "?" || tokens[j - 1] == "," || tokens[j - 1] == "and")) {
+                    --j;
+                }
+                if (j >= 3 && tokens[j - 1] == "(" && tokens[j - 2] == "in") {
+                    column = tokens[j - 3];
+                }
+                else if (j >= 2 && tokens[j - 1] == "between") {
+                    column = tokens[j - 2];
+                }
+            }
+            columns.push_back(column);
+        }
+        return columns;
+    }
+
+    /// Tables an EXPLAIN FORMAT=JSON plan reads with access_type ALL.
+    std::vector<std::string> fullScans(const std::string& plan) {
+        std::vector<std::string> tables;
+        const std::string table_key = "\"table_name\": \"";
+        std::size_t position = 0;
+        while ((position = plan.find("\"access_type\": \"ALL\"", position)) != std::string::npos) {
+            std::size_t table = plan.rfind(table_key, position);
+            if (table != std::string::npos) {
+                std::size_t start = table + table_key.size();
+                tables.push_back(plan.substr(start, plan.find('"', start) - start));
+            }
+            ++position;
+        }
+        return tables;
+    }
+}
+
+// Private Functions Definition
+void SlowQueryLog::open() {
+    std::error_code error;
+    std::uintmax_t size = std::filesystem::file_size(config.path, error);
+    file_bytes = error ? 0 : size;
+    file.open(config.path, std::ios::app);
+}
+
+void SlowQueryLog::rotate() {
+    file.close();
+    std::error_code error;
+    if (config.max_files == 0) {
+        std::filesystem::remove(config.path, error);
+    }
+    else {
+        std::filesystem::remove(config.path + "." + std::to_string(config.max_files), error);
+        for (std::size_t i = config.max_files - 1; i >= 1; --i) {
+            std::filesystem::rename(config.path + "." + std::to_string(i), config.path + "." + std::to_string(i + 1), error);
+        }
+        std::filesystem::rename(config.path, config.path + ".1", error);
+    }
+    open();
+}
+
+// Constructors Definition
+SlowQueryLog::SlowQueryLog(SlowQueryLogConfig config) : config(std::move(config)), file_bytes(0) {}
+
+// Public Functions Definition
+const SlowQueryLogConfig& SlowQueryLog::getConfig() const { return config; }
+
+bool SlowQueryLog::isSlow(std::chrono::nanoseconds duration) const { return duration >= config.threshold; }
+
+bool SlowQueryLog::isExplainable(const std::string& sql) {
+    std::vector<std::string> tokens = tokenize(sql.substr(0, 16));
+    if (tokens.empty()) {
+        return false;
+    }
+    return tokens[0] == "select" || tokens[0] == "insert" || tokens[0] == "update" || tokens[0] == "delete" || tokens[0] == "replace";
+}
+
+std::vector<std::string> SlowQueryLog::redactParameters(const std::string& sql, const std::vector<std::string>& parameters) {
+    std::vector<std::string> columns = placeholderColumns(sql);
+    std::vector<std::string> redacted;
+    redacted.reserve(parameters.size());
+    for (std::size_t i = 0; i < parameters.size(); ++i) {
+        const std::string& literal = parameters[i];
+        bool text = literal.size() >= 2 && literal.front() == '\'' && literal.back() == '\'';
+        if (!text) {
+            redacted.push_back(literal);
+            continue;
+        }
+        std::string value = literal.substr(1, literal.size() - 2);
+        std::string column = i < columns.size() ? columns[i] : "";
+        bool hidden = looksLikeContact(value) || isPiiColumn(column) || (column.empty() && !looksLikeDateOrNumber(value));
+        redacted.push_back(hidden ? REDACTED : literal);
+    }
+    return redacted;
+}
+
+void SlowQueryLog::log(const std::string& sql, const std::vector<std::string>& parameters, std::chrono::nanoseconds duration, const PlanProvider& plan) {
+    std::string normalized = QueryProfiler::normalize(sql);
+    bool first = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        first = explained.insert(normalized).second;
+    }
+
+    std::ostringstream entry;
+    entry << "# " << DateTime().getDateTimeString() << "  " << std::fixed << std::setprecision(1)
+        << static_cast<double>(duration.count()) / 1e6 << " ms" << (first ? "  (first occurrence)" : "") << '\n'
+        << normalized << '\n';
+    if (!parameters.empty()) {
+        entry << "parameters:";
+        for (const auto& parameter : redactParameters(sql, parameters)) {
+            entry << ' ' << parameter;
+        }
+        entry << '\n';
+    }
+    if (first && config.capture_plans && plan && isExplainable(sql)) {
+        try {
+            std::string json = plan();
+            for (const auto& table : fullScans(json)) {
+                entry << "warning: full table scan on " << table << '\n';
+            }
+            entry << "plan: " << json << '\n';
+        }
+        catch (const std::exception& e) {
+            entry << "plan unavailable: " << e.what() << '\n';
+        }
+    }
+    entry << '\n';
+    std::string text = entry.str();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file.is_open()) {
+        open();
+    }
+    if (file_bytes > 0 && file_bytes + text.size() > config.max_file_bytes) {
+        rotate();
+    }
+    file << text;
+    file.flush();
+    file_bytes += text.size();
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @file SlowQueryLog.h
+ * @brief Rotating log of statements slower than a threshold.
+ *
+ * MySQLDatabase and MySQLConnectionPool time every execution of their
+ * statements and hand the slow ones to a SlowQueryLog, which appends an entry
+ * with the time, duration, SQL text and bound parameters. The first time a
+ * statement (grouped by QueryProfiler::normalize()) is logged, the entry also
+ * carries its `EXPLAIN FORMAT=JSON` plan and a note for every table the plan
+ * reads with a full scan, so a query that lost its index shows up without
+ * anyone reading plans. When the file would exceed max_file_bytes it is
+ * renamed to `<path>.1` (older files shift to `.2`, ... up to max_files) and
+ * a new one is started.
+ *
+ * Parameters bound to customer data are written as `'<redacted>'`: text bound
+ * to the name, phone_number or email columns, text bound where the column
+ * cannot be told from the SQL, and any text that looks like an e-mail address
+ * or phone number. Numbers and dates are kept, as they identify rooms,
+ * bookings and ranges rather than people.
+ */
+
+/**
+ * @struct SlowQueryLogConfig
+ * @brief Settings of a SlowQueryLog.
+ */
+struct SlowQueryLogConfig {
+    std::chrono::milliseconds threshold{ 100 };     ///< Executions taking at least this long are logged.
+    std::string path = "SlowQueries.log";           ///< Current log file.
+    std::uintmax_t max_file_bytes = 1024 * 1024;    ///< Size at which the file is rotated.
+    std::size_t max_files = 3;                      ///< Rotated files kept besides the current one.
+    bool capture_plans = true;                      ///< Run EXPLAIN FORMAT=JSON on the first occurrence of a statement.
+};
+
+/**
+ * @class SlowQueryLog
+ * @brief Thread-safe slow-query log shared by the connections of a database.
+ */
+class SlowQueryLog {
+public:
+    /// Returns the `EXPLAIN FORMAT=JSON` output of the logged statement; may throw.
+    using PlanProvider = std::function<std::string()>;
+
+private:
+    SlowQueryLogConfig config;
+    std::mutex mutex;                       ///< Guards file, file_bytes and explained.
+    std::ofstream file;
+    std::uintmax_t file_bytes;              ///< Size of the current file.
+    std::set<std::string> explained;        ///< Normalized statements whose plan was captured.
+
+    /**
+     * @brief Open the current file for appending, creating it if needed.
+     */
+    void open();
+
+    /**
+     * @brief Shift the rotated files and start a new current file.
+     */
+    void rotate();
+
+public:
+    /**
+     * @brief Create a log; the file is opened lazily.
+     * @param config Threshold, path and rotation settings.
+     */
+    explicit SlowQueryLog(SlowQueryLogConfig config = SlowQueryLogConfig());
+
+    /**
+     * @brief Get the settings.
+     * @return const SlowQueryLogConfig& Settings given to the constructor.
+     */
+    const SlowQueryLogConfig& getConfig() const;
+
+    /**
+     * @brief Check whether an execution has to be logged.
+     * @param duration Execution time.
+     * @return true if duration reaches the threshold.
+     */
+    bool isSlow(std::chrono::nanoseconds duration) const;
+
+    /**
+     * @brief Check whether a statement can be explained.
+     * @param sql SQL text.
+     * @return true for SELECT, INSERT, UPDATE, DELETE and REPLACE.
+     */
+    static bool isExplainable(const std::string& sql);
+
+    /**
+     * @brief Render bound parameters, hiding customer data.
+     * @param sql SQL text the parameters are bound to.
+     * @param parameters Parameters as SQL literals by index - 1 (text quoted with `'`, NULL for unbound).
+     * @return std::vector<std::string> Literals with PII text replaced by `'<redacted>'`.
+     */
+    static std::vector<std::string> redactParameters(const std::string& sql, const std::vector<std::string>& parameters);
+
+    /**
+     * @brief Append an entry for a slow execution.
+     * @param sql SQL text.
+     * @param parameters Parameters as SQL literals (see redactParameters()); redacted here.
+     * @param duration Execution time.
+     * @param plan Called on the first occurrence of the statement when plans are captured.
+     */
+    void log(const std::string& sql, const std::vector<std::string>& parameters, std::chrono::nanoseconds duration, const PlanProvider& plan);
+};
@@ -31,6 +31,7 @@ public:
 	 */
 	std::string getType() const override { return "standard"; }
 	double getTotalPrice()const override { return Room::getBasePrice(); }
+	std::unique_ptr<Room> clone() const override { return std::make_unique<StandardRoom>(*this); }
 	/**
 	 * @brief Serializes the StandardRoom object to a string.
 	 * @details Extends the base Room toString() by appending room type and price information.
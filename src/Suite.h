@@ -42,6 +42,7 @@ public:
 	 * @return double The total price per night including optional jacuzzi cost.
 	 */
 	double getTotalPrice() const override { return Room::getBasePrice() + (has_jacuzzi ? getJacuzziCost() : 0); }
+	std::unique_ptr<Room> clone() const override { return std::make_unique<Suite>(*this); }
 	/**
 	 * @brief Checks.
 	 * @return bool The .
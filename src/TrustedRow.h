@@ -0,0 +1,19 @@
+#pragma once
+
+/**
+ * @file TrustedRow.h
+ * @brief Tag for constructing entities from rows the database already validated.
+ */
+
+/**
+ * @struct TrustedRow
+ * @brief Selects the entity constructors that skip domain validation.
+ *
+ * The schema enforces the same rules as the validating constructors (CHECK
+ * constraints on email, phone, status and dates), so re-checking every row a
+ * repository loads only costs time. Only repository row mapping should use
+ * these constructors; everything else goes through the validating ones.
+ */
+struct TrustedRow {
+	explicit TrustedRow() = default;
+};
@@ -0,0 +1,180 @@
+#pragma once
+#include "Room.h"
+#include "Customer.h"
+#include "Booking.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+/**
+ * @file UnitOfWork.h
+ * @brief Identity map that memoizes entity lookups for one manager operation.
+ *
+ * A manager operation such as creating a booking validates the room and the
+ * customer, checks availability and prices the stay, and each step used to
+ * load the same rows again. While a UnitOfWork::Scope is open, the first
+ * lookup of a room, customer or booking goes to the repository and later
+ * lookups of the same key reuse its result, including "not found":
+ * @code
+ * UnitOfWork::Scope scope(unit_of_work);
+ * auto room = unit_of_work.findRoom(room_number, [&] { return room_repo.findRoomByNumber(room_number); });
+ * @endcode
+ * Entries live until the outermost scope closes, so nothing is shared between
+ * operations. Code that changes an entity must call the matching forget*()
+ * method so the rest of the operation does not see the old value. Scopes are
+ * tracked per thread; lookups on a thread without an open scope are not
+ * memoized.
+ */
+
+/**
+ * @class UnitOfWork
+ * @brief Per-operation, per-thread cache of rooms, customers and bookings.
+ */
+class UnitOfWork {
+public:
+    using RoomEntry = std::shared_ptr<const Room>;         ///< nullptr when the room does not exist.
+    using CustomerEntry = std::optional<Customer>;         ///< std::nullopt when the customer does not exist.
+    using BookingEntry = std::optional<Booking>;           ///< std::nullopt when the booking does not exist.
+
+private:
+    /**
+     * @struct Work
+     * @brief Entities read by the operation open on one thread.
+     */
+    struct Work {
+        int depth = 0; ///< Number of nested scopes currently open.
+        std::map<int, RoomEntry> rooms;
+        std::map<int, CustomerEntry> customers;
+        std::map<int, BookingEntry> bookings;
+    };
+
+    mutable std::mutex mutex;                 ///< Guards active.
+    std::map<std::thread::id, Work> active;   ///< Open operations, one per thread.
+
+    /**
+     * @brief Return the memoized entry for a key, loading it on first use.
+     *
+     * The load runs without holding the mutex, so it may query the database.
+     *
+     * @param entries Map of the entity kind being looked up.
+     * @param key Entity key.
+     * @param load Callable returning the entry from the repository.
+     * @return Entry Memoized or freshly loaded entry.
+     */
+    template <typename Entry, typename Load>
+    Entry find(std::map<int, Entry> Work::* entries, int key, Load&& load) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto work = active.find(std::this_thread::get_id());
+            if (work == active.end()) {
+                return load();
+            }
+            auto& map = work->second.*entries;
+            auto it = map.find(key);
+            if (it != map.end()) {
+                return it->second;
+            }
+        }
+        Entry entry = load();
+        std::lock_guard<std::mutex> lock(mutex);
+        auto work = active.find(std::this_thread::get_id());
+        if (work != active.end()) {
+            (work->second.*entries)[key] = entry;
+        }
+        return entry;
+    }
+
+    /**
+     * @brief Drop a memoized entry so the next lookup reloads it.
+     * @param entries Map of the entity kind being changed.
+     * @param key Entity key.
+     */
+    template <typename Entry>
+    void forget(std::map<int, Entry> Work::* entries, int key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto work = active.find(std::this_thread::get_id());
+        if (work != active.end()) {
+            (work->second.*entries).erase(key);
+        }
+    }
+
+public:
+    /**
+     * @class Scope
+     * @brief RAII guard marking the duration of one manager operation.
+     *
+     * Scopes nest: an operation calling another keeps a single identity map,
+     * which is cleared when the outermost scope closes.
+     */
+    class Scope {
+        UnitOfWork& work;
+    public:
+        explicit Scope(UnitOfWork& work) : work(work) {
+            std::lock_guard<std::mutex> lock(work.mutex);
+            ++work.active[std::this_thread::get_id()].depth;
+        }
+
+        ~Scope() {
+            std::lock_guard<std::mutex> lock(work.mutex);
+            auto it = work.active.find(std::this_thread::get_id());
+            if (it != work.active.end() && --it->second.depth == 0) {
+                work.active.erase(it);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    UnitOfWork() = default;
+    UnitOfWork(const UnitOfWork&) = delete;
+    UnitOfWork& operator=(const UnitOfWork&) = delete;
+
+    /**
+     * @brief Whether the calling thread has an operation in progress.
+     * @return true if a Scope is open on this thread.
+     */
+    bool isActive() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return active.count(std::this_thread::get_id()) != 0;
+    }
+
+    /**
+     * @brief Look up a room, loading it at most once per operation.
+     * @param room_number Room number.
+     * @param load Callable returning the room as a std::unique_ptr<Room> (nullptr if missing).
+     * @return RoomEntry Shared, read-only room; nullptr if it does not exist.
+     */
+    template <typename Load>
+    RoomEntry findRoom(int room_number, Load&& load) {
+        return find(&Work::rooms, room_number, [&load]() -> RoomEntry { return load(); });
+    }
+
+    /**
+     * @brief Look up a customer, loading it at most once per operation.
+     * @param customer_id Customer id.
+     * @param load Callable returning a CustomerEntry.
+     * @return CustomerEntry Customer, or std::nullopt if it does not exist.
+     */
+    template <typename Load>
+    CustomerEntry findCustomer(int customer_id, Load&& load) {
+        return find(&Work::customers, customer_id, load);
+    }
+
+    /**
+     * @brief Look up a booking, loading it at most once per operation.
+     * @param booking_id Booking id.
+     * @param load Callable returning a BookingEntry.
+     * @return BookingEntry Booking, or std::nullopt if it does not exist.
+     */
+    template <typename Load>
+    BookingEntry findBooking(int booking_id, Load&& load) {
+        return find(&Work::bookings, booking_id, load);
+    }
+
+    void forgetRoom(int room_number) { forget(&Work::rooms, room_number); }          ///< Call after changing or deleting a room.
+    void forgetCustomer(int customer_id) { forget(&Work::customers, customer_id); }  ///< Call after changing or deleting a customer.
+    void forgetBooking(int booking_id) { forget(&Work::bookings, booking_id); }      ///< Call after changing or deleting a booking.
+};
@@ -1,13 +1,22 @@
 #include<iostream>
+#include<string>
 #include "HotelSystem.h"
 #include "MySQLDatabase.h"
 #include "DatabaseConfig.h"
 
-int main() {
+int main(int argc, char* argv[]) {
 	try {
 
+	// "--record <file>" writes the session to a trace that ReplayDatabase can serve back.
+	// The trace holds customer data unredacted (see HotelSystem::HotelSystem()).
+	std::string trace_path;
+	for (int i = 1; i + 1 < argc; i++) {
+		if (std::string(argv[i]) == "--record") {
+			trace_path = argv[i + 1];
+		}
+	}
 	DatabaseConfig config=DatabaseConfig::loadFromFile("DatabaseConfig.txt");
-	HotelSystem hotel(config);
+	HotelSystem hotel(config, "QueryProfile.txt", trace_path);
 	hotel.run();
 	}
 	catch (const std::exception& e) {
@@ -0,0 +1,300 @@
+#include "Test.h"
+#include "TestDatabase.h"
+#include "HotelManager.h"
+#include "RoomRepository.h"
+#include "BookingRepository.h"
+#include "ScopedTransaction.h"
+#include <chrono>
+
+/*
+ * InMemoryDatabase against the SQL the application issues: schema migrations,
+ * CRUD through HotelManager with its caches on and off, transactions, batch
+ * inserts and the constraints of init.sql.
+ */
+
+namespace {
+    const std::chrono::milliseconds NO_CACHE{ 0 };
+
+    const DateTime CHECK_IN("2030-03-10 14:00:00");
+    const DateTime CHECK_OUT("2030-03-13 11:00:00");
+
+    /// Number of rows of a table.
+    int countRows(IDatabase& database, const std::string& table) {
+        auto result = database.prepareStatement("SELECT COUNT(*) AS n FROM " + table)->executeQuery();
+        result->next();
+        return result->getInt("n");
+    }
+
+    /// Number of indexes of the bookings table, PRIMARY included.
+    int bookingIndexCount(IDatabase& database) {
+        auto result = database.prepareStatement(
+            "SELECT DISTINCT INDEX_NAME FROM information_schema.statistics WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = 'bookings'")->executeQuery();
+        int indexes = 0;
+        while (result->next()) {
+            ++indexes;
+        }
+        return indexes;
+    }
+
+    /// Inserts a customer with raw SQL, bypassing the validation of Customer.
+    void insertCustomer(IDatabase& database, int age, const std::string& phone, const std::string& email) {
+        auto stmt = database.prepareStatement("INSERT INTO customers (age, name, phone_number, email) VALUES (?, ?, ?, ?)");
+        stmt->setInt(1, age);
+        stmt->setString(2, "Test Customer");
+        stmt->setString(3, phone);
+        stmt->setString(4, email);
+        stmt->executeUpdate();
+    }
+
+    /// Inserts a booking with raw SQL, bypassing the validation of Booking.
+    void insertBooking(IDatabase& database, const std::string& check_in, const std::string& check_out, double cost, const std::string& status) {
+        auto stmt = database.prepareStatement(
+            "INSERT INTO bookings (room_number, customer_id, check_in, check_out, cost, status) VALUES (1, 1, ?, ?, ?, ?)");
+        stmt->setString(1, check_in);
+        stmt->setString(2, check_out);
+        stmt->setDouble(3, cost);
+        stmt->setString(4, status);
+        stmt->executeUpdate();
+    }
+
+    /**
+     * Books a room, checks availability around the booking, moves and cancels
+     * it. Run once with the room cache and booking index disabled and once
+     * with their defaults: both paths must give the same answers.
+     */
+    void bookingLifecycle(std::chrono::milliseconds staleness) {
+        TestDatabase db;
+        HotelManager manager(db.database, staleness, staleness);
+        int standard = manager.addStandardRoom("available", 80.0)->getNumber();
+        int deluxe = manager.addDeluxeRoom("available", 120.0, 30.0)->getNumber();
+        manager.addSuite("maintenance", 300.0, true, 50.0);
+        int customer_id = manager.addNewCustomer("Ada Lovelace", 36, "+3551234567", "ada@example.com").getId();
+
+        CHECK_EQ(manager.getAvailableRooms(CHECK_IN, CHECK_OUT).size(), 2u);
+        Booking booking = manager.addNewBooking(CHECK_IN, CHECK_OUT, customer_id, deluxe, "pending");
+        CHECK_EQ(booking.getCost(), 150.0 * (CHECK_OUT - CHECK_IN));
+        CHECK_EQ(manager.getBookingById(booking.getId()).getRoomNumber(), deluxe);
+
+        auto available = manager.getAvailableRooms(CHECK_IN, CHECK_OUT);
+        CHECK_EQ(available.size(), 1u);
+        CHECK_EQ(available.front()->getNumber(), standard);
+        CHECK(!manager.isRoomAvailableForDate(deluxe, CHECK_IN, CHECK_OUT, -1));
+        CHECK_THROWS(manager.addNewBooking(DateTime("2030-03-12 14:00:00"), DateTime("2030-03-15 11:00:00"), customer_id, deluxe, "pending"),
+            "not available");
+        // A stay starting on the check-out day does not overlap.
+        manager.addNewBooking(DateTime("2030-03-13 14:00:00"), DateTime("2030-03-14 11:00:00"), customer_id, deluxe, "pending");
+
+        manager.updateBookingDates(booking.getId(), DateTime("2030-04-01 14:00:00"), DateTime("2030-04-03 11:00:00"));
+        CHECK_EQ(manager.getAvailableRooms(CHECK_IN, DateTime("2030-03-12 11:00:00")).size(), 2u);
+        manager.updateBookingStatus(booking.getId(), "Cancelled");
+        CHECK_EQ(manager.getBookingById(booking.getId()).getStatus(), std::string("cancelled"));
+
+        manager.updateRoomStatus(standard, "maintenance");
+        CHECK_EQ(manager.getAvailableRooms(DateTime("2030-05-01 14:00:00"), DateTime("2030-05-02 11:00:00")).size(), 1u);
+        manager.deleteRoom(standard);
+        CHECK_THROWS(manager.getRoomByNumber(standard), "not found");
+        CHECK_THROWS(manager.deleteCustomer(customer_id), "active bookings");
+    }
+}
+
+TEST_CASE(migrationsRunOnceOnTheInitSchema) {
+    InMemoryDatabase database;
+    database.connect(DatabaseConfig("hotelmanagement", "", "", ""));
+    int latest = SchemaMigrator::getMigrations().back().version;
+    std::ostringstream log;
+    SchemaMigrator migrator(database);
+    CHECK_EQ(migrator.migrate(log), latest);
+    CHECK_EQ(migrator.getCurrentVersion(), latest);
+    CHECK(!log.str().empty());
+    // init.sql already declares the indexes the migrations add: the steps are skipped.
+    CHECK_EQ(bookingIndexCount(database), 4);
+
+    std::ostringstream second_log;
+    CHECK_EQ(SchemaMigrator(database).migrate(second_log), latest);
+    CHECK(second_log.str().empty());
+}
+
+TEST_CASE(migrationsAddIndexesToAnOlderSchema) {
+    InMemoryDatabase database(
+        "CREATE TABLE bookings (booking_id int NOT NULL AUTO_INCREMENT, room_number int NOT NULL, customer_id int NOT NULL, "
+        "check_in datetime NOT NULL, check_out datetime NOT NULL, cost decimal(10,2) NOT NULL, status varchar(20) NOT NULL, "
+        "PRIMARY KEY (booking_id))");
+    database.connect(DatabaseConfig("hotelmanagement", "", "", ""));
+    std::ostringstream log;
+    SchemaMigrator(database).migrate(log);
+
+    CHECK_EQ(bookingIndexCount(database), 4);
+}
+
+TEST_CASE(migrationLockIsReleasedOnEveryPath) {
+    InMemoryDatabase database;
+    database.connect(DatabaseConfig("hotelmanagement", "", "", ""));
+    auto lockReleased = [&database] {
+        // RELEASE_LOCK returns NULL for a lock nobody holds.
+        auto result = database.prepareStatement("SELECT RELEASE_LOCK('schema_migrations') AS released")->executeQuery();
+        return result->next() && result->isNull("released");
+    };
+
+    std::ostringstream log;
+    SchemaMigrator(database).migrate(log);
+    CHECK(lockReleased());
+
+    std::vector<Migration> failing = { { 1000, "Broken", { { "CREATE INDEX idx_missing ON no_such_table (id)", "" } } } };
+    CHECK_THROWS(SchemaMigrator(database, failing).migrate(log), "Schema migration 1000 (Broken) failed");
+    CHECK(lockReleased());
+}
+
+TEST_CASE(bookingLifecycleWithoutCaches) {
+    bookingLifecycle(NO_CACHE);
+}
+
+TEST_CASE(bookingLifecycleWithCaches) {
+    bookingLifecycle(RoomRepository::DEFAULT_CACHE_STALENESS);
+}
+
+TEST_CASE(customersRoundTripAndStayUnique) {
+    TestDatabase db;
+    HotelManager manager(db.database, NO_CACHE, NO_CACHE);
+    int customer_id = manager.addNewCustomer("Ada Lovelace", 36, "+3551234567", "ada@example.com").getId();
+
+    manager.updateCustomerPhone(customer_id, "+3557654321");
+    manager.updateCustomerEmail(customer_id, "ada@example.org");
+    Customer stored = manager.getCustomerById(customer_id);
+    CHECK_EQ(stored.getName(), std::string("Ada Lovelace"));
+    CHECK_EQ(stored.getAge(), 36);
+    CHECK_EQ(stored.getPhoneNumber(), std::string("+3557654321"));
+    CHECK_EQ(stored.getEmail(), std::string("ada@example.org"));
+
+    CHECK_THROWS(manager.addNewCustomer("Charles Babbage", 79, "+3550000000", "ADA@example.org"), "Duplicate entry");
+    CHECK_EQ(manager.getAllCustomers().size(), 1u);
+    manager.deleteCustomer(customer_id);
+    CHECK_THROWS(manager.getCustomerById(customer_id), "not found");
+}
+
+TEST_CASE(rollbackRestoresRows) {
+    TestDatabase db;
+    HotelManager manager(db.database, NO_CACHE, NO_CACHE);
+    int room_number = manager.addStandardRoom("available", 80.0)->getNumber();
+
+    {
+        // The repositories' own transactions join this one; it is destroyed without commit().
+        ScopedTransaction transaction(db.database);
+        manager.updateRoomPrice(room_number, 95.0);
+        manager.updateRoomStatus(room_number, "maintenance");
+        manager.addStandardRoom("available", 60.0);
+    }
+    CHECK(!db.database.isTransactionActive());
+    CHECK_EQ(countRows(db.database, "rooms"), 1);
+    CHECK_EQ(manager.getRoomByNumber(room_number)->getBasePrice(), 80.0);
+    CHECK_EQ(manager.getRoomByNumber(room_number)->getStatus(), std::string("available"));
+
+    db.database.beginTransaction();
+    db.database.prepareStatement("DELETE FROM rooms")->executeUpdate();
+    CHECK_EQ(countRows(db.database, "rooms"), 0);
+    db.database.rollbackTransaction();
+    CHECK_EQ(countRows(db.database, "rooms"), 1);
+}
+
+TEST_CASE(bookingIndexFollowsTheOutermostCommit) {
+    TestDatabase db;
+    HotelManager manager(db.database);
+    int room_number = manager.addStandardRoom("available", 80.0)->getNumber();
+    int customer_id = manager.addNewCustomer("Ada Lovelace", 36, "+3551234567", "ada@example.com").getId();
+    CHECK_EQ(manager.getAvailableRooms(CHECK_IN, CHECK_OUT).size(), 1u);
+
+    {
+        ScopedTransaction transaction(db.database);
+        manager.addNewBooking(CHECK_IN, CHECK_OUT, customer_id, room_number, "pending");
+    }
+    CHECK_EQ(manager.getAvailableRooms(CHECK_IN, CHECK_OUT).size(), 1u);
+
+    {
+        ScopedTransaction transaction(db.database);
+        manager.addNewBooking(CHECK_IN, CHECK_OUT, customer_id, room_number, "pending");
+        transaction.commit();
+    }
+    CHECK(manager.getAvailableRooms(CHECK_IN, CHECK_OUT).empty());
+}
+
+TEST_CASE(batchInsertsReturnGeneratedKeys) {
+    TestDatabase db;
+    RoomRepository rooms(db.database, NO_CACHE);
+    BookingRepository bookings(db.database, NO_CACHE);
+    HotelManager manager(db.database, NO_CACHE, NO_CACHE);
+    int customer_id = manager.addNewCustomer("Ada Lovelace", 36, "+3551234567", "ada@example.com").getId();
+
+    std::vector<std::unique_ptr<Room>> new_rooms;
+    new_rooms.push_back(std::make_unique<StandardRoom>(-1, 80.0, "available"));
+    new_rooms.push_back(std::make_unique<DeluxeRoom>(-1, 120.0, "available", 30.0));
+    new_rooms.push_back(std::make_unique<Suite>(-1, 300.0, "available", false, 0.0));
+    auto added = rooms.addRooms(new_rooms);
+    CHECK_EQ(added.size(), 3u);
+    for (std::size_t i = 0; i < added.size(); ++i) {
+        CHECK_EQ(rooms.getRoomByNumber(added[i]->getNumber())->getType(), new_rooms[i]->getType());
+    }
+
+    std::vector<Booking> new_bookings;
+    for (const auto& room : added) {
+        new_bookings.emplace_back(-1, room->getNumber(), customer_id, room->getTotalPrice(), CHECK_IN, CHECK_OUT, "pending");
+    }
+    std::vector<int> ids = bookings.addBookingsAndGetIds(new_bookings);
+    CHECK_EQ(ids.size(), 3u);
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        CHECK_EQ(bookings.getBookingById(ids[i]).getRoomNumber(), added[i]->getNumber());
+    }
+}
+
+TEST_CASE(checkConstraintsRejectRows) {
+    TestDatabase db;
+    insertCustomer(db.database, 30, "+3551234567", "ada@example.com");
+
+    CHECK_THROWS(insertCustomer(db.database, 121, "+3551111111", "b@example.com"), "Check constraint 'chk_age' is violated");
+    CHECK_THROWS(insertCustomer(db.database, 30, "+3551111111", "not-an-email"), "Check constraint 'chk_email' is violated");
+    CHECK_THROWS(insertCustomer(db.database, 30, "1234", "b@example.com"), "Check constraint 'chk_phone' is violated");
+    CHECK_THROWS(insertCustomer(db.database, 30, "555-1234-567", "b@example.com"), "Check constraint 'chk_phone' is violated");
+    CHECK_EQ(countRows(db.database, "customers"), 1);
+
+    insertBooking(db.database, "2030-03-10 14:00:00", "2030-03-13 11:00:00", 240.0, "pending");
+    CHECK_THROWS(insertBooking(db.database, "2030-03-13 11:00:00", "2030-03-10 14:00:00", 240.0, "pending"), "'chk_dates'");
+    CHECK_THROWS(insertBooking(db.database, "2030-03-10 14:00:00", "2030-03-13 11:00:00", -1.0, "pending"), "'chk_cost'");
+    CHECK_THROWS(insertBooking(db.database, "2030-03-10 14:00:00", "2030-03-13 11:00:00", 240.0, "confirmed"), "'chk_status'");
+    CHECK_EQ(countRows(db.database, "bookings"), 1);
+
+    auto update = db.database.prepareStatement("UPDATE bookings SET status = ?");
+    update->setString(1, "lost");
+    CHECK_THROWS(update->executeUpdate(), "'chk_status'");
+    update->setString(1, "DONE");
+    CHECK_EQ(update->executeUpdate(), 1);
+}
+
+TEST_CASE(failedMultiRowInsertLeavesNoRows) {
+    TestDatabase db;
+    auto stmt = db.database.prepareStatement(
+        "INSERT INTO customers (age, name, phone_number, email) VALUES (30, 'A', '+3551234567', 'a@example.com'), (200, 'B', '+3557654321', 'b@example.com')");
+    CHECK_THROWS(stmt->executeUpdate(), "'chk_age'");
+    CHECK_EQ(countRows(db.database, "customers"), 0);
+}
+
+TEST_CASE(checkConstraintsFollowTheCreateTableText) {
+    InMemoryDatabase database(
+        "CREATE TABLE t (a int, b int CHECK (b > 0), CHECK (a < b), CONSTRAINT off CHECK (a = 0) NOT ENFORCED)");
+    database.connect(DatabaseConfig("test", "", "", ""));
+    auto insert = database.prepareStatement("INSERT INTO t (a, b) VALUES (?, ?)");
+    insert->setInt(1, 1);
+    insert->setInt(2, 2);
+    insert->executeUpdate();
+    insert->setInt(1, 1);
+    insert->setInt(2, 0);
+    CHECK_THROWS(insert->executeUpdate(), "Check constraint 't_chk_1' is violated");
+    insert->setInt(1, 3);
+    insert->setInt(2, 2);
+    CHECK_THROWS(insert->executeUpdate(), "Check constraint 't_chk_2' is violated");
+
+    // A NULL result passes.
+    database.prepareStatement("INSERT INTO t (a, b) VALUES (NULL, 5)")->executeUpdate();
+    CHECK_EQ(countRows(database, "t"), 2);
+}
+
+int main() {
+    return test::runAll();
+}
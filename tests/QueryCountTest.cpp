@@ -0,0 +1,176 @@
+#include "Test.h"
+#include "TestDatabase.h"
+#include "HotelManager.h"
+#include "RoomRepository.h"
+#include "CustomerRepository.h"
+#include "UnitOfWork.h"
+#include <chrono>
+
+/*
+ * Statements issued per HotelManager operation.
+ *
+ * The counts pin down what UnitOfWork saves: within one operation every room,
+ * customer and booking is read at most once. A change that adds a lookup to an
+ * operation fails here and has to update the expected count on purpose.
+ */
+
+namespace {
+    const std::chrono::milliseconds NO_CACHE{ 0 };
+
+    const DateTime CHECK_IN("2030-03-10 14:00:00");
+    const DateTime CHECK_OUT("2030-03-13 11:00:00");
+
+    /// Runs a call and returns the number of statements it executed.
+    template <typename Call>
+    std::uint64_t statementsOf(TestDatabase& db, Call&& call) {
+        std::uint64_t before = db.statementCount();
+        call();
+        return db.statementCount() - before;
+    }
+}
+
+TEST_CASE(unitOfWorkLoadsEachEntityOncePerScope) {
+    TestDatabase db;
+    RoomRepository rooms(db.database, NO_CACHE);
+    int room_number = rooms.addRoom(StandardRoom(-1, 80.0, "available"))->getNumber();
+    UnitOfWork work;
+    auto load = [&] { return rooms.findRoomByNumber(room_number); };
+
+    CHECK_EQ(statementsOf(db, [&] {
+        UnitOfWork::Scope scope(work);
+        work.findRoom(room_number, load);
+        work.findRoom(room_number, load);
+        {
+            UnitOfWork::Scope nested(work);
+            work.findRoom(room_number, load);
+        }
+        work.findRoom(room_number, load);
+    }), 1u);
+
+    // Without a scope every lookup goes to the database.
+    CHECK_EQ(statementsOf(db, [&] {
+        work.findRoom(room_number, load);
+        work.findRoom(room_number, load);
+    }), 2u);
+}
+
+TEST_CASE(unitOfWorkMemoizesMissingEntities) {
+    TestDatabase db;
+    CustomerRepository customers(db.database);
+    UnitOfWork work;
+    auto load = [&] { return customers.findCustomerById(42); };
+
+    CHECK_EQ(statementsOf(db, [&] {
+        UnitOfWork::Scope scope(work);
+        CHECK(!work.findCustomer(42, load));
+        CHECK(!work.findCustomer(42, load));
+    }), 1u);
+}
+
+TEST_CASE(unitOfWorkReloadsForgottenEntities) {
+    TestDatabase db;
+    RoomRepository rooms(db.database, NO_CACHE);
+    int room_number = rooms.addRoom(StandardRoom(-1, 80.0, "available"))->getNumber();
+    UnitOfWork work;
+    auto load = [&] { return rooms.findRoomByNumber(room_number); };
+
+    UnitOfWork::Scope scope(work);
+    work.findRoom(room_number, load);
+    rooms.updateRoomPrice(room_number, 95.0);
+    work.forgetRoom(room_number);
+    CHECK_EQ(work.findRoom(room_number, load)->getBasePrice(), 95.0);
+}
+
+TEST_CASE(addNewBookingWithoutCaches) {
+    TestDatabase db;
+    HotelManager manager(db.database, NO_CACHE, NO_CACHE);
+    int room_number = manager.addStandardRoom("available", 80.0)->getNumber();
+    int customer_id = manager.addNewCustomer("Ada Lovelace", 36, "+3551234567", "ada@example.com").getId();
+
+    // Customer lock, room read and lock, overlap check, insert.
+    CHECK_EQ(statementsOf(db, [&] {
+        manager.addNewBooking(CHECK_IN, CHECK_OUT, customer_id, room_number, "pending");
+    }), 4u);
+    CHECK_THROWS(manager.addNewBooking(CHECK_IN, CHECK_OUT, customer_id + 1, room_number, "pending"), "doesn't exist");
+}
+
+TEST_CASE(addNewBookingWithWarmCaches) {
+    TestDatabase db;
+    HotelManager manager(db.database);
+    int room_number = manager.addStandardRoom("available", 80.0)->getNumber();
+    int customer_id = manager.addNewCustomer("Ada Lovelace", 36, "+3551234567", "ada@example.com").getId();
+    manager.getAllRooms();
+
+    // The room cache does not serve the booking: the room and its conflicts are
+    // read inside the inserting transaction.
+    CHECK_EQ(statementsOf(db, [&] {
+        manager.addNewBooking(CHECK_IN, CHECK_OUT, customer_id, room_number, "pending");
+    }), 4u);
+}
+
+TEST_CASE(availabilityAfterBookingKeepsTheIndex) {
+    TestDatabase db;
+    HotelManager manager(db.database);
+    int room_number = manager.addStandardRoom("available", 80.0)->getNumber();
+    manager.addStandardRoom("available", 60.0);
+    int customer_id = manager.addNewCustomer("Ada Lovelace", 36, "+3551234567", "ada@example.com").getId();
+    CHECK_EQ(manager.getAvailableRooms(CHECK_IN, CHECK_OUT).size(), 2u);
+
+    manager.addNewBooking(CHECK_IN, CHECK_OUT, customer_id, room_number, "pending");
+
+    // The booking reached the interval index and its calendar when its
+    // transaction committed: neither they nor the room cache are reloaded.
+    CHECK_EQ(statementsOf(db, [&] {
+        auto available = manager.getAvailableRooms(CHECK_IN, CHECK_OUT);
+        CHECK_EQ(available.size(), 1u);
+        CHECK(available.front()->getNumber() != room_number);
+    }), 0u);
+}
+
+TEST_CASE(isRoomAvailableForDateReadsRoomOnce) {
+    TestDatabase db;
+    HotelManager manager(db.database, NO_CACHE, NO_CACHE);
+    int room_number = manager.addStandardRoom("available", 80.0)->getNumber();
+
+    // Room, overlap check.
+    CHECK_EQ(statementsOf(db, [&] {
+        CHECK(manager.isRoomAvailableForDate(room_number, CHECK_IN, CHECK_OUT, -1));
+    }), 2u);
+}
+
+TEST_CASE(bookingUpdatesReadBookingOnce) {
+    TestDatabase db;
+    HotelManager manager(db.database, NO_CACHE, NO_CACHE);
+    int room_number = manager.addStandardRoom("available", 80.0)->getNumber();
+    int customer_id = manager.addNewCustomer("Ada Lovelace", 36, "+3551234567", "ada@example.com").getId();
+    int booking_id = manager.addNewBooking(CHECK_IN, CHECK_OUT, customer_id, room_number, "pending").getId();
+
+    // The repository's existence check inside its transaction, update.
+    CHECK_EQ(statementsOf(db, [&] { manager.updateBookingStatus(booking_id, "done"); }), 2u);
+    CHECK_EQ(statementsOf(db, [&] { manager.deleteBooking(booking_id); }), 2u);
+    CHECK_THROWS(manager.updateBookingStatus(booking_id, "done"), "doesn't exist");
+}
+
+TEST_CASE(customerUpdatesReadCustomerOnce) {
+    TestDatabase db;
+    HotelManager manager(db.database, NO_CACHE, NO_CACHE);
+    int customer_id = manager.addNewCustomer("Ada Lovelace", 36, "+3551234567", "ada@example.com").getId();
+
+    // The repository's existence check inside its transaction, update.
+    CHECK_EQ(statementsOf(db, [&] { manager.updateCustomerEmail(customer_id, "ada@example.org"); }), 2u);
+    // Bookings of the customer, existence check, delete.
+    CHECK_EQ(statementsOf(db, [&] { manager.deleteCustomer(customer_id); }), 3u);
+    CHECK_THROWS(manager.deleteCustomer(customer_id), "doesn't exist");
+}
+
+TEST_CASE(profilerResetKeepsLiveStatementsCounting) {
+    TestDatabase db;
+    auto stmt = db.database.prepareStatement("SELECT COUNT(*) AS n FROM rooms");
+    db.database.getProfiler().reset();
+    stmt->executeQuery()->next();
+    CHECK_EQ(db.statementCount(), 1u);
+}
+
+int main() {
+    return test::runAll();
+}
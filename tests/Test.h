@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdio>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @file Test.h
+ * @brief Minimal test runner shared by the regression tests.
+ *
+ * Each test program defines its cases with TEST_CASE and runs them from main()
+ * with test::runAll(). A failed CHECK ends its case and is reported with the
+ * file and line; the program exits with 1 if any case failed.
+ */
+
+namespace test {
+
+    /**
+     * @struct Case
+     * @brief Registered test case.
+     */
+    struct Case {
+        const char* name;
+        void (*body)();
+    };
+
+    /**
+     * @brief Cases registered so far, in definition order.
+     * @return std::vector<Case>& Registry.
+     */
+    inline std::vector<Case>& cases() {
+        static std::vector<Case> registered;
+        return registered;
+    }
+
+    /// Registers a case when constructed; used by TEST_CASE.
+    struct Registration {
+        Registration(const char* name, void (*body)()) {
+            cases().push_back(Case{ name, body });
+        }
+    };
+
+    /// Thrown by a failed check.
+    struct Failure : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+    /**
+     * @brief Fail the running case.
+     * @param file Source file of the check.
+     * @param line Line of the check.
+     * @param message What was expected.
+     */
+    [[noreturn]] inline void fail(const char* file, int line, const std::string& message) {
+        throw Failure(std::string(file) + ":" + std::to_string(line) + ": " + message);
+    }
+
+    /**
+     * @brief Run every registered case and print one line per case.
+     * @return int 0 when all cases passed, 1 otherwise.
+     */
+    inline int runAll() {
+        int failed = 0;
+        for (const auto& entry : cases()) {
+            try {
+                entry.body();
+                std::printf("ok    %s\n", entry.name);
+            }
+            catch (const std::exception& e) {
+                ++failed;
+                std::printf("FAIL  %s\n      %s\n", entry.name, e.what());
+            }
+        }
+        std::printf("%d of %zu cases failed\n", failed, cases().size());
+        return failed == 0 ? 0 : 1;
+    }
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static const test::Registration name##_registration(#name, &name); \
+    static void name()
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            test::fail(__FILE__, __LINE__, "CHECK(" #condition ") failed"); \
+        } \
+    } while (false)
+
+#define CHECK_EQ(actual, expected) \
+    do { \
+        const auto actual_value = (actual); \
+        const auto expected_value = (expected); \
+        if (!(actual_value == expected_value)) { \
+            std::ostringstream message; \
+            message << #actual " is " << actual_value << ", expected " << expected_value; \
+            test::fail(__FILE__, __LINE__, message.str()); \
+        } \
+    } while (false)
+
+/// Checks that the statement throws a std::exception whose message contains fragment.
+#define CHECK_THROWS(statement, fragment) \
+    do { \
+        bool thrown = false; \
+        try { \
+            statement; \
+        } \
+        catch (const test::Failure&) { \
+            throw; \
+        } \
+        catch (const std::exception& e) { \
+            thrown = true; \
+            if (std::string(e.what()).find(fragment) == std::string::npos) { \
+                test::fail(__FILE__, __LINE__, std::string("unexpected error: ") + e.what()); \
+            } \
+        } \
+        if (!thrown) { \
+            test::fail(__FILE__, __LINE__, #statement " did not throw"); \
+        } \
+    } while (false)
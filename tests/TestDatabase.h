@@ -0,0 +1,49 @@
+#pragma once
+#include "DatabaseConfig.h"
+#include "InMemoryDatabase.h"
+#include "InstrumentedDatabase.h"
+#include "SchemaMigrator.h"
+#include <cstdint>
+#include <sstream>
+
+/**
+ * @file TestDatabase.h
+ * @brief Migrated in-memory database that counts the statements run against it.
+ *
+ * Every case starts from its own empty schema, created from init.sql and
+ * brought to the latest version by SchemaMigrator, exactly as the application
+ * does at startup. Statements go through an InstrumentedDatabase, so a case
+ * can count how many a call issued:
+ * @code
+ * TestDatabase db;
+ * HotelManager manager(db.database);
+ * std::uint64_t before = db.statementCount();
+ * manager.getRoomByNumber(101);
+ * CHECK_EQ(db.statementCount() - before, 1u);
+ * @endcode
+ */
+struct TestDatabase {
+    InMemoryDatabase memory;         ///< Backend holding the tables.
+    InstrumentedDatabase database;   ///< What the code under test is given.
+
+    TestDatabase() : database(memory) {
+        database.connect(DatabaseConfig("hotelmanagement", "", "", ""));
+        std::ostringstream log;
+        SchemaMigrator(database).migrate(log);
+    }
+
+    /**
+     * @brief Count the statements executed so far, failed ones included.
+     * @return std::uint64_t Executions over all statements; transaction begins and commits are not counted.
+     */
+    std::uint64_t statementCount() {
+        std::uint64_t calls = 0;
+        for (const auto& stats : database.getProfiler().getQueryStats()) {
+            calls += stats.calls;
+        }
+        return calls;
+    }
+
+    TestDatabase(const TestDatabase&) = delete;
+    TestDatabase& operator=(const TestDatabase&) = delete;
+};